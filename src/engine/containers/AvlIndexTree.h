@@ -0,0 +1,831 @@
+#ifndef GLARE_AVL_INDEX_TREE_H
+#define GLARE_AVL_INDEX_TREE_H
+
+#include "GlareCoreUtility.h"
+#include "TreeStats.h"
+#include "memory\allocators.h"
+#include <cstdint>
+#include <cstdio>
+
+// AvlTree with all its nodes in one growable array, linked by 32-bit indices rather than pointers. A node of an <int, int> tree is
+// 16 bytes against 32 for AvlTreeNode, plus the heap's own overhead for each of those. The array is the whole tree, so a copy is a
+// copy of the array, a memcpy for plain data, and a snapshot is the array as it is.
+//
+//      AvlIndexTree<int, int> tree;
+//      tree.reserve(1 << 24);  // Optional, the array doubles as it fills.
+//      tree.insert(key, value);
+//
+// The array moves when it grows: a pointer from find() is good until the next insert(). Up to MAX_NODES nodes.
+
+namespace glare
+{
+    // A node of AvlIndexTree. The links are indices into the node array, 0 for none, and the balance factor + 1 sits in the two
+    // low bits of the right link.
+    template<typename keyType, typename ValueType>
+    struct AvlIndexNode
+    {
+        typedef std::uint32_t                           index_type;
+        typedef GLARE_PAIR<keyType, ValueType>          pair_type;
+
+        enum BalanceFactor
+        {
+            RightHigher = -1,
+            EqualHeight = 0,
+            LeftHigher  = 1
+        };
+
+        enum { BalanceBits = 2, BalanceMask = (1 << BalanceBits) - 1 };
+
+        AvlIndexNode(): m_left(0), m_rightBalance(EqualHeight + 1), m_pair() {}
+        explicit AvlIndexNode(const pair_type& _pair): m_left(0), m_rightBalance(EqualHeight + 1), m_pair(_pair) {}
+
+        const keyType& key() const { return m_pair.first; }
+        const ValueType& value() const { return m_pair.second; }
+        ValueType& value() { return m_pair.second; }
+
+        index_type left() const { return m_left; }
+        index_type right() const { return m_rightBalance >> BalanceBits; }
+        BalanceFactor balanceFactor() const { return static_cast<BalanceFactor>(static_cast<int>(m_rightBalance & BalanceMask) - 1); }
+
+        void setLeft(index_type _index) { m_left = _index; }
+        void setRight(index_type _index) { m_rightBalance = (_index << BalanceBits) | (m_rightBalance & BalanceMask); }
+        void setBalanceFactor(BalanceFactor _f) { m_rightBalance = (m_rightBalance & ~static_cast<index_type>(BalanceMask)) | (_f + 1); }
+
+        index_type  m_left;         // Also the next free slot once the node is freed.
+        index_type  m_rightBalance;
+        pair_type   m_pair;
+    };
+
+    template<typename _KeyType, typename _ValType, typename _Pred = less<_KeyType>, typename _Alloc = default_allocator<_ValType> >
+    class AvlIndexTree
+    {
+        typedef AvlIndexNode<_KeyType, _ValType>                node_type;
+        typedef typename _Alloc::template rebind<node_type>::other node_allocator_type;
+        typedef GLARE_VECTOR<node_type, node_allocator_type>    node_array;
+
+    public:
+        typedef typename node_type::index_type                  index_type;
+        typedef _KeyType                                        key_type;
+        typedef _ValType                                        value_type;
+        typedef _Pred                                           key_compare;
+        typedef value_type*                                     pointer;
+        typedef const value_type*                               const_pointer;
+        typedef value_type&                                     reference;
+        typedef const value_type&                               const_reference;
+        typedef std::size_t                                     size_type;
+        typedef typename node_type::pair_type                   pair_type;
+        typedef _Alloc                                          allocator_type;
+
+        // Leads a snapshot, the node array follows it as it is, slot 0 and the free slots included.
+        struct snapshot_header
+        {
+            unsigned int        m_magic;      // AVL_INDEX_SNAPSHOT_MAGIC, which doesn't match on a machine with the other byte order.
+            unsigned int        m_version;
+            unsigned int        m_nodeSize;   // sizeof(node_type), tells apart the key and value types.
+            unsigned int        m_root;
+            unsigned int        m_freeList;
+            unsigned int        m_reserved;
+            unsigned long long  m_slots;      // Nb of nodes in the array.
+            unsigned long long  m_size;
+        };
+
+        static const unsigned int AVL_INDEX_SNAPSHOT_MAGIC   = 0x49564147; // "GAVI"
+        static const unsigned int AVL_INDEX_SNAPSHOT_VERSION = 1;
+
+        // The right link gives two bits to the balance factor, and index 0 is the null link.
+        static const index_type MAX_NODES = (0xFFFFFFFFu >> node_type::BalanceBits) - 1;
+
+        //---------------------------------------------------------------------------
+
+        // The copy constructor and assignment are the compiler's: the node array is copied in one go.
+        AvlIndexTree();
+
+        // Post: Room for _count nodes without the array moving.
+        void reserve(size_type _count);
+
+        // Return false when the key is already there, or the tree holds MAX_NODES nodes.
+        bool insert(const pair_type& _pair);
+        bool insert(const key_type& _key, const_reference _value);
+
+        void remove(const key_type& _key);
+
+        bool find(const key_type& _key, value_type& _val) const;
+        pointer find(const key_type& _key);
+        const_pointer find(const key_type& _key) const;
+
+        // The array keeps its capacity.
+        void clear();
+
+        size_type size() const { return m_size; }
+        bool empty() const { return (m_size == 0); }
+
+        // m_bytes counts the whole array, the free slots and the room reserved included.
+        TreeStats stats() const;
+
+        // As for AvlTree, any callable taking (const key_type&, const_reference) and returning bool, false stops the walk.
+        template<typename _Func> bool for_each_inorder(_Func _func) const   { return visit_inorder(m_root, _func); }
+        template<typename _Func> bool for_each_preorder(_Func _func) const  { return visit_preorder(m_root, _func); }
+        template<typename _Func> bool for_each_postorder(_Func _func) const { return visit_postorder(m_root, _func); }
+
+        // Snapshot for the keys and values that are plain data: the header and the node array, written and read with a memcpy.
+        // Loading checks that the links make a tree of the size recorded, in O(n) and without comparing keys. loadSnapshot()
+        // replaces the content of the tree and returns false, leaving the tree as it is, when _buffer isn't a snapshot of this
+        // kind of tree.
+        size_type snapshotSize() const;
+        void writeSnapshot(void* _buffer) const;
+        bool loadSnapshot(const void* _buffer, size_type _bytes);
+
+        // The same through a file.
+        bool saveSnapshot(const char* _path) const;
+        bool loadSnapshot(const char* _path);
+
+    private:
+        // An AVL tree of MAX_NODES nodes is less than 44 high, as for AvlTree.
+        static const unsigned int AVL_MAX_HEIGHT = 96;
+
+        node_type& node(index_type _index) { return m_nodes[_index]; }
+        const node_type& node(index_type _index) const { return m_nodes[_index]; }
+
+        // Returns 0 when the tree is full. The array may move.
+        index_type allocate_node(const pair_type& _pair);
+        void free_node(index_type _index);
+
+        // Post: The link to _path[_depth], from _path[_depth - 1] or from the root, is _child.
+        void relink(const index_type* _path, const bool* _wentLeft, unsigned int _depth, index_type _child);
+
+        // Return the new root of the subtree, for the caller to link in.
+        index_type rotate_left(index_type _subRoot);
+        index_type rotate_right(index_type _subRoot);
+        index_type balance_left(index_type _subRoot);
+        index_type balance_right(index_type _subRoot);
+
+        index_type find_index(const key_type& _key) const;
+
+        template<typename _Func> bool visit_preorder (index_type _index, _Func& _func) const;
+        template<typename _Func> bool visit_postorder(index_type _index, _Func& _func) const;
+        template<typename _Func> bool visit_inorder  (index_type _index, _Func& _func) const;
+
+        // Post: True when the nodes reached from _root are _size, with valid links and balance factors that match the heights of
+        //       the subtrees, and the free list holds all the other slots.
+        static bool check_links(const node_array& _nodes, index_type _root, index_type _freeList, size_type _size);
+
+        // Post: True when the balance factor of every node under _index matches the heights of its subtrees, _height is then the
+        //       height of _index. Pre: the links below _index form a tree.
+        static bool check_heights(const node_array& _nodes, index_type _index, unsigned int _depth, int& _height);
+
+    private:
+        node_array   m_nodes;       // m_nodes[0] is never used, index 0 is the null link.
+        index_type   m_root;
+        index_type   m_freeList;    // The freed slots, chained through m_left.
+        size_type    m_size;
+        key_compare  m_binPredicate;
+    }; // AvlIndexTree
+
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::AvlIndexTree(): m_nodes(1)
+                                                                   , m_root(0)
+                                                                   , m_freeList(0)
+                                                                   , m_size(0)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    inline void AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::reserve(size_type _count)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        m_nodes.reserve(_count + 1);
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    inline void AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::clear()
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        m_nodes.resize(1);
+        m_root = 0;
+        m_freeList = 0;
+        m_size = 0;
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    TreeStats AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::stats() const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        TreeStats result;
+        GLARE_VECTOR<GLARE_PAIR<index_type, std::size_t> > pending;
+        if (m_root) {
+            pending.push_back(GLARE_PAIR<index_type, std::size_t>(m_root, 0));
+        }
+
+        result.m_fillHistogram.resize(3, 0);
+        while (!pending.empty())
+        {
+            const node_type& current = node(pending.back().first);
+            const std::size_t depth = pending.back().second;
+            pending.pop_back();
+
+            std::size_t children = 0;
+            if (current.left())  { ++children; pending.push_back(GLARE_PAIR<index_type, std::size_t>(current.left(), depth + 1)); }
+            if (current.right()) { ++children; pending.push_back(GLARE_PAIR<index_type, std::size_t>(current.right(), depth + 1)); }
+            result.addNode(depth, children);
+        }
+
+        result.m_size = m_size;
+        result.m_bytes = m_nodes.capacity() * sizeof(node_type);
+
+        GLARE_ASSERT(result.m_nodeCount == m_size, "[AVL] The size doesn't match the nb of nodes.");
+        return result;
+    }
+
+    //--------------------------------------------------------------------------------------------------------------
+    // NODE ARRAY
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::index_type
+    AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::allocate_node(const pair_type& _pair)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        if (m_freeList)
+        {
+            const index_type index = m_freeList;
+            m_freeList = node(index).m_left;
+            node(index) = node_type(_pair);
+            return index;
+        }
+        if (m_nodes.size() > MAX_NODES) {
+            return 0;
+        }
+        m_nodes.push_back(node_type(_pair));
+        return static_cast<index_type>(m_nodes.size() - 1);
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    inline void AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::free_node(index_type _index)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        node_type& freed = node(_index);
+        freed = node_type(); // Lets go of what the key and value hold.
+        freed.m_left = m_freeList;
+        m_freeList = _index;
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    inline void AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::relink(const index_type* _path, const bool* _wentLeft, unsigned int _depth, index_type _child)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        if (_depth == 0) {
+            m_root = _child;
+        }
+        else if (_wentLeft[_depth - 1]) {
+            node(_path[_depth - 1]).setLeft(_child);
+        }
+        else {
+            node(_path[_depth - 1]).setRight(_child);
+        }
+    }
+
+    //--------------------------------------------------------------------------------------------------------------
+    // ROTATIONS AND BALANCING, as in AvlTree with the links as indices.
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    inline typename AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::index_type
+    AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::rotate_left(index_type _subRoot)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        GLARE_ASSERT(_subRoot && node(_subRoot).right(), "[AVL][Logic Fail] This impossible situation shouldn't have arised.");
+
+        const index_type rightTree = node(_subRoot).right();
+        node(_subRoot).setRight(node(rightTree).left());
+        node(rightTree).setLeft(_subRoot);
+        return rightTree;
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    inline typename AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::index_type
+    AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::rotate_right(index_type _subRoot)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        GLARE_ASSERT(_subRoot && node(_subRoot).left(), "[AVL][Logic Fail] This impossible situation shouldn't have arised.");
+
+        const index_type leftTree = node(_subRoot).left();
+        node(_subRoot).setLeft(node(leftTree).right());
+        node(leftTree).setRight(_subRoot);
+        return leftTree;
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    // Pre: _subRoot is doubly unbalanced on the right.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::index_type
+    AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::balance_right(index_type _subRoot)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        node_type& subRoot = node(_subRoot);
+        const index_type rightIndex = subRoot.right();
+        node_type& rightSubRoot = node(rightIndex);
+
+        switch (rightSubRoot.balanceFactor())
+        {
+        case node_type::EqualHeight: // Only after a deletion.
+            subRoot.setBalanceFactor(node_type::RightHigher);
+            rightSubRoot.setBalanceFactor(node_type::LeftHigher);
+            break;
+        case node_type::RightHigher:
+            subRoot.setBalanceFactor(node_type::EqualHeight);
+            rightSubRoot.setBalanceFactor(node_type::EqualHeight);
+            break;
+        case node_type::LeftHigher: // RL double rotation.
+            {
+                node_type& leftSubTree = node(rightSubRoot.left());
+                switch (leftSubTree.balanceFactor())
+                {
+                case node_type::EqualHeight:
+                    subRoot.setBalanceFactor(node_type::EqualHeight);
+                    rightSubRoot.setBalanceFactor(node_type::EqualHeight);
+                    break;
+                case node_type::RightHigher:
+                    subRoot.setBalanceFactor(node_type::LeftHigher);
+                    rightSubRoot.setBalanceFactor(node_type::EqualHeight);
+                    break;
+                case node_type::LeftHigher:
+                    subRoot.setBalanceFactor(node_type::EqualHeight);
+                    rightSubRoot.setBalanceFactor(node_type::RightHigher);
+                    break;
+                }
+                leftSubTree.setBalanceFactor(node_type::EqualHeight);
+                subRoot.setRight(rotate_right(rightIndex));
+                break;
+            }
+        }
+        return rotate_left(_subRoot);
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    // Pre: _subRoot is doubly unbalanced on the left.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::index_type
+    AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::balance_left(index_type _subRoot)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        node_type& subRoot = node(_subRoot);
+        const index_type leftIndex = subRoot.left();
+        node_type& leftSubRoot = node(leftIndex);
+
+        switch (leftSubRoot.balanceFactor())
+        {
+        case node_type::EqualHeight: // Only after a deletion.
+            subRoot.setBalanceFactor(node_type::LeftHigher);
+            leftSubRoot.setBalanceFactor(node_type::RightHigher);
+            break;
+        case node_type::LeftHigher:
+            subRoot.setBalanceFactor(node_type::EqualHeight);
+            leftSubRoot.setBalanceFactor(node_type::EqualHeight);
+            break;
+        case node_type::RightHigher: // LR double rotation.
+            {
+                node_type& rightSubTree = node(leftSubRoot.right());
+                switch (rightSubTree.balanceFactor())
+                {
+                case node_type::LeftHigher:
+                    subRoot.setBalanceFactor(node_type::RightHigher);
+                    leftSubRoot.setBalanceFactor(node_type::EqualHeight);
+                    break;
+                case node_type::RightHigher:
+                    subRoot.setBalanceFactor(node_type::EqualHeight);
+                    leftSubRoot.setBalanceFactor(node_type::LeftHigher);
+                    break;
+                case node_type::EqualHeight:
+                    subRoot.setBalanceFactor(node_type::EqualHeight);
+                    leftSubRoot.setBalanceFactor(node_type::EqualHeight);
+                    break;
+                }
+                rightSubTree.setBalanceFactor(node_type::EqualHeight);
+                subRoot.setLeft(rotate_left(leftIndex));
+                break;
+            }
+        }
+        return rotate_right(_subRoot);
+    }
+    //--------------------------------------------------------------------------------------------------------------
+
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    inline bool AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::insert(const key_type& _key, const_reference _value)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        return insert(pair_type(_key, _value));
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    // The iterative insert of AvlTree, the path is kept as indices since the array may move when the node is added.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    bool AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::insert(const pair_type& _pair)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        index_type path[AVL_MAX_HEIGHT];
+        bool wentLeft[AVL_MAX_HEIGHT];
+        unsigned int depth = 0;
+
+        for (index_type current = m_root; current != 0; ++depth)
+        {
+            const node_type& currentNode = node(current);
+            if (currentNode.key() == _pair.first) {
+                return false; // Duplicate key not allowed.
+            }
+            path[depth] = current;
+            wentLeft[depth] = m_binPredicate(_pair.first, currentNode.key());
+            current = wentLeft[depth] ? currentNode.left() : currentNode.right();
+        }
+
+        const index_type added = allocate_node(_pair);
+        if (added == 0) {
+            return false;
+        }
+        relink(path, wentLeft, depth, added);
+        ++m_size;
+
+        while (depth > 0)
+        {
+            node_type& parent = node(path[--depth]);
+            if (wentLeft[depth])
+            {
+                switch (parent.balanceFactor())
+                {
+                case node_type::LeftHigher:
+                    relink(path, wentLeft, depth, balance_left(path[depth]));
+                    return true;
+                case node_type::EqualHeight:
+                    parent.setBalanceFactor(node_type::LeftHigher);
+                    break;
+                case node_type::RightHigher:
+                    parent.setBalanceFactor(node_type::EqualHeight);
+                    return true;
+                }
+            }
+            else
+            {
+                switch (parent.balanceFactor())
+                {
+                case node_type::LeftHigher:
+                    parent.setBalanceFactor(node_type::EqualHeight);
+                    return true;
+                case node_type::EqualHeight:
+                    parent.setBalanceFactor(node_type::RightHigher);
+                    break;
+                case node_type::RightHigher:
+                    relink(path, wentLeft, depth, balance_right(path[depth]));
+                    return true;
+                }
+            }
+        }
+        return true;
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    void AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::remove(const key_type& _key)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        index_type path[AVL_MAX_HEIGHT];
+        bool wentLeft[AVL_MAX_HEIGHT];
+        unsigned int depth = 0;
+
+        index_type target = m_root;
+        while (target != 0 && !(_key == node(target).key()))
+        {
+            path[depth] = target;
+            wentLeft[depth] = m_binPredicate(_key, node(target).key());
+            target = wentLeft[depth] ? node(target).left() : node(target).right();
+            ++depth;
+        }
+        if (target == 0) {
+            return; // Not Found!
+        }
+
+        // A node with two children takes the data of its predecessor, which is removed instead.
+        index_type victim = target;
+        if (node(target).left() != 0 && node(target).right() != 0)
+        {
+            path[depth] = target;
+            wentLeft[depth++] = true;
+            for (victim = node(target).left(); node(victim).right() != 0; victim = node(victim).right())
+            {
+                path[depth] = victim;
+                wentLeft[depth++] = false;
+            }
+            node(target).m_pair = node(victim).m_pair;
+        }
+
+        // One child at most, it keeps its balance factor.
+        relink(path, wentLeft, depth, node(victim).left() ? node(victim).left() : node(victim).right());
+        free_node(victim);
+        --m_size;
+
+        while (depth > 0)
+        {
+            node_type& parent = node(path[--depth]);
+            if (wentLeft[depth])
+            {
+                switch (parent.balanceFactor())
+                {
+                case node_type::LeftHigher:
+                    parent.setBalanceFactor(node_type::EqualHeight);
+                    break;
+                case node_type::EqualHeight:
+                    parent.setBalanceFactor(node_type::RightHigher);
+                    return;
+                case node_type::RightHigher:
+                    {
+                        const bool shorter = node(parent.right()).balanceFactor() != node_type::EqualHeight;
+                        relink(path, wentLeft, depth, balance_right(path[depth]));
+                        if (!shorter) {
+                            return;
+                        }
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                switch (parent.balanceFactor())
+                {
+                case node_type::LeftHigher:
+                    {
+                        const bool shorter = node(parent.left()).balanceFactor() != node_type::EqualHeight;
+                        relink(path, wentLeft, depth, balance_left(path[depth]));
+                        if (!shorter) {
+                            return;
+                        }
+                        break;
+                    }
+                case node_type::EqualHeight:
+                    parent.setBalanceFactor(node_type::LeftHigher);
+                    return;
+                case node_type::RightHigher:
+                    parent.setBalanceFactor(node_type::EqualHeight);
+                    break;
+                }
+            }
+        }
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::index_type
+    AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::find_index(const key_type& _key) const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        // The hardware prefetchers follow pointers found in a cache line but not indices, so both children are prefetched
+        // before the comparison. Slot 0 makes the null child harmless.
+        index_type current = m_root;
+        while (current != 0)
+        {
+            const node_type& currentNode = node(current);
+            const index_type left = currentNode.left();
+            const index_type right = currentNode.right();
+            GLARE_PREFETCH(&m_nodes[left]);
+            GLARE_PREFETCH(&m_nodes[right]);
+            if (_key == currentNode.key())
+            {
+                break;
+            }
+            current = m_binPredicate(_key, currentNode.key()) ? left : right;
+        }
+        return current;
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    inline bool AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::find(const key_type& _key, value_type& _val) const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        if (const index_type found = find_index(_key))
+        {
+            _val = node(found).value();
+            return true;
+        }
+        return false;
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    inline typename AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::pointer
+    AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::find(const key_type& _key)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        const index_type found = find_index(_key);
+        return found ? &node(found).value() : nullptr;
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    inline typename AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::const_pointer
+    AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::find(const key_type& _key) const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        const index_type found = find_index(_key);
+        return found ? &node(found).value() : nullptr;
+    }
+
+    //--------------------------------------------------------------------------------------------------------------
+    // TRAVERSAL
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    template<typename _Func>
+    bool AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::visit_inorder(index_type _index, _Func& _func) const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        if (_index == 0) {
+            return true;
+        }
+        const node_type& current = node(_index);
+        return visit_inorder(current.left(), _func) && _func(current.key(), current.value()) && visit_inorder(current.right(), _func);
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    template<typename _Func>
+    bool AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::visit_preorder(index_type _index, _Func& _func) const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        if (_index == 0) {
+            return true;
+        }
+        const node_type& current = node(_index);
+        return _func(current.key(), current.value()) && visit_preorder(current.left(), _func) && visit_preorder(current.right(), _func);
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    template<typename _Func>
+    bool AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::visit_postorder(index_type _index, _Func& _func) const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        if (_index == 0) {
+            return true;
+        }
+        const node_type& current = node(_index);
+        return visit_postorder(current.left(), _func) && visit_postorder(current.right(), _func) && _func(current.key(), current.value());
+    }
+
+    //--------------------------------------------------------------------------------------------------------------
+    // SNAPSHOT
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    inline typename AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::size_type
+    AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::snapshotSize() const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        return sizeof(snapshot_header) + m_nodes.size() * sizeof(node_type);
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    void AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::writeSnapshot(void* _buffer) const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        static_assert(GLARE_IS_POD(key_type) && GLARE_IS_POD(value_type), "A snapshot copies the keys and values as they are");
+
+        snapshot_header header;
+        GLARE_MEMSET(&header, 0, sizeof(header));
+        header.m_magic = AVL_INDEX_SNAPSHOT_MAGIC;
+        header.m_version = AVL_INDEX_SNAPSHOT_VERSION;
+        header.m_nodeSize = sizeof(node_type);
+        header.m_root = m_root;
+        header.m_freeList = m_freeList;
+        header.m_slots = m_nodes.size();
+        header.m_size = m_size;
+
+        GLARE_MEMCPY(_buffer, &header, sizeof(header));
+        GLARE_MEMCPY(static_cast<unsigned char*>(_buffer) + sizeof(header), &m_nodes[0], m_nodes.size() * sizeof(node_type));
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    bool AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::loadSnapshot(const void* _buffer, size_type _bytes)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        static_assert(GLARE_IS_POD(key_type) && GLARE_IS_POD(value_type), "A snapshot copies the keys and values as they are");
+
+        snapshot_header header;
+        if (_buffer == nullptr || _bytes < sizeof(header)) {
+            return false;
+        }
+        GLARE_MEMCPY(&header, _buffer, sizeof(header));
+        if (header.m_magic != AVL_INDEX_SNAPSHOT_MAGIC || header.m_version != AVL_INDEX_SNAPSHOT_VERSION || header.m_nodeSize != sizeof(node_type)
+            || header.m_slots == 0 || header.m_slots > static_cast<unsigned long long>(MAX_NODES) + 1
+            || header.m_slots > (_bytes - sizeof(header)) / sizeof(node_type)
+            || header.m_root >= header.m_slots || header.m_freeList >= header.m_slots || header.m_size >= header.m_slots) {
+            return false;
+        }
+
+        node_array nodes(static_cast<size_type>(header.m_slots));
+        GLARE_MEMCPY(&nodes[0], static_cast<const unsigned char*>(_buffer) + sizeof(header), nodes.size() * sizeof(node_type));
+        if (!check_links(nodes, header.m_root, header.m_freeList, static_cast<size_type>(header.m_size))) {
+            return false;
+        }
+
+        m_nodes.swap(nodes);
+        m_root = header.m_root;
+        m_freeList = header.m_freeList;
+        m_size = static_cast<size_type>(header.m_size);
+        return true;
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    // Every slot but 0 must be reached exactly once, from the root or down the free list.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    bool AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::check_links(const node_array& _nodes, index_type _root, index_type _freeList, size_type _size)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        const size_type slots = _nodes.size();
+        GLARE_VECTOR<bool> reached(slots, false);
+        reached[0] = true;
+
+        index_type pending[AVL_MAX_HEIGHT];
+        unsigned int depth = 0;
+        size_type count = 0;
+
+        for (index_type current = _root; current != 0; ++count)
+        {
+            const node_type& currentNode = _nodes[current];
+            if (reached[current] || currentNode.left() >= slots || currentNode.right() >= slots
+                || (currentNode.m_rightBalance & node_type::BalanceMask) > 2) {
+                return false;
+            }
+            reached[current] = true;
+
+            if (currentNode.right())
+            {
+                if (depth == AVL_MAX_HEIGHT) {
+                    return false;
+                }
+                pending[depth++] = currentNode.right();
+            }
+            current = currentNode.left() ? currentNode.left() : (depth ? pending[--depth] : 0);
+        }
+        int height = 0;
+        if (count != _size || !check_heights(_nodes, _root, 0, height)) {
+            return false;
+        }
+
+        for (index_type current = _freeList; current != 0; current = _nodes[current].m_left, ++count)
+        {
+            if (reached[current] || _nodes[current].m_left >= slots) {
+                return false;
+            }
+            reached[current] = true;
+        }
+        return (count == slots - 1);
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    bool AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::check_heights(const node_array& _nodes, index_type _index, unsigned int _depth, int& _height)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        if (_index == 0)
+        {
+            _height = 0;
+            return true;
+        }
+        if (_depth == AVL_MAX_HEIGHT) { // Deeper than any balanced tree of MAX_NODES, a long chain is rejected before the stack runs out.
+            return false;
+        }
+
+        const node_type& currentNode = _nodes[_index];
+        int leftHeight = 0;
+        int rightHeight = 0;
+        if (!check_heights(_nodes, currentNode.left(), _depth + 1, leftHeight) || !check_heights(_nodes, currentNode.right(), _depth + 1, rightHeight)) {
+            return false;
+        }
+        _height = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+        return (leftHeight - rightHeight == currentNode.balanceFactor());
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    bool AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::saveSnapshot(const char* _path) const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        GLARE_VECTOR<unsigned char> buffer(snapshotSize());
+        writeSnapshot(&buffer[0]);
+
+        std::FILE* file = std::fopen(_path, "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        const bool written = std::fwrite(&buffer[0], 1, buffer.size(), file) == buffer.size();
+        return (std::fclose(file) == 0) && written;
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    bool AvlIndexTree<_KeyType, _ValType, _Pred, _Alloc>::loadSnapshot(const char* _path)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        std::FILE* file = std::fopen(_path, "rb");
+        if (file == nullptr) {
+            return false;
+        }
+
+        GLARE_VECTOR<unsigned char> buffer;
+        unsigned char chunk[GLARE_PAGE_SIZE];
+        for (std::size_t bytes; (bytes = std::fread(chunk, 1, sizeof(chunk), file)) > 0; ) {
+            buffer.insert(buffer.end(), chunk, chunk + bytes);
+        }
+        const bool read = std::ferror(file) == 0;
+        std::fclose(file);
+
+        return read && !buffer.empty() && loadSnapshot(&buffer[0], buffer.size());
+    }
+    //--------------------------------------------------------------------------------------------------------------
+
+} // namespace glare
+
+#endif // GLARE_AVL_INDEX_TREE_H
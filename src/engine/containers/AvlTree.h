@@ -2,7 +2,12 @@
 #define GLARE_AVL_TREE_H
 
 #include "GlareCoreUtility.h"
+#include "TreeStats.h"
+#include "MorrisTraversal.h"
 #include "memory\allocators.h"
+#include "threading\Reclaimer.h"
+#include "threading\ThreadPool.h"
+#include <cstdio>
 
 
 // TODO An optimization that will choose predecessor or successor based on the balance of the node to be deleted.
@@ -41,6 +46,23 @@ namespace glare
         typedef SerializableType                              serializable_type;
         typedef GLARE_VECTOR<serializable_type>               serializable_list;
 
+        // A node of a binary snapshot, see AvlTree::writeSnapshot. Plain data, written and read as it is.
+        struct SnapshotRecord
+        {
+            enum Flags
+            {
+                BalanceMask = 3, // The balance factor + 1.
+                HasLeft     = 4,
+                HasRight    = 8
+            };
+
+            keyType       m_key;
+            ValueType     m_value;
+            unsigned char m_flags;
+        };
+
+        typedef SnapshotRecord                                snapshot_record;
+
         explicit AvlTreeNode(const pair_type& _pairRef): m_left(nullptr)
                                               , m_right(nullptr)
                                               , m_pair(_pairRef)
@@ -60,6 +82,12 @@ namespace glare
                                                   , m_balanceFactor(_obj.m_balanceFactor)
         {}
 
+        explicit AvlTreeNode(const snapshot_record& _record): m_left(nullptr)
+                                                   , m_right(nullptr)
+                                                   , m_pair(_record.m_key, _record.m_value)
+                                                   , m_balanceFactor(static_cast<BalanceFactor>((_record.m_flags & snapshot_record::BalanceMask) - 1))
+        {}
+
         node_type& operator = (const node_type& _other)
         {
             if(&_other != this)
@@ -79,6 +107,9 @@ namespace glare
         void setBalanceFactor(BalanceFactor _f) { m_balanceFactor = _f; }
         void copyDataOnly(const node_type& _other) { m_pair = _other.m_pair; }
 
+        node_pointer left() const { return m_left; }
+        node_pointer right() const { return m_right; }
+
     public:
         node_pointer  m_left;
         node_pointer  m_right;
@@ -117,6 +148,21 @@ namespace glare
 
         typedef typename node_type::serializable_list           serializable_list;
         typedef typename node_type::serializable_type           serializable_type;
+        typedef typename node_type::snapshot_record             snapshot_record;
+
+        // Leads a binary snapshot, the records follow it in pre-order.
+        struct snapshot_header
+        {
+            unsigned int        m_magic;      // AVL_SNAPSHOT_MAGIC, which doesn't match on a machine with the other byte order.
+            unsigned int        m_version;
+            unsigned int        m_recordSize; // sizeof(snapshot_record), tells apart the key and value types.
+            unsigned int        m_reserved;
+            unsigned long long  m_count;
+            unsigned long long  m_reserved2;  // The records start 32 bytes in, aligned like the mapping.
+        };
+
+        static const unsigned int AVL_SNAPSHOT_MAGIC   = 0x4c564147; // "GAVL"
+        static const unsigned int AVL_SNAPSHOT_VERSION = 1;
 
         typedef void (*process_data_cb)(const key_type& _key, const_reference _data);
 
@@ -127,12 +173,21 @@ namespace glare
 
         AvlTree(const AvlTree&);
         AvlTree& operator = (const AvlTree&);
+
+        // Deep copy with the subtrees of the top levels copied in parallel on _pool, the node allocator is then called from the pool
+        // threads. Sequential without a pool.
+        AvlTree(const AvlTree& _avl, ThreadPool* _pool);
     
         bool insert(const pair_type& _pair);
         bool insert(const key_type& _key, const_reference _value);
 
         void remove(const key_type& _key);
 
+        // The recursive updates insert() and remove() replaced, they leave the same tree. Kept as the reference for the tests and
+        // bench_avl.cpp.
+        bool insert_recursive(const pair_type& _pair);
+        void remove_recursive(const key_type& _key);
+
         bool find(const key_type& _key, value_type& _val) const;
         pointer find(const key_type& _key);
         const_pointer find(const key_type& _key) const;
@@ -141,14 +196,71 @@ namespace glare
 
         size_t size() { return m_size; }
 
+        // Single pass over the nodes, the depth histogram shows how far the tree is from perfectly balanced.
+        TreeStats stats() const;
+
         void traverse(process_data_cb _cb);
         void setPreOrderTraversal()  { m_traversalFunc = preorder; }
         void setPostOrderTraversal() { m_traversalFunc = postorder; }
         void setInOrderTraversal()   { m_traversalFunc = inorder; }
 
+        // Walks in the three orders with any callable taking (const key_type&, const_reference) and returning bool, false stops the
+        // walk. Return false when the visitor stopped it. The visitor is called directly rather than through a function pointer, so
+        // it inlines into the loop and may carry state, a lambda capturing an accumulator by reference for one.
+        template<typename _Func> bool for_each_inorder(_Func _func) const;
+        template<typename _Func> bool for_each_preorder(_Func _func) const;
+        template<typename _Func> bool for_each_postorder(_Func _func) const;
+
+        // The in order walk in O(1) extra space, through threads on the free right links (MorrisTraversal.h). The links are borrowed
+        // until it returns: no update and no other reader meanwhile. The visitor is as for for_each_inorder().
+        template<typename _Func> bool morris_for_each_inorder(_Func _func);
+
+        // In order iterator on the same walk, the tree as above until it is done or destroyed.
+        //      for (AvlTree<int, int>::morris_iterator itr(tree); itr.valid(); ++itr) { use(itr.key(), itr.value()); }
+        class morris_iterator
+        {
+        public:
+            explicit morris_iterator(AvlTree& _tree): m_walk(_tree.m_root) {}
+
+            bool valid() const { return !m_walk.done(); }
+
+            // Pre: valid().
+            const key_type& key() const { return m_walk.node()->key(); }
+            reference value() const { return m_walk.node()->value(); }
+            morris_iterator& operator ++ () { m_walk.advance(); return *this; }
+
+            // Gives the links back before the end, the iterator is then no longer valid().
+            void stop() { m_walk.finish(); }
+
+        private:
+            morris_inorder_walk<node_pointer> m_walk;
+        };
+
         void serializeList(serializable_list& _list, bool _read);
 
+        // Binary snapshot for the keys and values that are plain data: a header and the nodes in pre-order, each with its balance
+        // factor and which children it has. Loading links the nodes back in the same shape in O(n), no comparisons and no rotations,
+        // the snapshot must then come from a tree with the same order. snapshotSize() is the nb of bytes writeSnapshot() writes to
+        // _buffer, which may be a file mapping. loadSnapshot() replaces the content of the tree and returns false, leaving the tree as
+        // it is, when _buffer isn't a snapshot of this kind of tree.
+        size_type snapshotSize() const;
+        void writeSnapshot(void* _buffer) const;
+        bool loadSnapshot(const void* _buffer, size_type _bytes);
+
+        // The same through a file.
+        bool saveSnapshot(const char* _path) const;
+        bool loadSnapshot(const char* _path);
+
+        // Freeing on a background thread, off (nullptr) by default: clear() and the destructor detach the nodes and hand them to
+        // _reclaimer, so they return in O(1). Not copied with the tree. With an allocator that frees in bulk and nodes without a
+        // destructor, the nodes are simply dropped.
+        void setReclaimer(Reclaimer* _reclaimer) { m_reclaimer = _reclaimer; }
+        Reclaimer* reclaimer() const { return m_reclaimer; }
+
     private:
+        // An AVL tree of n nodes is less than 1.45 lg(n+2) high, the paths of insert() and remove() fit for any size_type.
+        static const unsigned int AVL_MAX_HEIGHT = 96;
+
         void rotate_left(node_pointer& _subRoot);
         void rotate_right(node_pointer& _subRoot);
         void balance_left(node_pointer& _subRoot);
@@ -163,10 +275,19 @@ namespace glare
         static void postorder(node_pointer _node, process_data_cb _funcCb);
         static void inorder  (node_pointer _node, process_data_cb _funcCb);
 
-        void internal_clean(node_pointer _subRoot);
+        template<typename _Func> static bool visit_preorder (const_node_pointer _node, _Func& _func);
+        template<typename _Func> static bool visit_postorder(const_node_pointer _node, _Func& _func);
+        template<typename _Func> static bool visit_inorder  (const_node_pointer _node, _Func& _func);
+
+        static void internal_clean(node_allocator_type& _allocator, node_pointer _subRoot);
 
-        void copy(node_pointer& _copyRoot, const_node_pointer _originalRoot);
-        void copyTree(const AvlTree& _originalRoot);
+        // Post: True when the balance factor of every node under _node matches the heights of its subtrees, _height is then the
+        //       height of _node. As deep as the tree, loadSnapshot() keeps it under AVL_MAX_HEIGHT before calling it.
+        static bool check_heights(const_node_pointer _node, int& _height);
+
+        // The two subtrees are copied in parallel for _forkDepth levels. The size is up to the caller.
+        void copy(node_pointer& _copyRoot, const_node_pointer _originalRoot, ThreadPool* _pool = nullptr, unsigned int _forkDepth = 0);
+        void copyTree(const AvlTree& _originalRoot, ThreadPool* _pool = nullptr);
 
         // Tree Serialization
         void avl_serialize_insert(node_pointer& _node, serializable_type& _proxy);
@@ -182,6 +303,7 @@ namespace glare
         key_compare  m_binPredicate;
         void (*m_traversalFunc)(node_pointer _node, process_data_cb _funcCb);
         node_allocator_type m_nodeAllocator;
+        Reclaimer*   m_reclaimer;
     }; // avlTree
 
     //--------------------------------------------------------------------------------------------------------------
@@ -189,6 +311,7 @@ namespace glare
     AvlTree<_KeyType, _ValType, _Pred, _Alloc>::AvlTree(): m_size(0)
                                                          , m_root(nullptr) 
                                                          , m_traversalFunc(preorder)
+                                                         , m_reclaimer(nullptr)
     {}
 
     template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
@@ -202,10 +325,21 @@ namespace glare
                                                                             , m_root(nullptr)
                                                                             , m_binPredicate(_avl.m_binPredicate)
                                                                             , m_traversalFunc(_avl.m_traversalFunc)
+                                                                            , m_reclaimer(nullptr)
     {
         copyTree(_avl);
     }
 
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    AvlTree<_KeyType, _ValType, _Pred, _Alloc>::AvlTree(const AvlTree& _avl, ThreadPool* _pool): m_size(0)
+                                                                                               , m_root(nullptr)
+                                                                                               , m_binPredicate(_avl.m_binPredicate)
+                                                                                               , m_traversalFunc(_avl.m_traversalFunc)
+                                                                                               , m_reclaimer(nullptr)
+    {
+        copyTree(_avl, _pool);
+    }
+
     template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
     AvlTree<_KeyType, _ValType, _Pred, _Alloc>& 
     AvlTree<_KeyType, _ValType, _Pred, _Alloc>::operator = (const AvlTree& _avl)
@@ -217,6 +351,20 @@ namespace glare
         }
         return *this;
     }
+
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    TreeStats AvlTree<_KeyType, _ValType, _Pred, _Alloc>::stats() const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        TreeStats result;
+        binary_tree_stats(static_cast<const_node_pointer>(m_root), result);
+        result.m_size = m_size;
+        result.m_bytes = result.m_nodeCount * sizeof(node_type);
+
+        GLARE_ASSERT(result.m_nodeCount == m_size, "[AVL] The size doesn't match the nb of nodes.");
+        return result;
+    }
     //--------------------------------------------------------------------------------------------------------------
 
     
@@ -387,8 +535,74 @@ namespace glare
     }
 
     //--------------------------------------------------------------------------------------------------------------
+    // Walks down keeping the links it takes, then back up while the subtrees get taller. It stops at the first node whose height
+    // doesn't change, which is at most one rotation.
     template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    inline bool AvlTree<_KeyType, _ValType, _Pred, _Alloc>::insert(const pair_type& _pair)
+    bool AvlTree<_KeyType, _ValType, _Pred, _Alloc>::insert(const pair_type& _pair)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        node_pointer* path[AVL_MAX_HEIGHT];
+        unsigned int depth = 0;
+
+        node_pointer* link = &m_root;
+        while (node_pointer current = *link)
+        {
+            if (current->key() == _pair.first) {
+                return false; // Duplicate key not allowed.
+            }
+            path[depth++] = link;
+            link = m_binPredicate(_pair.first, current->key()) ? &current->m_left : &current->m_right;
+        }
+
+        node_pointer nodePtr = m_nodeAllocator.allocate(1);
+        if (nodePtr == nullptr) {
+            return false;
+        }
+        m_nodeAllocator.construct(nodePtr, _pair);
+        *link = nodePtr;
+        ++m_size;
+
+        for (node_pointer child = nodePtr; depth > 0; child = *path[depth])
+        {
+            node_pointer* parentLink = path[--depth];
+            node_pointer parent = *parentLink;
+            if (parent->m_left == child)
+            {
+                switch (parent->balanceFactor())
+                {
+                case node_type::LeftHigher:
+                    balance_left(*parentLink);
+                    return true;
+                case node_type::EqualHeight:
+                    parent->setBalanceFactor(node_type::LeftHigher);
+                    break;
+                case node_type::RightHigher:
+                    parent->setBalanceFactor(node_type::EqualHeight);
+                    return true;
+                }
+            }
+            else
+            {
+                switch (parent->balanceFactor())
+                {
+                case node_type::LeftHigher:
+                    parent->setBalanceFactor(node_type::EqualHeight);
+                    return true;
+                case node_type::EqualHeight:
+                    parent->setBalanceFactor(node_type::RightHigher);
+                    break;
+                case node_type::RightHigher:
+                    balance_right(*parentLink);
+                    return true;
+                }
+            }
+        }
+        return true;
+    }
+
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    inline bool AvlTree<_KeyType, _ValType, _Pred, _Alloc>::insert_recursive(const pair_type& _pair)
     //--------------------------------------------------------------------------------------------------------------
     {
         bool taller = false;
@@ -480,9 +694,95 @@ namespace glare
     //--------------------------------------------------------------------------------------------------------------
 
     //--------------------------------------------------------------------------------------------------------------
+    // Same walk as insert(). A node with two children takes the data of its predecessor, which is removed instead, as in
+    // avl_delete(). Back up, the rebalancing stops at the first node whose height doesn't change.
     template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
     void AvlTree<_KeyType, _ValType, _Pred, _Alloc>::remove(const key_type& _key)
     //--------------------------------------------------------------------------------------------------------------
+    {
+        node_pointer* path[AVL_MAX_HEIGHT];
+        unsigned int depth = 0;
+
+        node_pointer* link = &m_root;
+        while (*link != nullptr && !(_key == (*link)->key()))
+        {
+            path[depth++] = link;
+            link = m_binPredicate(_key, (*link)->key()) ? &(*link)->m_left : &(*link)->m_right;
+        }
+
+        node_pointer nodePtr = *link;
+        if (nodePtr == nullptr) {
+            return; // Not Found!
+        }
+
+        if (nodePtr->m_left != nullptr && nodePtr->m_right != nullptr)
+        {
+            path[depth++] = link;
+            link = &nodePtr->m_left;
+            while ((*link)->m_right != nullptr)
+            {
+                path[depth++] = link;
+                link = &(*link)->m_right;
+            }
+            nodePtr->copyDataOnly(**link); // We copy only key/value data.
+        }
+
+        // One child at most, it keeps its balance factor.
+        delete_node(*link);
+
+        for (node_pointer* childLink = link; depth > 0; childLink = path[depth])
+        {
+            node_pointer* parentLink = path[--depth];
+            node_pointer parent = *parentLink;
+            if (childLink == &parent->m_left)
+            {
+                switch (parent->balanceFactor())
+                {
+                case node_type::LeftHigher:
+                    parent->setBalanceFactor(node_type::EqualHeight); // Height of parent decreased!
+                    break;
+                case node_type::EqualHeight:
+                    parent->setBalanceFactor(node_type::RightHigher);
+                    return; // Height of parent didn't change at all.
+                case node_type::RightHigher:
+                    {
+                        // The height stays after the rotation when the right subtree is EqualHeight.
+                        const bool shorter = parent->m_right->balanceFactor() != node_type::EqualHeight;
+                        balance_right(*parentLink);
+                        if (!shorter) {
+                            return;
+                        }
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                switch (parent->balanceFactor())
+                {
+                case node_type::LeftHigher:
+                    {
+                        const bool shorter = parent->m_left->balanceFactor() != node_type::EqualHeight;
+                        balance_left(*parentLink);
+                        if (!shorter) {
+                            return;
+                        }
+                        break;
+                    }
+                case node_type::EqualHeight:
+                    parent->setBalanceFactor(node_type::LeftHigher);
+                    return;
+                case node_type::RightHigher:
+                    parent->setBalanceFactor(node_type::EqualHeight);
+                    break;
+                }
+            }
+        }
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    inline void AvlTree<_KeyType, _ValType, _Pred, _Alloc>::remove_recursive(const key_type& _key)
+    //--------------------------------------------------------------------------------------------------------------
     {
         bool shorter = false;
         avl_delete(_key, m_root, shorter);
@@ -682,14 +982,16 @@ namespace glare
     typename AvlTree<_KeyType, _ValType, _Pred, _Alloc>::pointer 
     AvlTree<_KeyType, _ValType, _Pred, _Alloc>::find(const key_type& _key)
     {
-        return &(avl_find(_key, m_root)->value());
+        node_pointer nodePtr = avl_find(_key, m_root);
+        return nodePtr ? &(nodePtr->value()) : nullptr;
     }
     //--------------------------------------------------------------------------------------------------------------
     template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
     typename AvlTree<_KeyType, _ValType, _Pred, _Alloc>::const_pointer 
     AvlTree<_KeyType, _ValType, _Pred, _Alloc>::find(const key_type& _key) const
     {
-        return &(avl_find(_key, m_root)->value());
+        node_pointer nodePtr = avl_find(_key, m_root);
+        return nodePtr ? &(nodePtr->value()) : nullptr;
     }
     //--------------------------------------------------------------------------------------------------------------
     template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
@@ -697,7 +999,7 @@ namespace glare
     AvlTree<_KeyType, _ValType, _Pred, _Alloc>::avl_find(const key_type& _key, const node_pointer& _subRoot) const
     //--------------------------------------------------------------------------------------------------------------
     {
-        const node_pointer nodePtr = _subRoot;
+        node_pointer nodePtr = _subRoot;
         while(nodePtr)
         {
             if (_key == nodePtr->key())
@@ -724,38 +1026,52 @@ namespace glare
     {
         if(m_root) 
         { 
-            internal_clean(m_root);
+            if (allocator_frees_in_bulk<node_allocator_type>::value && GLARE_HAS_TRIVIAL_DESTRUCTOR(node_type))
+            {
+                // Nothing to run on the nodes, their memory goes back with the allocator.
+            }
+            else if (m_reclaimer)
+            {
+                node_allocator_type allocator(m_nodeAllocator);
+                node_pointer root = m_root;
+                m_reclaimer->retire([=]() mutable { internal_clean(allocator, root); });
+            }
+            else
+            {
+                internal_clean(m_nodeAllocator, m_root);
+            }
             m_root = nullptr;
             m_size = 0;
         }
     }
     //--------------------------------------------------------------------------------------------------------------
     template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    void AvlTree<_KeyType, _ValType, _Pred, _Alloc>::internal_clean(node_pointer _subroot)
+    void AvlTree<_KeyType, _ValType, _Pred, _Alloc>::internal_clean(node_allocator_type& _allocator, node_pointer _subroot)
     {
         if (_subroot->m_left) {
-            internal_clean(_subroot->m_left);
+            internal_clean(_allocator, _subroot->m_left);
         }
         if (_subroot->m_right) {
-            internal_clean(_subroot->m_right);
+            internal_clean(_allocator, _subroot->m_right);
         }
 
         // Notice: PostOrder style destruction.
-        m_nodeAllocator.destroy(_subroot);
-        m_nodeAllocator.deallocate(_subroot, 1);
+        _allocator.destroy(_subroot);
+        _allocator.deallocate(_subroot, 1);
     }
     //--------------------------------------------------------------------------------------------------------------
     template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    inline void AvlTree<_KeyType, _ValType, _Pred, _Alloc>::copyTree(const AvlTree& _originalRoot)
+    inline void AvlTree<_KeyType, _ValType, _Pred, _Alloc>::copyTree(const AvlTree& _originalRoot, ThreadPool* _pool)
     //--------------------------------------------------------------------------------------------------------------
     {
         m_binPredicate = _originalRoot.m_binPredicate;
         m_traversalFunc = _originalRoot.m_traversalFunc;
-        copy(m_root, _originalRoot.m_root);
+        copy(m_root, _originalRoot.m_root, _pool, _pool ? parallel_fork_depth(*_pool) : 0);
+        m_size = _originalRoot.m_size;
     }
     //--------------------------------------------------------------------------------------------------------------
     template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    void AvlTree<_KeyType, _ValType, _Pred, _Alloc>::copy(node_pointer& _copyRoot, const_node_pointer _originalRoot)
+    void AvlTree<_KeyType, _ValType, _Pred, _Alloc>::copy(node_pointer& _copyRoot, const_node_pointer _originalRoot, ThreadPool* _pool, unsigned int _forkDepth)
     //--------------------------------------------------------------------------------------------------------------
     {
         if (_originalRoot == nullptr)
@@ -767,10 +1083,12 @@ namespace glare
             // Notice: Preorder fashion, create and copy current.
             _copyRoot = m_nodeAllocator.allocate(1);
             m_nodeAllocator.construct(_copyRoot, *_originalRoot);
-            ++m_size;
             
-            copy(_copyRoot->m_left, _originalRoot->m_left);
-            copy(_copyRoot->m_right, _originalRoot->m_right);
+            node_pointer copyRoot = _copyRoot;
+            const unsigned int forkDepth = _forkDepth ? _forkDepth - 1 : 0;
+            parallel_invoke(_forkDepth ? _pool : nullptr,
+                [&]() { copy(copyRoot->m_left, _originalRoot->m_left, _pool, forkDepth); },
+                [&]() { copy(copyRoot->m_right, _originalRoot->m_right, _pool, forkDepth); });
         }
     }
     //--------------------------------------------------------------------------------------------------------------
@@ -825,6 +1143,74 @@ namespace glare
         m_traversalFunc(m_root, _cb);
     }
 
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    template<typename _Func>
+    inline bool AvlTree<_KeyType, _ValType, _Pred, _Alloc>::for_each_inorder(_Func _func) const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        return visit_inorder(m_root, _func);
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    template<typename _Func>
+    inline bool AvlTree<_KeyType, _ValType, _Pred, _Alloc>::for_each_preorder(_Func _func) const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        return visit_preorder(m_root, _func);
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    template<typename _Func>
+    inline bool AvlTree<_KeyType, _ValType, _Pred, _Alloc>::for_each_postorder(_Func _func) const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        return visit_postorder(m_root, _func);
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    template<typename _Func>
+    inline bool AvlTree<_KeyType, _ValType, _Pred, _Alloc>::morris_for_each_inorder(_Func _func)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        auto visit = [&_func](node_pointer _node) -> bool { return _func(_node->key(), static_cast<const_reference>(_node->value())); };
+        return glare::morris_for_each_inorder(m_root, visit);
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    // The recursion is as deep as the tree, under AVL_MAX_HEIGHT. It measured no slower than keeping the path on an array.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    template<typename _Func>
+    bool AvlTree<_KeyType, _ValType, _Pred, _Alloc>::visit_inorder(const_node_pointer _node, _Func& _func)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        if (_node == nullptr) {
+            return true;
+        }
+        return visit_inorder(_node->m_left, _func) && _func(_node->key(), _node->value()) && visit_inorder(_node->m_right, _func);
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    template<typename _Func>
+    bool AvlTree<_KeyType, _ValType, _Pred, _Alloc>::visit_preorder(const_node_pointer _node, _Func& _func)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        if (_node == nullptr) {
+            return true;
+        }
+        return _func(_node->key(), _node->value()) && visit_preorder(_node->m_left, _func) && visit_preorder(_node->m_right, _func);
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    template<typename _Func>
+    bool AvlTree<_KeyType, _ValType, _Pred, _Alloc>::visit_postorder(const_node_pointer _node, _Func& _func)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        if (_node == nullptr) {
+            return true;
+        }
+        return visit_postorder(_node->m_left, _func) && visit_postorder(_node->m_right, _func) && _func(_node->key(), _node->value());
+    }
+
     //--------------------------------------------------------------------------------------------------------------
     // TREE SERIALIZATION
     //--------------------------------------------------------------------------------------------------------------
@@ -835,7 +1221,9 @@ namespace glare
     {
         if (_read)
         {
-            avl_serialize_to_list(m_root, _list);
+            if (m_root) {
+                avl_serialize_to_list(m_root, _list);
+            }
         }
         else
         {
@@ -844,6 +1232,187 @@ namespace glare
     }    
     //--------------------------------------------------------------------------------------------------------------
     template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    inline typename AvlTree<_KeyType, _ValType, _Pred, _Alloc>::size_type AvlTree<_KeyType, _ValType, _Pred, _Alloc>::snapshotSize() const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        return sizeof(snapshot_header) + m_size * sizeof(snapshot_record);
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    void AvlTree<_KeyType, _ValType, _Pred, _Alloc>::writeSnapshot(void* _buffer) const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        static_assert(GLARE_IS_POD(key_type) && GLARE_IS_POD(value_type), "A snapshot copies the keys and values as they are");
+
+        snapshot_header header;
+        GLARE_MEMSET(&header, 0, sizeof(header));
+        header.m_magic = AVL_SNAPSHOT_MAGIC;
+        header.m_version = AVL_SNAPSHOT_VERSION;
+        header.m_recordSize = sizeof(snapshot_record);
+        header.m_count = m_size;
+        GLARE_MEMCPY(_buffer, &header, sizeof(header));
+
+        // The padding of the records is zeroed too, the same tree always gives the same bytes.
+        snapshot_record* record = reinterpret_cast<snapshot_record*>(static_cast<unsigned char*>(_buffer) + sizeof(header));
+        GLARE_MEMSET(record, 0, m_size * sizeof(snapshot_record));
+
+        const_node_pointer pending[AVL_MAX_HEIGHT]; // The right children still to visit.
+        unsigned int depth = 0;
+        for (const_node_pointer current = m_root; current != nullptr; ++record)
+        {
+            record->m_key = current->key();
+            record->m_value = current->value();
+            record->m_flags = static_cast<unsigned char>(current->balanceFactor() + 1)
+                            | (current->m_left ? snapshot_record::HasLeft : 0)
+                            | (current->m_right ? snapshot_record::HasRight : 0);
+
+            if (current->m_right) {
+                pending[depth++] = current->m_right;
+            }
+            current = current->m_left ? current->m_left : (depth ? pending[--depth] : nullptr);
+        }
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    // Every record is linked in where the previous one left an empty child: its left child when it has one, otherwise the
+    // right child of the last node that still waits for it. No node goes deeper than AVL_MAX_HEIGHT, so the arrays of insert()
+    // and remove() and the recursive walks stay in bounds, and the balance factors must match the heights once linked.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    bool AvlTree<_KeyType, _ValType, _Pred, _Alloc>::loadSnapshot(const void* _buffer, size_type _bytes)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        static_assert(GLARE_IS_POD(key_type) && GLARE_IS_POD(value_type), "A snapshot copies the keys and values as they are");
+
+        snapshot_header header;
+        if (_buffer == nullptr || _bytes < sizeof(header)) {
+            return false;
+        }
+        GLARE_MEMCPY(&header, _buffer, sizeof(header));
+        if (header.m_magic != AVL_SNAPSHOT_MAGIC || header.m_version != AVL_SNAPSHOT_VERSION || header.m_recordSize != sizeof(snapshot_record)
+            || header.m_count > (_bytes - sizeof(header)) / sizeof(snapshot_record)) {
+            return false;
+        }
+
+        const unsigned char* source = static_cast<const unsigned char*>(_buffer) + sizeof(header);
+        const size_type count = static_cast<size_type>(header.m_count);
+
+        node_pointer root = nullptr;
+        node_pointer* link = &root;
+        unsigned int level = 1;                         // Of the node linked at *link.
+        node_pointer* pending[AVL_MAX_HEIGHT];
+        unsigned int pendingLevel[AVL_MAX_HEIGHT];
+        unsigned int depth = 0;
+        bool valid = true;
+
+        for (size_type i = 0; i < count && valid; ++i, source += sizeof(snapshot_record))
+        {
+            snapshot_record record; // The mapping may not be aligned for the key and value types.
+            GLARE_MEMCPY(&record, source, sizeof(record));
+            if (link == nullptr || level > AVL_MAX_HEIGHT || (record.m_flags & snapshot_record::BalanceMask) > 2)
+            {
+                valid = false;
+                break;
+            }
+
+            node_pointer nodePtr = m_nodeAllocator.allocate(1);
+            m_nodeAllocator.construct(nodePtr, record);
+            *link = nodePtr;
+
+            if (record.m_flags & snapshot_record::HasRight)
+            {
+                if (depth == AVL_MAX_HEIGHT)
+                {
+                    valid = false;
+                    break;
+                }
+                pendingLevel[depth] = level + 1;
+                pending[depth++] = &nodePtr->m_right;
+            }
+
+            if (record.m_flags & snapshot_record::HasLeft)
+            {
+                link = &nodePtr->m_left;
+                ++level;
+            }
+            else if (depth)
+            {
+                link = pending[--depth];
+                level = pendingLevel[depth];
+            }
+            else {
+                link = nullptr;
+            }
+        }
+
+        int height = 0;
+        if (!valid || (count > 0 && link != nullptr) || !check_heights(root, height))
+        {
+            if (root) {
+                internal_clean(m_nodeAllocator, root); // The children it promised are missing, or it isn't balanced.
+            }
+            return false;
+        }
+
+        clear();
+        m_root = root;
+        m_size = count;
+        return true;
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    bool AvlTree<_KeyType, _ValType, _Pred, _Alloc>::check_heights(const_node_pointer _node, int& _height)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        if (_node == nullptr)
+        {
+            _height = 0;
+            return true;
+        }
+
+        int leftHeight = 0;
+        int rightHeight = 0;
+        if (!check_heights(_node->m_left, leftHeight) || !check_heights(_node->m_right, rightHeight)) {
+            return false;
+        }
+        _height = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+        return (leftHeight - rightHeight == _node->balanceFactor());
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    bool AvlTree<_KeyType, _ValType, _Pred, _Alloc>::saveSnapshot(const char* _path) const
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        GLARE_VECTOR<unsigned char> buffer(snapshotSize());
+        writeSnapshot(&buffer[0]);
+
+        std::FILE* file = std::fopen(_path, "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        const bool written = std::fwrite(&buffer[0], 1, buffer.size(), file) == buffer.size();
+        return (std::fclose(file) == 0) && written;
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    bool AvlTree<_KeyType, _ValType, _Pred, _Alloc>::loadSnapshot(const char* _path)
+    //--------------------------------------------------------------------------------------------------------------
+    {
+        std::FILE* file = std::fopen(_path, "rb");
+        if (file == nullptr) {
+            return false;
+        }
+
+        GLARE_VECTOR<unsigned char> buffer;
+        unsigned char chunk[GLARE_PAGE_SIZE];
+        for (std::size_t bytes; (bytes = std::fread(chunk, 1, sizeof(chunk), file)) > 0; ) {
+            buffer.insert(buffer.end(), chunk, chunk + bytes);
+        }
+        const bool read = std::ferror(file) == 0;
+        std::fclose(file);
+
+        return read && !buffer.empty() && loadSnapshot(&buffer[0], buffer.size());
+    }
+    //--------------------------------------------------------------------------------------------------------------
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
     void AvlTree<_KeyType, _ValType, _Pred, _Alloc>::avl_serialize_to_list(node_pointer _node, serializable_list& _list)
     //--------------------------------------------------------------------------------------------------------------
     {
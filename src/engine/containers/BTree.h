@@ -2,7 +2,11 @@
 #define GLARE_B_TREE_H
 
 #include "GlareCoreUtility.h"
+#include "TreeStats.h"
 #include "memory\allocators.h"
+#include "threading\Reclaimer.h"
+#include "threading\ThreadPool.h"
+#include <algorithm>
 
 // TODO Isolate copy constructor calls, assignment operator calls and temporaries.
 // TODO Provide copy constructor, assignment operator to the BTreeNode.
@@ -12,6 +16,12 @@
 // BTree or a multi-way tree is a tree with order greater than 2, O(m) > 2. This means that all the nodes can have at max m children, where m > 2.
 // Binary Search Tree is of order 2, it has at most 2 children per node, 1 key to partition two children.
 
+// Fill of the left node when a full node on the right edge is split by an append. 50 gives the classic split, higher keeps the
+// nodes of a monotonically increasing sequence dense; the right node is filled by the appends that follow.
+#ifndef GLARE_BTREE_APPEND_FILL_PERCENT
+    #define GLARE_BTREE_APPEND_FILL_PERCENT 90
+#endif
+
 namespace glare
 {
     typedef unsigned int  btree_order_t;
@@ -53,11 +63,16 @@ namespace glare
 
         void splitInsertAt(btree_order_t _pos, const key_type& _keyIn, const_reference _valueIn, node_pointer _rightBranchIn, 
                                        key_type* _medianKeyOut, pointer _medianValueOut, node_pointer _rightBranchOut);
+        void splitAppend(const key_type& _keyIn, const_reference _valueIn, node_pointer _rightBranchIn, btree_order_t _leftCount,
+                                       key_type* _medianKeyOut, pointer _medianValueOut, node_pointer _rightBranchOut);
 
         void moveLeft(btree_order_t rightBranchPosition);
         void moveRight(btree_order_t leftBranchPosition);
         node_pointer combine(btree_order_t leftBranchPosition);
 
+        void truncate(btree_order_t _count);
+        void splitOff(btree_order_t _pos, node_pointer _rightOut);
+
         void removeLeafData(btree_order_t _idx);
         void copyInPredecessor(btree_order_t _idx);
         
@@ -280,6 +295,40 @@ namespace glare
         --m_keyCount;
     }
 
+    // Pre: Current node is full and the new entry is greater than all of its keys; _leftCount < MAXKEYS.
+    // Post: Current node keeps its first _leftCount entries, the entry at _leftCount is sent up as the median and the entries after it,
+    //       followed by the new entry, move to _rightBranchOut. Used on the right edge, where the right half only grows by appends.
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    void BTreeNode<_keyType, _ValueType, _Order, _AllocatorType>::splitAppend(const _keyType& _keyIn, const _ValueType& _valueIn, node_pointer _rightBranchIn, 
+                                                                              btree_order_t _leftCount, _keyType* _medianKeyOut, _ValueType* _medianValueOut,
+                                                                              node_pointer _rightBranchOut)
+    {
+        GLARE_ASSERT(isFull(), "Fatal Error: Node must be full.");
+        GLARE_ASSERT(_rightBranchOut->m_keyCount == 0, "Fatal Error: Right branch must be empty for division of keys.");
+        GLARE_ASSERT(_leftCount < MAXKEYS, "Fatal Error: The median must come from the current node.");
+
+        const btree_order_t firstRight = _leftCount + 1;
+        for (btree_order_t i = firstRight; i < MAXKEYS; ++i)
+        {
+            const btree_order_t idx = i - firstRight;
+            _rightBranchOut->copy_construct_key_value(idx, key(i), value(i));
+            _rightBranchOut->m_branch[idx+1] = branch(i+1);
+            m_branch[i+1] = nullptr;
+            destroy_key_value(i);
+        }
+
+        _rightBranchOut->m_branch[0] = branch(firstRight); // Right branch of the median.
+        m_branch[firstRight] = nullptr;
+        _rightBranchOut->m_keyCount = MAXKEYS - firstRight;
+        _rightBranchOut->insertAt(_rightBranchOut->m_keyCount, _keyIn, _valueIn, _rightBranchIn);
+
+        new (_medianKeyOut) key_type(key(_leftCount));               // copy construct key.
+        m_allocator.construct(_medianValueOut, value(_leftCount));   // copy construct value.
+        destroy_key_value(_leftCount);
+
+        m_keyCount = _leftCount;
+    }
+
     template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
     void BTreeNode<_keyType, _ValueType, _Order, _AllocatorType>::removeLeafData(btree_order_t _idx)
     {
@@ -318,12 +367,22 @@ namespace glare
         --m_keyCount;
     }
     
-    // Pre: Current has n keys and n+1 branches, where n < MAXKEYS.
+    // Pre: Current has n keys and n+1 branches, where n < MAXKEYS. n may be 0 for the nodes on the right edge, see BTree::internal_append.
     // Post: Shifts the key/value and branches right, overriding (_begPos+1) with _begPos causing the array to grow in size.
     //       Note: key/value at _begPos co-exists with same key/value at _begPos+1; but branch[_begPos] is NULL. _begPos can then be copy assigned.
     template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
     void BTreeNode<_keyType, _ValueType, _Order, _AllocatorType>::shift_right(btree_order_t _begPos, const _keyType& _key, const _ValueType& _val, node_pointer _leftBranch)
     {
+        if (nbKeys() == 0)
+        {
+            GLARE_ASSERT(_begPos == 0, "Fatal Error, _begPos is out of bounds.");
+            copy_construct_key_value(0, _key, _val);
+            m_branch[1] = m_branch[0];
+            m_branch[0] = _leftBranch;
+            ++m_keyCount;
+            return;
+        }
+
         GLARE_ASSERT(_begPos < nbKeys() && nbKeys() < MAXKEYS, "Fatal Error, _begPos is out of bounds.");
 
         // Since, the array is about to grow in size:
@@ -424,6 +483,38 @@ namespace glare
         return ptrRightBranch;
     }
 
+    // Pre: _count <= nbKeys().
+    // Post: The first _count entries and the branches around them stay, the entries after are destroyed and their right branches unlinked.
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    void BTreeNode<_keyType, _ValueType, _Order, _AllocatorType>::truncate(btree_order_t _count)
+    {
+        GLARE_ASSERT(_count <= nbKeys(), "Fatal Error, _count is out of bounds.");
+
+        for (btree_order_t i = m_keyCount; i > _count; --i)
+        {
+            destroy_key_value(i-1);
+            m_branch[i] = nullptr;
+        }
+        m_keyCount = _count;
+    }
+
+    // Pre: _pos < nbKeys() and _rightOut is an empty node.
+    // Post: The entries after _pos have moved to _rightOut with their branches, the branch right of _pos is its first one. The entry at
+    //       _pos is destroyed, the caller copies it beforehand; the current node keeps the first _pos entries and the branch after them.
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    void BTreeNode<_keyType, _ValueType, _Order, _AllocatorType>::splitOff(btree_order_t _pos, node_pointer _rightOut)
+    {
+        GLARE_ASSERT(_pos < nbKeys() && _rightOut->nbKeys() == 0, "Fatal Error, _pos is out of bounds or _rightOut is in use.");
+
+        _rightOut->m_branch[0] = m_branch[_pos+1];
+        for (btree_order_t i = _pos+1; i < nbKeys(); ++i)
+        {
+            _rightOut->copy_construct_key_value(_rightOut->nbKeys(), key(i), value(i));
+            _rightOut->m_branch[++_rightOut->m_keyCount] = m_branch[i+1];
+        }
+        truncate(_pos);
+    }
+
     template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
     void BTreeNode<_keyType, _ValueType, _Order, _AllocatorType>::copyInPredecessor(btree_order_t _idx)
     {
@@ -462,12 +553,33 @@ namespace glare
         typedef _Alloc                                          allocator_type;
         typedef GLARE_PAIR<key_type, value_type>                pair_type;
 
+        enum BatchOp
+        {
+            BatchOp_Insert,     // Adds the pair when the key is absent, like insert().
+            BatchOp_Update,     // Assigns the value, adds the pair when the key is absent.
+            BatchOp_Remove,     // Removes the key when present, like remove().
+        };
+
+        struct batch_op_type
+        {
+            BatchOp     m_op;
+            key_type    m_key;
+            value_type  m_value;
+
+            batch_op_type(BatchOp _op, const key_type& _key, const_reference _value = value_type()): m_op(_op), m_key(_key), m_value(_value) {}
+        };
+        typedef GLARE_VECTOR<batch_op_type>                     batch_type;
+
 
         BTree();
         ~BTree();
         BTree(const BTree&);
         BTree& operator= (const BTree&);
 
+        // Deep copy with the branches of the top levels copied in parallel on _pool, the allocators are then called from the pool
+        // threads. Sequential without a pool.
+        BTree(const BTree& _other, ThreadPool* _pool);
+
         bool find(const key_type& _key, value_type& _pVal) const;
         pointer find(const key_type& _key);
         const_pointer find(const key_type& _key) const;
@@ -475,11 +587,97 @@ namespace glare
         bool insert(const key_type& _key, const_reference _value);
         void remove(const key_type& _key);
 
+        // Removes the keys in [_low, _high) and returns their nb. The range is split out of the tree and the rest joined back with
+        // O(log n) node operations, the k nodes of the range are then freed in one pass, on the reclaimer when there is one.
+        size_type erase(const key_type& _low, const key_type& _high);
+
+        // Applies a batch of mutations in a single walk of the tree and returns the nb of ops that changed it. The batch is sorted by key
+        // in place, stable so the ops on the same key apply in their given order; the result is the same as applying them one by one.
+        size_type apply_batch(batch_type& _ops);
+
         void clear();
 
+        size_type size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        size_type height() const { return m_height; } // Levels, kept up to date by the root splits and collapses.
+
+        // Single pass over the nodes. The fill histogram is indexed by the nb of keys in a node, 0 to MAXKEYS.
+        TreeStats stats() const;
+
+        // Checks the key order, the fill of the nodes, the depth of the leaves and the size, O(n). For the tests and debugging.
+        bool verify() const;
+
+        // Software prefetching for the lookups, off (0) by default. Once the branch is known the first _lines cache lines of the child
+        // are prefetched, so the lines of a wide node are fetched together rather than one at a time by the key scan. On a hit the value
+        // slot is prefetched too. Pays off once the tree is well past the last level cache, tune _lines with bench_btree.cpp.
+        void setPrefetchDistance(unsigned int _lines) { m_prefetchLines = _lines; }
+        unsigned int prefetchDistance() const { return m_prefetchLines; }
+
+        // Freeing on a background thread, off (nullptr) by default: clear() and the destructor detach the nodes and hand them to
+        // _reclaimer, so they return in O(1). Not copied with the tree. With an allocator that frees in bulk and keys and values
+        // without a destructor, the nodes are simply dropped.
+        void setReclaimer(Reclaimer* _reclaimer) { m_reclaimer = _reclaimer; }
+        Reclaimer* reclaimer() const { return m_reclaimer; }
+
     private:
-        void cleanUp(node_pointer _subRoot);
-        void copy(node_pointer& _copyRoot, const_node_pointer _originalRoot);
+        struct batch_op_less
+        {
+            bool operator() (const batch_op_type& _left, const batch_op_type& _right) const { return _right.m_key > _left.m_key; }
+        };
+
+        // A node on the path of apply_batch and the key its subtree stays below, nullptr when only the ancestors bound it.
+        struct batch_path_entry
+        {
+            node_pointer     m_node;
+            const key_type*  m_upper;
+
+            batch_path_entry(node_pointer _node, const key_type* _upper): m_node(_node), m_upper(_upper) {}
+        };
+
+        // A tree cut off by split_subtree: its root, which may hold fewer than MINKEYS keys, and its nb of levels, 0 when empty.
+        struct subtree
+        {
+            node_pointer    m_root;
+            size_type       m_height;
+
+            subtree(): m_root(nullptr), m_height(0) {}
+            subtree(node_pointer _root, size_type _height): m_root(_root), m_height(_height) {}
+        };
+
+        // The nodes from a root down to an edge, each with the branch taken out of it.
+        typedef GLARE_VECTOR<GLARE_PAIR<node_pointer, btree_order_t> > node_path_type;
+
+        // Static so the nodes can be freed on a reclaimer thread after the tree is gone. Returns the nb of keys freed.
+        static size_type cleanUp(node_allocator_type& _allocator, node_pointer _subRoot);
+        static size_type count_keys(const_node_pointer _subRoot);
+
+        // Frees the nodes below _subRoot the way clear() does. Returns the nb of keys they held when _count, 0 otherwise.
+        size_type dispose(node_pointer _subRoot, bool _count);
+
+        // Pre: _tree holds at least one key.
+        // Post: _less holds the keys less than _key and _greater the keys after the first one that is not; that one is returned in
+        //       _middleKey/_middleValue for the caller to destroy, nullptr when there is none. _tree is consumed, O(log n) node operations.
+        void split_subtree(const subtree& _tree, const key_type& _key, subtree& _less, key_type*& _middleKey, pointer& _middleValue, subtree& _greater);
+
+        // Pre: The keys of _left are less than _key, less than the keys of _right.
+        // Post: The three as one tree; _key goes down the spine of the higher one to the level of the other, O(height difference + 1).
+        subtree join_subtrees(const subtree& _left, const key_type& _key, const_reference _value, const subtree& _right);
+
+        // Post: _node at _height, or its only branch when the split left it with no key.
+        subtree make_subtree(node_pointer _node, size_type _height);
+
+        // Pre: _parent has one key between two branches of the same height, either may be short of MINKEYS.
+        // Post: true when they fit in the left one, which took in the key and the right one, false when both have MINKEYS keys or more.
+        bool even_out(node_pointer _parent);
+
+        // Inserts at _position of the last node on _path, splitting the full nodes on the way up; a new root goes on top of _tree.
+        void insert_on_path(subtree& _tree, const node_path_type& _path, btree_order_t _position, const key_type& _key, const_reference _value,
+                            node_pointer _rightBranch);
+
+        bool verify_subtree(const_node_pointer _node, const key_type* _low, const key_type* _high, size_type _level, size_type& _count) const;
+
+        // Every branch is a task for _forkDepth levels, counted as in a binary split: a node with 8 branches uses 3 of them.
+        void copy(node_pointer& _copyRoot, const_node_pointer _originalRoot, ThreadPool* _pool = nullptr, unsigned int _forkDepth = 0);
 
         enum ERCode_Insert
         {
@@ -489,12 +687,20 @@ namespace glare
             ERCode_Insert_Error_Duplicate,
         };
 
+        // Left fill of a split on the right edge, within [MINKEYS, MAXKEYS-1] so the median always comes from the split node.
+        static const btree_order_t APPEND_LEFT_KEYS_RAW = (node_type::MAXKEYS * GLARE_BTREE_APPEND_FILL_PERCENT) / 100;
+        static const btree_order_t APPEND_LEFT_KEYS = APPEND_LEFT_KEYS_RAW < node_type::MINKEYS ? node_type::MINKEYS :
+                                                      (APPEND_LEFT_KEYS_RAW >= node_type::MAXKEYS ? node_type::MAXKEYS-1 : APPEND_LEFT_KEYS_RAW);
+
         bool internal_find(const_node_pointer _current, const key_type& _key, node_pointer& _retNode, btree_order_t& _position) const;
         bool internal_insert(const key_type& _key, const const_reference _val);
+        bool internal_append(const key_type& _key, const_reference _val);
+        void build_right_path();
         ERCode_Insert internal_push_down_insert(node_pointer _current, const key_type& _key, const_reference _val,
                                                 key_type* &_medianKeyOut, pointer& _medianValueOut, node_pointer& _rightBranchOut);
 
         bool internal_remove(const key_type& _key);
+        bool batch_apply_op(const batch_op_type& _op, node_pointer _current, btree_order_t _position, bool _found, bool& _restructured);
         bool internal_recursive_remove(node_pointer _current, const key_type& _key);
         void internal_restore(node_pointer _current, btree_order_t _pos);
 
@@ -515,21 +721,26 @@ namespace glare
         }
 
         template<typename T>
-        void destroyObject(T& _alloc, typename T::pointer _ptr)
+        static void destroyObject(T& _alloc, typename T::pointer _ptr)
         {
             _alloc.destroy(_ptr);
             _alloc.deallocate(_ptr, 1);
         }
 
         node_pointer        m_root;
+        size_type           m_size;
+        size_type           m_height;
+        GLARE_VECTOR<node_pointer> m_rightPath; // Root to rightmost leaf, empty when it needs to be rebuilt.
+        unsigned int        m_prefetchLines;
         node_allocator_type m_nodeAllocator;
         allocator_type      m_allocator;
         key_allocator_type  m_keyAllocator;
+        Reclaimer*          m_reclaimer;
     }; // ----------- End of Class -----------
 
 
     template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
-    BTree<_keyType, _ValueType, _Order, _AllocatorType>::BTree() : m_root(nullptr) {
+    BTree<_keyType, _ValueType, _Order, _AllocatorType>::BTree() : m_root(nullptr), m_size(0), m_height(0), m_prefetchLines(0), m_reclaimer(nullptr) {
     }
 
     template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
@@ -539,11 +750,19 @@ namespace glare
     }
 
     template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
-    BTree<_keyType, _ValueType, _Order, _AllocatorType>::BTree(const BTree& _other) : m_root(nullptr)
+    BTree<_keyType, _ValueType, _Order, _AllocatorType>::BTree(const BTree& _other) : m_root(nullptr), m_size(_other.m_size), m_height(_other.m_height)
+                                                                     , m_prefetchLines(_other.m_prefetchLines), m_reclaimer(nullptr)
     {
         copy(m_root, _other.m_root);
     }
 
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    BTree<_keyType, _ValueType, _Order, _AllocatorType>::BTree(const BTree& _other, ThreadPool* _pool) : m_root(nullptr), m_size(_other.m_size), m_height(_other.m_height)
+                                                                                         , m_prefetchLines(_other.m_prefetchLines), m_reclaimer(nullptr)
+    {
+        copy(m_root, _other.m_root, _pool, _pool ? parallel_fork_depth(*_pool) : 0);
+    }
+
     template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
     BTree<_keyType, _ValueType, _Order, _AllocatorType>& 
     BTree<_keyType, _ValueType, _Order, _AllocatorType>::operator = (const BTree& _other)
@@ -552,6 +771,9 @@ namespace glare
         {
             clear();
             copy(m_root, _other.m_root);
+            m_size = _other.m_size;
+            m_height = _other.m_height;
+            m_prefetchLines = _other.m_prefetchLines;
         }
         return *this;
     }
@@ -565,12 +787,18 @@ namespace glare
         {
             if(_current->findKeyPosition(_key, _position)) // Search for the key in the current node.
             { // Found.
+                if (m_prefetchLines) {
+                    GLARE_PREFETCH(&_current->value(_position)); // Values live in their own block, the caller reads it next.
+                }
                 _retNode = const_cast<node_pointer>(_current);
                 return true; // position is set correctly by the _current->findKeyPosition() method itself.
             }
             else
             { // Search Failed.
                 _current = _current->branch(_position);
+                if (m_prefetchLines && _current) {
+                    prefetch_lines(_current, m_prefetchLines);
+                }
             }
         }
 
@@ -580,6 +808,19 @@ namespace glare
     template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
     bool BTree<_keyType, _ValueType, _Order, _AllocatorType>::internal_insert(const key_type& _key, const const_reference _val)
     {
+        if (m_root != nullptr)
+        {
+            // Keys arriving in increasing order go to the rightmost leaf, no need to descend from the root.
+            if (m_rightPath.empty()) {
+                build_right_path();
+            }
+
+            const_node_pointer rightmostLeaf = m_rightPath.back();
+            if (_key > rightmostLeaf->key(rightmostLeaf->nbKeys()-1)) {
+                return internal_append(_key, _val);
+            }
+        }
+
         key_type* medianKeyOut = nullptr; // Median Key-
         pointer medianValueOut = nullptr; // Value Pair
         node_pointer rightBranchOut = nullptr; // Right branch of Key-Value or Data.
@@ -591,6 +832,8 @@ namespace glare
             nodePtr->branch(0) = m_root; // Left Branch
             nodePtr->insertAt(0, *medianKeyOut, *medianValueOut, rightBranchOut); // Set Median Key-Value with right branch, so this is new root.
             m_root = nodePtr;
+            m_rightPath.clear();
+            ++m_height;
             result = ERCode_Insert_Success;
 
             // Free the pointers.
@@ -601,6 +844,9 @@ namespace glare
         GLARE_ASSERT(medianKeyOut == nullptr && medianValueOut == nullptr, "Fatal Error: Memory Leak, why are the pointers not free");
         GLARE_ASSERT(result != ERCode_Insert_Error_Invalid, "How could the result be invalid!");
 
+        if (result == ERCode_Insert_Success) {
+            ++m_size;
+        }
         return result == ERCode_Insert_Success;
     }
 
@@ -654,6 +900,7 @@ namespace glare
                         _medianValueOut = m_allocator.allocate(1);
 
                         _rightBranchOut = createObject(m_nodeAllocator);
+                        m_rightPath.clear(); // The split may have been on the right edge.
 
                         // Use *keyPtr, *valuePtr objects to copy-assign and later dispose of them.
                         _current->splitInsertAt(position, *keyPtr, *valuePtr, rightBranchPtr, _medianKeyOut, _medianValueOut, _rightBranchOut);
@@ -672,15 +919,90 @@ namespace glare
         return result;
     }
 
+    // Pre: m_rightPath holds the path from the root to the rightmost leaf and _key is greater than every key in the tree.
+    // Post: The pair is appended to the rightmost leaf. Full nodes on the way up are split with splitAppend, keeping APPEND_LEFT_KEYS
+    //       on the left, and the path is updated to the new right edge. The nodes on the right edge may hold fewer than MINKEYS keys,
+    //       the following appends fill them and the removal code restores them like any other node.
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    bool BTree<_keyType, _ValueType, _Order, _AllocatorType>::internal_append(const key_type& _key, const_reference _val)
+    {
+        const key_type* keyPtr = &_key;     // Entry to be appended at the current level,
+        const_pointer valuePtr = &_val;     // the median of the level below once we split.
+        key_type* medianKeyOut = nullptr;
+        pointer medianValueOut = nullptr;
+        node_pointer rightBranch = nullptr;
+
+        for (size_type level = m_rightPath.size(); level > 0; --level)
+        {
+            node_pointer current = m_rightPath[level-1];
+
+            if (!current->isFull())
+            {
+                current->insertAt(current->nbKeys(), *keyPtr, *valuePtr, rightBranch);
+                rightBranch = nullptr;
+                break;
+            }
+
+            // Optimization, don't construct them here, copy construct them in splitAppend()
+            key_type* splitKeyOut = m_keyAllocator.allocate(1);
+            pointer splitValueOut = m_allocator.allocate(1);
+            node_pointer splitRightOut = createObject(m_nodeAllocator);
+
+            current->splitAppend(*keyPtr, *valuePtr, rightBranch, APPEND_LEFT_KEYS, splitKeyOut, splitValueOut, splitRightOut);
+
+            if (medianKeyOut) { destroyObject(m_keyAllocator, medianKeyOut); }
+            if (medianValueOut) { destroyObject(m_allocator, medianValueOut); }
+
+            medianKeyOut = splitKeyOut;     keyPtr = medianKeyOut;
+            medianValueOut = splitValueOut; valuePtr = medianValueOut;
+            rightBranch = splitRightOut;
+            m_rightPath[level-1] = splitRightOut; // The new node is on the right edge now.
+        }
+
+        if (rightBranch != nullptr)
+        {
+            // Root was split too, the tree grows by a level.
+            node_pointer nodePtr = createObject(m_nodeAllocator);
+            nodePtr->branch(0) = m_root;
+            nodePtr->insertAt(0, *keyPtr, *valuePtr, rightBranch);
+            m_root = nodePtr;
+            m_rightPath.insert(m_rightPath.begin(), nodePtr);
+            ++m_height;
+        }
+
+        if (medianKeyOut) { destroyObject(m_keyAllocator, medianKeyOut); }
+        if (medianValueOut) { destroyObject(m_allocator, medianValueOut); }
+
+        ++m_size;
+        return true;
+    }
+
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    void BTree<_keyType, _ValueType, _Order, _AllocatorType>::build_right_path()
+    {
+        m_rightPath.clear();
+        for (node_pointer current = m_root; current != nullptr; current = current->branch(current->nbKeys())) {
+            m_rightPath.push_back(current);
+        }
+    }
+
     template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
     bool BTree<_keyType, _ValueType, _Order, _AllocatorType>::internal_remove(const key_type& _key)
     {
+        m_rightPath.clear(); // Restoring may combine the nodes on the right edge, even when the key is not found.
+
         bool result = internal_recursive_remove(m_root, _key);
-        if (result && m_root && m_root->nbKeys() == 0)
+        if (result)
+        {
+            --m_size;
+        }
+        if (m_root && m_root->nbKeys() == 0)
         {
+            // Also after a failed search, the combines of a short right edge may have emptied the root.
             node_pointer ptrOldRoot = m_root;
             m_root = m_root->branch(0);
             destroyObject(m_nodeAllocator, ptrOldRoot);
+            --m_height;
         }
         return result;
     }
@@ -767,7 +1089,7 @@ namespace glare
             {
                 _current->moveRight(_position - 1);
             }
-            if (_current->branch(_position + 1)->nbKeys() > node_type::MINKEYS)
+            else if (_current->branch(_position + 1)->nbKeys() > node_type::MINKEYS)
             {
                 _current->moveLeft(_position + 1);
             }
@@ -837,31 +1159,548 @@ namespace glare
         internal_remove(_key);
     }
 
+    // Pre: The ops may come in any order.
+    // Post: The ops are applied in key order. The path from the root to the node of the previous op is kept; the next key climbs it only
+    //       as far as the first subtree whose upper bound it is below, so the ops landing in the same leaf, or the same subtree, share the
+    //       descent. Changes local to a node keep the path valid, a split or a restore goes through insert/remove and drops the path.
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    typename BTree<_keyType, _ValueType, _Order, _AllocatorType>::size_type
+    BTree<_keyType, _ValueType, _Order, _AllocatorType>::apply_batch(batch_type& _ops)
+    {
+        std::stable_sort(_ops.begin(), _ops.end(), batch_op_less());
+
+        size_type changed = 0;
+        GLARE_VECTOR<batch_path_entry> path;
+
+        for (typename batch_type::const_iterator op = _ops.begin(); op != _ops.end(); ++op)
+        {
+            if (m_root == nullptr)
+            {
+                if (op->m_op != BatchOp_Remove && internal_insert(op->m_key, op->m_value)) {
+                    ++changed;
+                }
+                continue;
+            }
+
+            // The keys are ascending, so the key is above the lower bound of every subtree on the path, only the upper bounds can fail.
+            while (!path.empty() && path.back().m_upper && !(*path.back().m_upper > op->m_key)) {
+                path.pop_back();
+            }
+            if (path.empty()) {
+                path.push_back(batch_path_entry(m_root, nullptr));
+            }
+
+            node_pointer current = path.back().m_node;
+            btree_order_t position;
+            bool found = current->findKeyPosition(op->m_key, position);
+            while (!found && current->branch(position) != nullptr)
+            {
+                const key_type* upper = position < current->nbKeys() ? &current->key(position) : path.back().m_upper;
+                current = current->branch(position);
+                path.push_back(batch_path_entry(current, upper));
+                found = current->findKeyPosition(op->m_key, position);
+            }
+
+            bool restructured = false;
+            if (batch_apply_op(*op, current, position, found, restructured)) {
+                ++changed;
+            }
+            if (restructured) {
+                path.clear();
+            }
+        }
+
+        return changed;
+    }
+
+    // Pre: _current holds _op.m_key at _position when _found, otherwise _current is the leaf it belongs to and _position its place.
+    // Post: The op is applied in place when the node can take it as is, otherwise through insert/remove with _restructured set.
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    bool BTree<_keyType, _ValueType, _Order, _AllocatorType>::batch_apply_op(const batch_op_type& _op, node_pointer _current, btree_order_t _position,
+                                                                             bool _found, bool& _restructured)
+    {
+        if (_op.m_op == BatchOp_Update && _found)
+        {
+            _current->value(_position) = _op.m_value;
+            return true;
+        }
+
+        switch (_op.m_op)
+        {
+        case BatchOp_Update: // Not there, add it like an insert.
+        case BatchOp_Insert:
+            if (_found) {
+                return false;
+            }
+            if (!_current->isFull())
+            {
+                _current->insertAt(_position, _op.m_key, _op.m_value, nullptr);
+                ++m_size;
+                return true;
+            }
+            _restructured = true; // The leaf splits.
+            return internal_insert(_op.m_key, _op.m_value);
+
+        case BatchOp_Remove:
+            if (!_found) {
+                return false;
+            }
+            if (_current->branch(_position) == nullptr && _current->nbKeys() > (_current == m_root ? 1 : node_type::MINKEYS))
+            {
+                _current->removeLeafData(_position);
+                --m_size;
+                return true;
+            }
+            _restructured = true; // An internal key takes its predecessor, or the leaf needs restoring.
+            return internal_remove(_op.m_key);
+        }
+
+        return false;
+    }
+
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    typename BTree<_keyType, _ValueType, _Order, _AllocatorType>::size_type BTree<_keyType, _ValueType, _Order, _AllocatorType>::erase(const key_type& _low, const key_type& _high)
+    {
+        if (m_root == nullptr || !(_high > _low)) {
+            return 0;
+        }
+
+        subtree less, rest, range, greater, result;
+        key_type* key = nullptr;
+        pointer value = nullptr;
+        size_type erased = 0;
+
+        split_subtree(subtree(m_root, m_height), _low, less, key, value, rest);
+        if (key == nullptr) {
+            result = less; // Every key is less than _low.
+        }
+        else if (!(_high > *key)) {
+            result = join_subtrees(less, *key, *value, rest); // Nothing in the range.
+        }
+        else
+        {
+            ++erased;
+            destroyObject(m_keyAllocator, key);
+            destroyObject(m_allocator, value);
+            key = nullptr;
+            value = nullptr;
+
+            if (rest.m_root != nullptr) {
+                split_subtree(rest, _high, range, key, value, greater);
+            }
+            erased += dispose(range.m_root, true);
+            result = key ? join_subtrees(less, *key, *value, greater) : less;
+        }
+
+        if (key != nullptr)
+        {
+            destroyObject(m_keyAllocator, key);
+            destroyObject(m_allocator, value);
+        }
+
+        m_root = result.m_root;
+        m_height = result.m_height;
+        m_size -= erased;
+        m_rightPath.clear();
+        return erased;
+    }
+
     template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
     void BTree<_keyType, _ValueType, _Order, _AllocatorType>::clear()
     {
-        cleanUp(m_root);
+        dispose(m_root, false);
         m_root = nullptr;
+        m_size = 0;
+        m_height = 0;
+        m_rightPath.clear();
+    }
+
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    TreeStats BTree<_keyType, _ValueType, _Order, _AllocatorType>::stats() const
+    {
+        TreeStats result;
+        result.m_maxKeysPerNode = node_type::MAXKEYS;
+        result.m_fillHistogram.resize(node_type::MAXKEYS + 1, 0);
+
+        GLARE_VECTOR<GLARE_PAIR<const_node_pointer, size_type> > pending;
+        if (m_root != nullptr) {
+            pending.push_back(GLARE_PAIR<const_node_pointer, size_type>(m_root, 0));
+        }
+
+        while (!pending.empty())
+        {
+            const_node_pointer current = pending.back().first;
+            const size_type depth = pending.back().second;
+            pending.pop_back();
+
+            result.addNode(depth, current->nbKeys());
+            result.m_size += current->nbKeys();
+
+            if (current->branch(0) != nullptr) // All the branches of an internal node are set, none of a leaf.
+            {
+                for (btree_order_t i = 0; i <= current->nbKeys(); ++i) {
+                    pending.push_back(GLARE_PAIR<const_node_pointer, size_type>(current->branch(i), depth + 1));
+                }
+            }
+        }
+
+        // Every node owns a block of MAXKEYS values next to itself.
+        result.m_bytes = result.m_nodeCount * (sizeof(node_type) + sizeof(value_type) * node_type::MAXKEYS);
+
+        GLARE_ASSERT(result.m_size == m_size, "Fatal Error: The size kept by the updates doesn't match the tree.");
+        GLARE_ASSERT(result.m_height == m_height, "Fatal Error: The height kept by the updates doesn't match the tree.");
+        return result;
+    }
+
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    bool BTree<_keyType, _ValueType, _Order, _AllocatorType>::verify() const
+    {
+        if (m_root == nullptr) {
+            return m_size == 0 && m_height == 0;
+        }
+
+        size_type count = 0;
+        return verify_subtree(m_root, nullptr, nullptr, 1, count) && count == m_size;
     }
 
     template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
-    void BTree<_keyType, _ValueType, _Order, _AllocatorType>::cleanUp(node_pointer _subRoot)
+    bool BTree<_keyType, _ValueType, _Order, _AllocatorType>::verify_subtree(const_node_pointer _node, const key_type* _low, const key_type* _high, size_type _level, size_type& _count) const
     {
+        const btree_order_t keys = _node->nbKeys();
+        // The nodes on the right edge, with no key above them, may be short, see internal_append.
+        if (keys == 0 || keys > node_type::MAXKEYS || (_node != m_root && _high != nullptr && keys < node_type::MINKEYS)) {
+            return false;
+        }
+
+        for (btree_order_t i = 0; i < keys; ++i)
+        {
+            const key_type* previous = i > 0 ? &_node->key(i-1) : _low;
+            if (previous != nullptr && !(_node->key(i) > *previous)) {
+                return false;
+            }
+        }
+        if (_high != nullptr && !(*_high > _node->key(keys-1))) {
+            return false;
+        }
+        _count += keys;
+
+        const bool leaf = _node->branch(0) == nullptr;
+        if (leaf != (_level == m_height)) { // All the leaves on the last level.
+            return false;
+        }
+
+        for (btree_order_t i = 0; i <= keys; ++i)
+        {
+            const_node_pointer child = _node->branch(i);
+            if (leaf ? child != nullptr
+                     : child == nullptr || !verify_subtree(child, i > 0 ? &_node->key(i-1) : _low, i < keys ? &_node->key(i) : _high, _level + 1, _count)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    typename BTree<_keyType, _ValueType, _Order, _AllocatorType>::size_type BTree<_keyType, _ValueType, _Order, _AllocatorType>::cleanUp(node_allocator_type& _allocator, node_pointer _subRoot)
+    {
+        size_type count = 0;
         if (_subRoot != nullptr)
         {
             for (btree_order_t i = 0; i <= _subRoot->nbKeys(); ++i) {
-                cleanUp(_subRoot->branch(i));
+                count += cleanUp(_allocator, _subRoot->branch(i));
+            }
+            count += _subRoot->nbKeys();
+            destroyObject(_allocator, _subRoot);
+        }
+        return count;
+    }
+
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    typename BTree<_keyType, _ValueType, _Order, _AllocatorType>::size_type BTree<_keyType, _ValueType, _Order, _AllocatorType>::count_keys(const_node_pointer _subRoot)
+    {
+        size_type count = 0;
+        if (_subRoot != nullptr)
+        {
+            for (btree_order_t i = 0; i <= _subRoot->nbKeys(); ++i) {
+                count += count_keys(_subRoot->branch(i));
+            }
+            count += _subRoot->nbKeys();
+        }
+        return count;
+    }
+
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    typename BTree<_keyType, _ValueType, _Order, _AllocatorType>::size_type BTree<_keyType, _ValueType, _Order, _AllocatorType>::dispose(node_pointer _subRoot, bool _count)
+    {
+        if (_subRoot == nullptr) {
+            return 0;
+        }
+
+        if (allocator_frees_in_bulk<node_allocator_type>::value && GLARE_HAS_TRIVIAL_DESTRUCTOR(key_type) && GLARE_HAS_TRIVIAL_DESTRUCTOR(value_type))
+        {
+            // All the node destructors would do is destroy the keys and values and give back their blocks, nothing to run.
+            return _count ? count_keys(_subRoot) : 0;
+        }
+
+        if (m_reclaimer)
+        {
+            const size_type count = _count ? count_keys(_subRoot) : 0;
+            node_allocator_type allocator(m_nodeAllocator);
+            m_reclaimer->retire([=]() mutable { cleanUp(allocator, _subRoot); });
+            return count;
+        }
+
+        return cleanUp(m_nodeAllocator, _subRoot);
+    }
+
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    void BTree<_keyType, _ValueType, _Order, _AllocatorType>::split_subtree(const subtree& _tree, const key_type& _key, subtree& _less, key_type*& _middleKey, pointer& _middleValue, subtree& _greater)
+    {
+        node_pointer current = _tree.m_root;
+        btree_order_t position = 0;
+        current->findKeyPosition(_key, position); // The first key not less than _key, or the branch that leads to it.
+
+        // The entries right of position go to a node of their own and the one at position is kept aside ...
+        key_type* rightKey = nullptr;
+        pointer rightValue = nullptr;
+        subtree right;
+        if (position < current->nbKeys())
+        {
+            rightKey = createObject(m_keyAllocator, current->key(position));
+            rightValue = createObject(m_allocator, current->value(position));
+            node_pointer rightNode = createObject(m_nodeAllocator);
+            current->splitOff(position, rightNode);
+            right = make_subtree(rightNode, _tree.m_height);
+        }
+
+        node_pointer child = current->branch(position);
+        current->branch(position) = nullptr;
+
+        // ... same on the left, the current node keeps the entries before the one left of position.
+        key_type* leftKey = nullptr;
+        pointer leftValue = nullptr;
+        subtree left;
+        if (position > 0)
+        {
+            leftKey = createObject(m_keyAllocator, current->key(position-1));
+            leftValue = createObject(m_allocator, current->value(position-1));
+            current->truncate(position-1);
+            left = make_subtree(current, _tree.m_height);
+        }
+        else
+        {
+            destroyObject(m_nodeAllocator, current);
+        }
+
+        // Then the branch in between is split and each side joined with its separator.
+        subtree childLess, childGreater;
+        _middleKey = nullptr;
+        _middleValue = nullptr;
+        if (child != nullptr) {
+            split_subtree(subtree(child, _tree.m_height - 1), _key, childLess, _middleKey, _middleValue, childGreater);
+        }
+
+        _less = leftKey ? join_subtrees(left, *leftKey, *leftValue, childLess) : childLess;
+        if (_middleKey != nullptr) {
+            _greater = rightKey ? join_subtrees(childGreater, *rightKey, *rightValue, right) : childGreater;
+        }
+        else
+        {
+            // The branch is all less than _key, the key right of it is the first one that is not.
+            GLARE_ASSERT(childGreater.m_root == nullptr, "Fatal Error: Keys past _key in the branch that has none.");
+            _middleKey = rightKey;
+            _middleValue = rightValue;
+            rightKey = nullptr;
+            _greater = right;
+        }
+
+        if (leftKey != nullptr)
+        {
+            destroyObject(m_keyAllocator, leftKey);
+            destroyObject(m_allocator, leftValue);
+        }
+        if (rightKey != nullptr)
+        {
+            destroyObject(m_keyAllocator, rightKey);
+            destroyObject(m_allocator, rightValue);
+        }
+    }
+
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    typename BTree<_keyType, _ValueType, _Order, _AllocatorType>::subtree BTree<_keyType, _ValueType, _Order, _AllocatorType>::make_subtree(node_pointer _node, size_type _height)
+    {
+        if (_node->nbKeys() > 0) {
+            return subtree(_node, _height);
+        }
+
+        node_pointer branch = _node->branch(0);
+        _node->branch(0) = nullptr;
+        destroyObject(m_nodeAllocator, _node);
+        return subtree(branch, branch ? _height - 1 : 0);
+    }
+
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    bool BTree<_keyType, _ValueType, _Order, _AllocatorType>::even_out(node_pointer _parent)
+    {
+        node_pointer left = _parent->branch(0);
+        node_pointer right = _parent->branch(1);
+        if (left->nbKeys() + right->nbKeys() < node_type::MAXKEYS)
+        {
+            destroyObject(m_nodeAllocator, _parent->combine(1));
+            return true;
+        }
+
+        // Together they hold 2*MINKEYS keys at least, the short one borrows from the other.
+        while (left->nbKeys() < node_type::MINKEYS) {
+            _parent->moveLeft(1);
+        }
+        while (right->nbKeys() < node_type::MINKEYS) {
+            _parent->moveRight(0);
+        }
+        return false;
+    }
+
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    typename BTree<_keyType, _ValueType, _Order, _AllocatorType>::subtree BTree<_keyType, _ValueType, _Order, _AllocatorType>::join_subtrees(const subtree& _left, const key_type& _key, const_reference _value, const subtree& _right)
+    {
+        if (_left.m_height == 0 && _right.m_height == 0)
+        {
+            node_pointer leaf = createObject(m_nodeAllocator);
+            leaf->insertAt(0, _key, _value, nullptr);
+            return subtree(leaf, 1);
+        }
+
+        // The two roots on the same level share a temporary parent, which merges them or evens them out and becomes the new root.
+        if (_left.m_height == _right.m_height)
+        {
+            node_pointer parent = createObject(m_nodeAllocator);
+            parent->branch(0) = _left.m_root;
+            parent->insertAt(0, _key, _value, _right.m_root);
+            if (!even_out(parent)) {
+                return subtree(parent, _left.m_height + 1);
             }
-            destroyObject(m_nodeAllocator, _subRoot);
+            parent->branch(0) = nullptr;
+            destroyObject(m_nodeAllocator, parent);
+            return _left;
+        }
+
+        // Otherwise the lower root pairs up with the node on the same level at the inner edge of the higher tree and _key goes up
+        // into the parent of that node, like an insertion.
+        subtree result = _left.m_height > _right.m_height ? _left : _right;
+        const size_type height = _left.m_height > _right.m_height ? _right.m_height : _left.m_height;
+        const bool leftHigher = _left.m_height > _right.m_height;
+
+        node_path_type path;
+        node_pointer current = result.m_root;
+        for (size_type level = result.m_height; level > height + 1; --level)
+        {
+            const btree_order_t next = leftHigher ? current->nbKeys() : 0;
+            path.push_back(GLARE_PAIR<node_pointer, btree_order_t>(current, next));
+            current = current->branch(next);
+        }
+        const btree_order_t position = leftHigher ? current->nbKeys() : 0;
+        path.push_back(GLARE_PAIR<node_pointer, btree_order_t>(current, position));
+
+        if (height == 0)
+        {
+            insert_on_path(result, path, position, _key, _value, nullptr); // Straight into the leaf.
+            return result;
         }
+
+        node_pointer sibling = current->branch(position);
+        node_pointer parent = createObject(m_nodeAllocator);
+        parent->branch(0) = leftHigher ? sibling : _left.m_root;
+        parent->insertAt(0, _key, _value, leftHigher ? _right.m_root : sibling);
+
+        if (even_out(parent))
+        {
+            if (!leftHigher) {
+                current->branch(0) = _left.m_root; // Took in the sibling.
+            }
+        }
+        else if (leftHigher) {
+            insert_on_path(result, path, position, parent->key(0), parent->value(0), _right.m_root);
+        }
+        else
+        {
+            insert_on_path(result, path, 0, parent->key(0), parent->value(0), sibling);
+            current->branch(0) = _left.m_root; // The insertion or the split at 0 leaves the first branch in place.
+        }
+
+        parent->branch(0) = nullptr;
+        parent->branch(1) = nullptr;
+        destroyObject(m_nodeAllocator, parent);
+        return result;
     }
 
     template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
-    void BTree<_keyType, _ValueType, _Order, _AllocatorType>::copy(node_pointer& _copyRoot, const_node_pointer _originalRoot)
+    void BTree<_keyType, _ValueType, _Order, _AllocatorType>::insert_on_path(subtree& _tree, const node_path_type& _path, btree_order_t _position, const key_type& _key, const_reference _value,
+                                                                      node_pointer _rightBranch)
+    {
+        key_type* key = createObject(m_keyAllocator, _key);
+        pointer value = createObject(m_allocator, _value);
+        node_pointer rightBranch = _rightBranch;
+        btree_order_t position = _position;
+
+        for (size_type level = _path.size(); level > 0; --level)
+        {
+            node_pointer current = _path[level-1].first;
+            if (!current->isFull())
+            {
+                current->insertAt(position, *key, *value, rightBranch);
+                destroyObject(m_keyAllocator, key);
+                destroyObject(m_allocator, value);
+                return;
+            }
+
+            key_type* medianKey = m_keyAllocator.allocate(1);
+            pointer medianValue = m_allocator.allocate(1);
+            node_pointer splitRight = createObject(m_nodeAllocator);
+            current->splitInsertAt(position, *key, *value, rightBranch, medianKey, medianValue, splitRight);
+            destroyObject(m_keyAllocator, key);
+            destroyObject(m_allocator, value);
+
+            key = medianKey;
+            value = medianValue;
+            rightBranch = splitRight;
+            if (level > 1) {
+                position = _path[level-2].second;
+            }
+        }
+
+        // The root split, the median goes up into a new one.
+        node_pointer root = createObject(m_nodeAllocator);
+        root->branch(0) = _tree.m_root;
+        root->insertAt(0, *key, *value, rightBranch);
+        destroyObject(m_keyAllocator, key);
+        destroyObject(m_allocator, value);
+        _tree = subtree(root, _tree.m_height + 1);
+    }
+
+    template<typename _keyType, typename _ValueType, btree_order_t _Order, typename _AllocatorType>
+    void BTree<_keyType, _ValueType, _Order, _AllocatorType>::copy(node_pointer& _copyRoot, const_node_pointer _originalRoot, ThreadPool* _pool, unsigned int _forkDepth)
     {
         if (_originalRoot == nullptr) {
             _copyRoot = nullptr;
         }
+        else if (_pool && _forkDepth && _originalRoot->branch(0) != nullptr)
+        {
+            _copyRoot = createObject(m_nodeAllocator, *_originalRoot);
+
+            unsigned int forkDepth = _forkDepth;
+            for (btree_order_t fanOut = 1; fanOut < _originalRoot->nbKeys() + 1 && forkDepth; fanOut *= 2) {
+                --forkDepth;
+            }
+
+            // The last branch is copied on the calling thread.
+            node_pointer copyRoot = _copyRoot;
+            TaskGroup group(*_pool);
+            for (btree_order_t i = 0; i < _originalRoot->nbKeys(); ++i) {
+                group.run([=]() { copy(copyRoot->branch(i), _originalRoot->branch(i), _pool, forkDepth); });
+            }
+            copy(copyRoot->branch(_originalRoot->nbKeys()), _originalRoot->branch(_originalRoot->nbKeys()), _pool, forkDepth);
+            group.wait();
+        }
         else
         {
             _copyRoot = createObject(m_nodeAllocator, *_originalRoot);
@@ -870,6 +1709,73 @@ namespace glare
             }
         }
     }
+
+    // ---------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    // BTreeAuto follows:
+    // ---------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+    // Node budgets for BTreeAuto. Every level of a descent costs one node worth of memory traffic, so the budget is what we are willing to pay per level.
+    const std::size_t BTREE_NODE_BYTES_CACHE_LINE = GLARE_CACHE_LINE_SIZE;
+    const std::size_t BTREE_NODE_BYTES_256        = 256;
+    const std::size_t BTREE_NODE_BYTES_PAGE       = GLARE_PAGE_SIZE;
+    const std::size_t BTREE_NODE_BYTES_DEFAULT    = BTREE_NODE_BYTES_256;
+
+    // Smallest order the removal code supports, below it MINKEYS drops to 1 and a node can be emptied before it is restored.
+    const btree_order_t BTREE_MIN_ORDER = 5;
+
+    // Pre: _Order is a guess at the order for the node budget.
+    // Post: value is the largest order <= _Order whose BTreeNode fits in _TargetNodeBytes, or BTREE_MIN_ORDER when nothing fits.
+    //       The guess is close, only the padding of the node can push it over the budget, so this recurses at most a couple of times.
+    template<typename _KeyType, typename _ValType, typename _Alloc, std::size_t _TargetNodeBytes, btree_order_t _Order,
+             bool _Fits = (_Order <= BTREE_MIN_ORDER || sizeof(BTreeNode<_KeyType, _ValType, _Order, _Alloc>) <= _TargetNodeBytes)>
+    struct btree_fit_order
+    {
+        static const btree_order_t value = btree_fit_order<_KeyType, _ValType, _Alloc, _TargetNodeBytes, _Order-1>::value;
+    };
+
+    template<typename _KeyType, typename _ValType, typename _Alloc, std::size_t _TargetNodeBytes, btree_order_t _Order>
+    struct btree_fit_order<_KeyType, _ValType, _Alloc, _TargetNodeBytes, _Order, true>
+    {
+        static const btree_order_t value = _Order < BTREE_MIN_ORDER ? BTREE_MIN_ORDER : _Order;
+    };
+
+    // Derives the order of a BTree from sizeof(key_type) and the node layout so that a node fills _TargetNodeBytes.
+    // A node holds the key count, MAXKEYS keys, ORDER branches and a pointer to its value block. The values live in a separate block
+    // which is only touched on a hit, so their size does not change how many keys we can scan per level, it is left out of the budget.
+    template<typename _KeyType, typename _ValType, std::size_t _TargetNodeBytes, typename _Alloc = default_allocator<_ValType> >
+    struct BTreeAutoOrder
+    {
+    private:
+        typedef BTreeNode<_KeyType, _ValType, BTREE_MIN_ORDER, _Alloc> probe_node_type;
+
+        // Bytes which don't depend on the order: the key count, branch 0, the value block pointer and the (empty) allocator.
+        static const std::size_t FIXED_BYTES = sizeof(btree_order_t) + sizeof(probe_node_type*) + sizeof(_ValType*) + sizeof(_Alloc);
+        // Every extra order adds a key and the branch to its right.
+        static const std::size_t BYTES_PER_KEY = sizeof(_KeyType) + sizeof(probe_node_type*);
+        static const std::size_t ESTIMATE = _TargetNodeBytes > FIXED_BYTES ? (_TargetNodeBytes - FIXED_BYTES) / BYTES_PER_KEY + 1 : BTREE_MIN_ORDER;
+
+    public:
+        static const btree_order_t value = btree_fit_order<_KeyType, _ValType, _Alloc, _TargetNodeBytes, static_cast<btree_order_t>(ESTIMATE)>::value;
+    };
+
+    // A BTree whose order is chosen at compile time from the key size and a node budget, e.g.
+    //      BTreeAuto<int, Object>                                      // 256 byte nodes.
+    //      BTreeAuto<int, Object, BTREE_NODE_BYTES_PAGE>               // page sized nodes.
+    template<typename _KeyType, typename _ValType, std::size_t _TargetNodeBytes = BTREE_NODE_BYTES_DEFAULT, typename _Alloc = default_allocator<_ValType> >
+    class BTreeAuto: public BTree<_KeyType, _ValType, BTreeAutoOrder<_KeyType, _ValType, _TargetNodeBytes, _Alloc>::value, _Alloc>
+    {
+    public:
+        static const btree_order_t ORDER = BTreeAutoOrder<_KeyType, _ValType, _TargetNodeBytes, _Alloc>::value;
+        static const std::size_t TARGET_NODE_BYTES = _TargetNodeBytes;
+        static const std::size_t NODE_BYTES = sizeof(BTreeNode<_KeyType, _ValType, ORDER, _Alloc>); // Actual footprint, may be over the target at BTREE_MIN_ORDER.
+
+        typedef BTree<_KeyType, _ValType, ORDER, _Alloc>    base_type;
+
+        // Constructors are not inherited, the copies of the base are forwarded, the parallel one included.
+        BTreeAuto() {}
+        BTreeAuto(const BTreeAuto& _other): base_type(_other) {}
+        BTreeAuto(const BTreeAuto& _other, ThreadPool* _pool): base_type(_other, _pool) {}
+    };
     
 } // namespace
 
@@ -5,6 +5,7 @@
 #include "engine_common.h"
 #include "containers.h"
 #include "BSTNode.h"
+#include "MorrisTraversal.h"
 
 /*
 [TODO] Big fucking possible flaw in the container type. If type T is a pointer.
@@ -56,7 +57,43 @@ namespace glare
         void setPostOrderTraversal() { m_traversalFunc = postorder; }
         void setInOrderTraversal() { m_traversalFunc = inorder; }
 
-        void traverse(process_data_cb pFunc) const { m_traversalFunc(m_pRoot, pFunc); }
+        void traverse(process_data_cb pFunc) const { if (m_pRoot) m_traversalFunc(m_pRoot, pFunc); }
+
+        // Walks with any callable taking (const_reference) and returning bool, false stops the walk. Return false when the visitor
+        // stopped it. Unlike traverse() the visitor inlines, and may carry state through what it captures.
+        template<typename _Func> bool for_each_inorder(_Func _func) const   { return visit_inorder(m_pRoot, _func); }
+        template<typename _Func> bool for_each_preorder(_Func _func) const  { return visit_preorder(m_pRoot, _func); }
+        template<typename _Func> bool for_each_postorder(_Func _func) const { return visit_postorder(m_pRoot, _func); }
+
+        // The in order walk in O(1) extra space, through threads on the free right links (MorrisTraversal.h). Nothing here bounds
+        // the height, so this is the walk for a degenerate tree that would run the recursion out of stack. The links are borrowed
+        // until it returns: no update and no other reader meanwhile.
+        template<typename _Func> bool morris_for_each_inorder(_Func _func)
+        {
+            auto visit = [&_func](node_pointer _node) -> bool { return _func(static_cast<const_reference>(_node->m_data)); };
+            return glare::morris_for_each_inorder(m_pRoot, visit);
+        }
+
+        // In order iterator on the same walk, the tree as above until it is done or destroyed.
+        //      for (CBinarySearchTree<int>::morris_iterator itr(tree); itr.valid(); ++itr) { use(*itr); }
+        class morris_iterator
+        {
+        public:
+            explicit morris_iterator(CBinarySearchTree& _tree): m_walk(_tree.m_pRoot) {}
+
+            bool valid() const { return !m_walk.done(); }
+
+            // Pre: valid(). The value is the key, it can't change.
+            const_reference operator * () const { return m_walk.node()->m_data; }
+            const_pointer operator -> () const { return &(m_walk.node()->m_data); }
+            morris_iterator& operator ++ () { m_walk.advance(); return *this; }
+
+            // Gives the links back before the end, the iterator is then no longer valid().
+            void stop() { m_walk.finish(); }
+
+        private:
+            morris_inorder_walk<node_pointer> m_walk;
+        };
 
     protected:
         // Memory allocation then initialzation and  destruction then deletion.
@@ -89,6 +126,10 @@ namespace glare
         static void postorder(node_pointer pNode, process_data_cb pFunc);
         static void inorder(node_pointer pNode, process_data_cb pFunc);
 
+        template<typename _Func> static bool visit_preorder(const_node_pointer pNode, _Func& _func);
+        template<typename _Func> static bool visit_postorder(const_node_pointer pNode, _Func& _func);
+        template<typename _Func> static bool visit_inorder(const_node_pointer pNode, _Func& _func);
+
         void copy(node_pointer& _copyRoot, const_node_pointer _originalRoot);
         void copyTree(const CBinarySearchTree& _originalRoot);
 
@@ -134,7 +175,7 @@ namespace glare
     inline CBinarySearchTree<T, Alloc>& CBinarySearchTree<T, Alloc>::operator = (const CBinarySearchTree& _originalTree)
     {
         if (this != &_originalTree){
-            clear(m_pRoot)
+            clear();
             copyTree(_originalTree);
         }
         return *this;
@@ -154,11 +195,11 @@ namespace glare
     template<typename T, typename Alloc>
     void CBinarySearchTree<T, Alloc>::cleanUp(node_pointer _ptr)
     {
-        if (_ptr->m_pLeft){
-            cleanUp(_ptr->m_pLeft);
+        if (_ptr->m_left){
+            cleanUp(_ptr->m_left);
         }
-        if (_ptr->m_pRight){
-            cleanUp(_ptr->m_pRight);
+        if (_ptr->m_right){
+            cleanUp(_ptr->m_right);
         }
         destroyNode(_ptr);
     }
@@ -168,11 +209,11 @@ namespace glare
     {
         size_type uCnt = 1;
 
-        if (_ptr->m_pLeft){
-            uCnt += count(_ptr->m_pLeft);
+        if (_ptr->m_left){
+            uCnt += count(_ptr->m_left);
         }
-        if (_ptr->m_pRight){
-            uCnt += count(_ptr->m_pRight);
+        if (_ptr->m_right){
+            uCnt += count(_ptr->m_right);
         }
         return uCnt;
     }
@@ -193,17 +234,17 @@ namespace glare
         if (nodePtr == NULL) // If node was not found then insert it.
         {
             node_pointer newNode = createNode(_item);
-            newNode->m_pLeft = NULL;
-            newNode->m_pRight = NULL;
+            newNode->m_left = NULL;
+            newNode->m_right = NULL;
 
             if (parentPtr == NULL){
                 m_pRoot = newNode;
             }
             else if (_item < parentPtr->m_data){
-                parentPtr->m_pLeft = newNode;
+                parentPtr->m_left = newNode;
             }
             else{
-                parentPtr->m_pRight = newNode;
+                parentPtr->m_right = newNode;
             }
 
             ++m_uSize;
@@ -228,11 +269,11 @@ namespace glare
             if (nodePtr == _refRootPtr){ // Equivalent of (parentPtr == NULL) but more general, in case _refRootPtr != m_pRoot.
                 deleteNode(_refRootPtr);
             }
-            else if(parentPtr->m_pLeft == nodePtr){  // Doing this to forward the real tree node pointer not the copy of the pointer variable.
-                deleteNode(parentPtr->m_pLeft);
+            else if(parentPtr->m_left == nodePtr){  // Doing this to forward the real tree node pointer not the copy of the pointer variable.
+                deleteNode(parentPtr->m_left);
             }
             else{
-                deleteNode(parentPtr->m_pRight);
+                deleteNode(parentPtr->m_right);
             }
         }
     }
@@ -252,15 +293,15 @@ namespace glare
     void CBinarySearchTree<T, Alloc>::deleteNode(node_pointer& _refNodePtr)
 //------------------------------------------------------------------------------------
     {
-        if (_refNodePtr->m_pLeft == NULL){
+        if (_refNodePtr->m_left == NULL){
             node_pointer temp = _refNodePtr;
-            _refNodePtr = _refNodePtr->m_pRight;
+            _refNodePtr = _refNodePtr->m_right;
             destroyNode(temp);
             --m_uSize;
         }
-        else if(_refNodePtr->m_pRight == NULL){
+        else if(_refNodePtr->m_right == NULL){
             node_pointer temp = _refNodePtr;
-            _refNodePtr = _refNodePtr->m_pLeft;
+            _refNodePtr = _refNodePtr->m_left;
             destroyNode(temp);
             --m_uSize;
         }
@@ -271,11 +312,11 @@ namespace glare
             _refNodePtr->m_data = pPredecessor->m_data;
 
             // Delete the predecessor. This is where we take advantage through recursion of the above mentioned point.
-            if (pParentPred->m_pLeft == pPredecessor){
-                deleteNode(pParentPred->m_pLeft);
+            if (pParentPred->m_left == pPredecessor){
+                deleteNode(pParentPred->m_left);
             }
             else{
-                deleteNode(pParentPred->m_pRight);
+                deleteNode(pParentPred->m_right);
             }
             
         }
@@ -284,28 +325,28 @@ namespace glare
     template<typename T, typename Alloc>
     inline void CBinarySearchTree<T, Alloc>::findLogicalPredecessor(node_pointer _pNode, node_pointer& _outPredPtr, node_pointer& _outParentPtr) const
     {
-        _outPredPtr = _pNode->m_pLeft,   // Subtree.
+        _outPredPtr = _pNode->m_left,   // Subtree.
         _outParentPtr = _pNode;          // Parent of subtree.
 
         // Right most node in the subtree, with the largest value.
-        while(_outPredPtr->m_pRight != NULL)
+        while(_outPredPtr->m_right != NULL)
         {
             _outParentPtr = _outPredPtr;
-            _outPredPtr = _outPredPtr->m_pRight;
+            _outPredPtr = _outPredPtr->m_right;
         }
     }
 
     template<typename T, typename Alloc>
-    inline void CBinarySearchTree<T, Alloc>::findLogicalSuccessor(node_pointer _pTree, node_pointer& _outPtr, node_pointer& _outParentPtr) const
+    inline void CBinarySearchTree<T, Alloc>::findLogicalSuccessor(node_pointer _pNode, node_pointer& _outPtr, node_pointer& _outParentPtr) const
     {
-        _outPtr = _pNode->m_pRight,   // Subtree.
+        _outPtr = _pNode->m_right,   // Subtree.
         _outParentPtr = _pNode;          // Parent of subtree.
 
         // Left most node of the subtree, with the smallest value.
-        while(_outPtr->m_pLeft != NULL)
+        while(_outPtr->m_left != NULL)
         {
             _outParentPtr = _outPtr;
-            _outPtr = _outPtr->m_pLeft;
+            _outPtr = _outPtr->m_left;
         }
     }
 
@@ -319,7 +360,7 @@ namespace glare
         if(nodePtr)
         {
             bResult = true;
-            _obj = ptr->m_data;
+            _obj = nodePtr->m_data;
         }
         return bResult;
     }
@@ -343,22 +384,22 @@ namespace glare
     void CBinarySearchTree<T, Alloc>::preorder(node_pointer pNode, process_data_cb pFunc)
     {
         pFunc(pNode->m_data);
-        if (pNode->m_pLeft){
-            preorder(pNode->m_pLeft, pFunc);
+        if (pNode->m_left){
+            preorder(pNode->m_left, pFunc);
         }
-        if (pNode->m_pRight){
-            preorder(pNode->m_pRight, pFunc);
+        if (pNode->m_right){
+            preorder(pNode->m_right, pFunc);
         }
     }
 
     template<typename T, typename Alloc>
     void CBinarySearchTree<T, Alloc>::postorder(node_pointer pNode, process_data_cb pFunc)
     {
-        if (pNode->m_pLeft){
-            postorder(pNode->m_pLeft, pFunc);
+        if (pNode->m_left){
+            postorder(pNode->m_left, pFunc);
         }
-        if (pNode->m_pRight){
-            postorder(pNode->m_pRight, pFunc);
+        if (pNode->m_right){
+            postorder(pNode->m_right, pFunc);
         }
         pFunc(pNode->m_data);
     }
@@ -366,21 +407,52 @@ namespace glare
     template<typename T, typename Alloc>
     void CBinarySearchTree<T, Alloc>::inorder(node_pointer pNode, process_data_cb pFunc)
     {
-        if (pNode->m_pLeft){
-            inorder(pNode->m_pLeft, pFunc);
+        if (pNode->m_left){
+            inorder(pNode->m_left, pFunc);
         }
 
         pFunc(pNode->m_data);
 
-        if (pNode->m_pRight){
-            inorder(pNode->m_pRight, pFunc);
+        if (pNode->m_right){
+            inorder(pNode->m_right, pFunc);
+        }
+    }
+
+    template<typename T, typename Alloc>
+    template<typename _Func>
+    bool CBinarySearchTree<T, Alloc>::visit_preorder(const_node_pointer pNode, _Func& _func)
+    {
+        if (pNode == NULL){
+            return true;
+        }
+        return _func(pNode->m_data) && visit_preorder(pNode->m_left, _func) && visit_preorder(pNode->m_right, _func);
+    }
+
+    template<typename T, typename Alloc>
+    template<typename _Func>
+    bool CBinarySearchTree<T, Alloc>::visit_postorder(const_node_pointer pNode, _Func& _func)
+    {
+        if (pNode == NULL){
+            return true;
+        }
+        return visit_postorder(pNode->m_left, _func) && visit_postorder(pNode->m_right, _func) && _func(pNode->m_data);
+    }
+
+    template<typename T, typename Alloc>
+    template<typename _Func>
+    bool CBinarySearchTree<T, Alloc>::visit_inorder(const_node_pointer pNode, _Func& _func)
+    {
+        if (pNode == NULL){
+            return true;
         }
+        return visit_inorder(pNode->m_left, _func) && _func(pNode->m_data) && visit_inorder(pNode->m_right, _func);
     }
 
     template<typename T, typename Alloc>
     inline void CBinarySearchTree<T, Alloc>::copyTree(const CBinarySearchTree& _originalRoot)
     {
-        copy(m_pRoot, _originalRoot->m_pRoot);
+        copy(m_pRoot, _originalRoot.m_pRoot);
+        m_uSize = _originalRoot.m_uSize;
     }
     
     template<typename T, typename Alloc>
@@ -392,8 +464,8 @@ namespace glare
         else
         {
             _copy = createNode(_originalTree->m_data);
-            copy(_copy->m_pLeft, _originalTree->m_pLeft);
-            copy(_copy->m_pRight, _originalTree->m_pRight);
+            copy(_copy->m_left, _originalTree->m_left);
+            copy(_copy->m_right, _originalTree->m_right);
         }
     }
 
@@ -408,12 +480,12 @@ namespace glare
             if (_item < _nodePtr->m_data)
             {
                 _parentPtr = _nodePtr;
-                _nodePtr = _nodePtr->m_pLeft;
+                _nodePtr = _nodePtr->m_left;
             }
             else if (_item > _nodePtr->m_data)
             {
                 _parentPtr = _nodePtr;
-                _nodePtr = _nodePtr->m_pRight;
+                _nodePtr = _nodePtr->m_right;
             }
             else{
                 return; // Found it!
@@ -51,18 +51,31 @@ namespace glare
         pointer get(const key_type& _key) const;
         bool get(const key_type& _key, reference _data);
 
-        void setPreOrderTraversal() { m_traversalFunc = GTreeNode::preorder; }
-        void setPostOrderTraversal() { m_traversalFunc = GTreeNode::postorder; }
-        void setInOrderTraversal() { m_traversalFunc = GTreeNode::inorder; }
+        void setPreOrderTraversal() { m_traversalFunc = preorder; }
+        void setPostOrderTraversal() { m_traversalFunc = postorder; }
+        void setInOrderTraversal() { m_traversalFunc = inorder; }
 
         void traverse(process_data_cb pFunc) const { m_traversalFunc(m_pRoot, pFunc); }
 
+        // Walks with any callable taking (const_reference) and returning bool, false stops the walk. Return false when the visitor
+        // stopped it. Unlike traverse() the visitor inlines, and may carry state through what it captures.
+        template<typename _Func> bool for_each_inorder(_Func _func) const   { return visit_inorder(0, _func); }
+        template<typename _Func> bool for_each_preorder(_Func _func) const  { return visit_preorder(0, _func); }
+        template<typename _Func> bool for_each_postorder(_Func _func) const { return visit_postorder(0, _func); }
+
     protected:
 
         static void preorder(index_type _index, process_data_cb _pFunc);
         static void postorder(index_type _index, process_data_cb _pFunc);
         static void inorder(index_type _index, process_data_cb _pFunc);
 
+        // An index past the capacity or on an invalidated node ends the branch.
+        bool isVisitable(index_type _index) const { return (_index < m_uCapacity && m_pRoot[_index].isValid()); }
+
+        template<typename _Func> bool visit_preorder(index_type _index, _Func& _func) const;
+        template<typename _Func> bool visit_postorder(index_type _index, _Func& _func) const;
+        template<typename _Func> bool visit_inorder(index_type _index, _Func& _func) const;
+
         node_type& getNode(index_type _index) { return m_pRoot[_index]; }
         bool isIndexValid(index_type _index) { return _index < m_uCapacity; }
         bool isNodeValid(index_type _index) { return (isIndexValid(_index) && getNode(_index).isValid()); }
@@ -345,6 +358,41 @@ namespace glare
         }
     }
 
+    template<typename _ValTy, typename _KeyTy, typename _Alloc>
+    template<typename _Func>
+    bool CBinarySearchTreeArray<_ValTy, _KeyTy, _Alloc>::visit_preorder(index_type _index, _Func& _func) const
+    {
+        if (!isVisitable(_index)){
+            return true;
+        }
+        return _func(m_pRoot[_index].m_data.second)
+            && visit_preorder(getLeftChildIndex(_index), _func)
+            && visit_preorder(getRightChildIndex(_index), _func);
+    }
+
+    template<typename _ValTy, typename _KeyTy, typename _Alloc>
+    template<typename _Func>
+    bool CBinarySearchTreeArray<_ValTy, _KeyTy, _Alloc>::visit_postorder(index_type _index, _Func& _func) const
+    {
+        if (!isVisitable(_index)){
+            return true;
+        }
+        return visit_postorder(getLeftChildIndex(_index), _func)
+            && visit_postorder(getRightChildIndex(_index), _func)
+            && _func(m_pRoot[_index].m_data.second);
+    }
+
+    template<typename _ValTy, typename _KeyTy, typename _Alloc>
+    template<typename _Func>
+    bool CBinarySearchTreeArray<_ValTy, _KeyTy, _Alloc>::visit_inorder(index_type _index, _Func& _func) const
+    {
+        if (!isVisitable(_index)){
+            return true;
+        }
+        return visit_inorder(getLeftChildIndex(_index), _func)
+            && _func(m_pRoot[_index].m_data.second)
+            && visit_inorder(getRightChildIndex(_index), _func);
+    }
 
 } // End of namespace
 #endif
@@ -47,6 +47,11 @@ namespace glare
             traversalFunc(*itr, pFunc);
         }
 
+        // Walks from the root with any callable taking (value_type&) and returning bool, false stops the walk. Return false when
+        // the visitor stopped it. Unlike traverse() the visitor inlines, and may carry state through what it captures.
+        template<typename _Func> bool for_each_preorder(_Func _func)  { return m_root ? visit_preorder(m_root, _func) : true; }
+        template<typename _Func> bool for_each_postorder(_Func _func) { return m_root ? visit_postorder(m_root, _func) : true; }
+
         void            addRoot(const_reference ref);
         void            addChild(iterator itr, const_reference ref);
 
@@ -71,12 +76,43 @@ namespace glare
             node_pointer_list::iterator itr = pNode->m_children.begin();
             while(itr != pNode->m_children.end())
             {
-                preorder(*itr, pFunc);
+                postorder(*itr, pFunc);
                 ++itr;
             }
             pFunc(pNode->m_data);
         }
 
+        template<typename _Func>
+        static bool visit_preorder(node_pointer pNode, _Func& _func)
+        {
+            if (!_func(pNode->m_data))
+            {
+                return false;
+            }
+            typename node_pointer_list::iterator itr = pNode->m_children.begin();
+            for (; itr != pNode->m_children.end(); ++itr)
+            {
+                if (!visit_preorder(*itr, _func))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        template<typename _Func>
+        static bool visit_postorder(node_pointer pNode, _Func& _func)
+        {
+            typename node_pointer_list::iterator itr = pNode->m_children.begin();
+            for (; itr != pNode->m_children.end(); ++itr)
+            {
+                if (!visit_postorder(*itr, _func))
+                {
+                    return false;
+                }
+            }
+            return _func(pNode->m_data);
+        }
+
         struct GTreeNode
         {
             GTreeNode(const_reference ref) : m_data(ref), m_parent(nullptr) {}
@@ -46,6 +46,36 @@
 #endif // GLARE_FINAL
 // No Inline --------------------------------------------------------------------------------------
 
+// Memory Layout ----------------------------------------------------------------------------------
+#ifndef GLARE_CACHE_LINE_SIZE
+    #define GLARE_CACHE_LINE_SIZE   64
+#endif
+
+#ifndef GLARE_PAGE_SIZE
+    #define GLARE_PAGE_SIZE         4096
+#endif
+
+// Compiler intrinsics, both MSVC and GCC have them.
+#if defined(__GNUG__)
+    #define GLARE_ALIGNOF(_TYPE)                    __alignof__(_TYPE)
+#else
+    #define GLARE_ALIGNOF(_TYPE)                    __alignof(_TYPE)
+#endif
+#define GLARE_HAS_TRIVIAL_DESTRUCTOR(_TYPE)         __has_trivial_destructor(_TYPE)
+#define GLARE_IS_POD(_TYPE)                         __is_pod(_TYPE)
+// Memory Layout ----------------------------------------------------------------------------------
+
+// Prefetch ---------------------------------------------------------------------------------------
+#if defined(WIN32)
+    #include <xmmintrin.h>
+    #define GLARE_PREFETCH(_ADDR)   _mm_prefetch(reinterpret_cast<const char*>(_ADDR), _MM_HINT_T0)
+#elif defined(__GNUG__)
+    #define GLARE_PREFETCH(_ADDR)   __builtin_prefetch(_ADDR)
+#else
+    #define GLARE_PREFETCH(_ADDR)
+#endif
+// Prefetch ---------------------------------------------------------------------------------------
+
 #define GLARE_PAIR                  std::pair
 #define GLARE_VECTOR                std::vector
 //#define GLARE_LOG(_str, ...)        std::printf(_str##"\n")
@@ -54,6 +84,19 @@
 
 namespace glare
 {
+    // Pre: _address is valid or nullptr; prefetching an invalid address is harmless but wasted.
+    // Post: A prefetch is issued for _lines cache lines starting with the one holding _address.
+    inline void prefetch_lines(const void* _address, unsigned int _lines)
+    {
+        const char* line = static_cast<const char*>(_address);
+        for (unsigned int i = 0; i < _lines; ++i, line += GLARE_CACHE_LINE_SIZE) {
+            GLARE_PREFETCH(line);
+        }
+    }
+
+    // Selects the constructors taking a range already sorted by key, which build the container in O(n).
+    struct sorted_tag {};
+
     // Courtesy of std::xfunctional //////////////////////////////////////
     // base class for unary functions
     template<class _Arg, class _Result>
@@ -0,0 +1,367 @@
+#ifndef GLARE_INTRUSIVE_RB_TREE_H
+#define GLARE_INTRUSIVE_RB_TREE_H
+
+#include "RbTree.h"
+
+// An intrusive Red-Black tree keeps the links and the color in a hook that is a member of the stored objects, so the tree never allocates
+// and never copies the objects; it only links the objects it is given, which stay owned by whoever allocated them (a pool, typically).
+//
+//      struct Entity
+//      {
+//          int         m_id;
+//          RbTreeHook  m_byId;
+//      };
+//      IntrusiveRbTree<Entity, &Entity::m_byId, EntityId> entities;    // EntityId extracts m_id.
+//
+// An object can be in as many trees as it has hooks, but only in one tree per hook. It must be erased before it is destroyed or moved.
+
+namespace glare
+{
+    // The links of an object in an IntrusiveRbTree. Same interface as the links of an RbTreeNode, so rb_tree_algorithms
+    // balances both. Copying an object does not copy its hook, the copy is not in any tree.
+    class RbTreeHook
+    {
+    public:
+        typedef RbTreeHook                          selftype;
+        typedef selftype*                           node_pointer;
+        typedef const selftype*                     const_node_pointer;
+
+        enum Color { Black, Red };
+
+        RbTreeHook(): m_left(nullptr), m_right(nullptr), m_parent(nullptr), m_color(Red) {}
+        RbTreeHook(const RbTreeHook&): m_left(nullptr), m_right(nullptr), m_parent(nullptr), m_color(Red) {}
+        RbTreeHook& operator= (const RbTreeHook&) { return *this; } // The links belong to the tree, keep them.
+
+        node_pointer        left() { return m_left; }
+        node_pointer        right() { return m_right; }
+        node_pointer        parent() { return m_parent; }
+
+        const_node_pointer  left() const { return m_left; }
+        const_node_pointer  right() const { return m_right; }
+        const_node_pointer  parent() const { return m_parent; }
+
+        void                left(node_pointer _node) { m_left = _node; }
+        void                right(node_pointer _node) { m_right = _node; }
+        void                parent(node_pointer _node) { m_parent = _node; }
+
+        Color color() const     { return m_color; }
+        void  color(Color _col) { m_color = _col; }
+        bool  isBlack() const   { return m_color == Black; }
+        bool  isRed() const     { return m_color == Red; }
+
+        void reset()
+        {
+            m_left = m_right = m_parent = nullptr;
+            m_color = Red;
+        }
+
+    private:
+        node_pointer m_left;
+        node_pointer m_right;
+        node_pointer m_parent;
+        Color m_color;
+    };
+
+    // Default key of an IntrusiveRbTree, the object itself.
+    template<typename T>
+    struct rb_identity_key
+    {
+        typedef T key_type;
+        const key_type& operator() (const T& _object) const { return _object; }
+    };
+
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    // Follows the tree implementation:
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+    template<typename T, RbTreeHook T::* _Hook, typename _KeyOf = rb_identity_key<T>, typename _Pred = less<typename _KeyOf::key_type> >
+    class IntrusiveRbTree
+    {
+        typedef RbTreeHook                                      node_type;
+        typedef node_type*                                      node_pointer;
+        typedef const node_type*                                const_node_pointer;
+        typedef rb_tree_algorithms<node_type>                   algorithms;
+
+    public:
+        typedef typename _KeyOf::key_type                       key_type;
+        typedef _KeyOf                                          key_of;
+        typedef _Pred                                           key_compare; // binary predicate.
+
+        typedef T                                               value_type;
+        typedef value_type*                                     pointer;
+        typedef const value_type*                               const_pointer;
+        typedef value_type&                                     reference;
+        typedef const value_type&                               const_reference;
+        typedef std::size_t                                     size_type;
+        typedef std::ptrdiff_t                                  difference_type;
+
+        class iterator: public std::iterator<std::bidirectional_iterator_tag, value_type>
+        {
+            friend class IntrusiveRbTree;
+
+        public:
+            iterator(): m_nodePtr(nullptr) {}
+
+            reference operator*() const
+            {
+                GLARE_ASSERT(m_nodePtr != nullptr, "Can't be nullptr");
+                return *IntrusiveRbTree::to_object(m_nodePtr);
+            }
+            pointer operator->() const
+            {
+                GLARE_ASSERT(m_nodePtr != nullptr, "Can't be nullptr");
+                return IntrusiveRbTree::to_object(m_nodePtr);
+            }
+            iterator& operator++()
+            {
+                if (m_nodePtr != nullptr)
+                    m_nodePtr = algorithms::successor(m_nodePtr);
+                return *this;
+            }
+            iterator operator++(int)
+            {
+                iterator temp = *this;
+                ++(*this);
+                return temp;
+            }
+            iterator& operator--()
+            {
+                if (m_nodePtr != nullptr)
+                    m_nodePtr = algorithms::predecessor(m_nodePtr);
+                return *this;
+            }
+            iterator operator--(int)
+            {
+                iterator temp = *this;
+                --(*this);
+                return temp;
+            }
+            bool operator==(const iterator& _right) const { return m_nodePtr == _right.m_nodePtr; }
+            bool operator!=(const iterator& _right) const { return m_nodePtr != _right.m_nodePtr; }
+
+        private:
+            explicit iterator(node_pointer _ptr): m_nodePtr(_ptr) {}
+
+            node_pointer m_nodePtr;
+        };
+
+        IntrusiveRbTree();
+        ~IntrusiveRbTree();
+
+        // Pre: _object is not in a tree through _Hook.
+        // Post: _object is linked in, no allocation and no copy. When the key is already there, the object holding it is returned with false.
+        GLARE_PAIR<iterator, bool> insert(reference _object);
+
+        // Pre: _object is in this tree.
+        // Post: _object is unlinked, its hook is reset. No search, only the rebalancing.
+        void erase(reference _object);
+
+        // Post: The object holding _key is unlinked and returned, nullptr when there is none.
+        pointer erase(const key_type& _key);
+
+        bool exists(const key_type& _key) const { return bst_find(_key) != nullptr; }
+        pointer find(const key_type& _key) { node_pointer nodePtr = bst_find(_key); return nodePtr ? to_object(nodePtr) : nullptr; }
+        const_pointer find(const key_type& _key) const { node_pointer nodePtr = bst_find(_key); return nodePtr ? to_object(nodePtr) : nullptr; }
+
+        // Post: Every object is unlinked, none is destroyed.
+        void clear();
+
+        size_type size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        void swap(IntrusiveRbTree& _tree);
+
+        // Single pass over the hooks, m_bytes is what the hooks add to the objects.
+        TreeStats stats() const;
+
+        iterator begin() const { return iterator(m_leftmost); }
+        iterator end() const { return iterator(nullptr); }
+
+    private:
+        // The objects aren't ours to copy.
+        IntrusiveRbTree(const IntrusiveRbTree&);
+        IntrusiveRbTree& operator= (const IntrusiveRbTree&);
+
+        node_pointer bst_find(const key_type& _key) const;
+
+        static node_pointer to_hook(reference _object) { return &(_object.*_Hook); }
+        static pointer to_object(node_pointer _hook)
+        {
+            return reinterpret_cast<pointer>(reinterpret_cast<char*>(_hook) - hook_offset());
+        }
+        static std::size_t hook_offset()
+        {
+            // offsetof for a member pointer, on a dummy address rather than 0 so nothing looks like a null dereference.
+            const std::size_t dummy = 0x1000;
+            return reinterpret_cast<std::size_t>(&(reinterpret_cast<pointer>(dummy)->*_Hook)) - dummy;
+        }
+        const key_type& key(node_pointer _hook) const { return m_keyOf(*to_object(_hook)); }
+
+        size_type       m_size;
+        node_pointer    m_root;
+        node_pointer    m_leftmost;
+        node_pointer    m_rightmost;
+        key_of          m_keyOf;
+        key_compare     m_binPredicate;
+    };
+
+    template<typename T, RbTreeHook T::* _Hook, typename _KeyOf, typename _Pred>
+    IntrusiveRbTree<T, _Hook, _KeyOf, _Pred>::IntrusiveRbTree(): m_size(0)
+                                                               , m_root(nullptr)
+                                                               , m_leftmost(nullptr)
+                                                               , m_rightmost(nullptr)
+    {
+    }
+
+    template<typename T, RbTreeHook T::* _Hook, typename _KeyOf, typename _Pred>
+    IntrusiveRbTree<T, _Hook, _KeyOf, _Pred>::~IntrusiveRbTree()
+    {
+        clear();
+    }
+
+    template<typename T, RbTreeHook T::* _Hook, typename _KeyOf, typename _Pred>
+    GLARE_PAIR<typename IntrusiveRbTree<T, _Hook, _KeyOf, _Pred>::iterator, bool> IntrusiveRbTree<T, _Hook, _KeyOf, _Pred>::insert(reference _object)
+    {
+        const key_type& newKey = m_keyOf(_object);
+        node_pointer parentPtr = nullptr, currentPtr = m_root;
+        bool linkLeft = false;
+
+        while(currentPtr != nullptr)
+        {
+            parentPtr = currentPtr;
+            if (m_binPredicate(newKey, key(currentPtr)))
+            {
+                currentPtr = currentPtr->left();
+                linkLeft = true;
+            }
+            else if (newKey == key(currentPtr))
+            {
+                return GLARE_PAIR<iterator, bool>(iterator(currentPtr), false); // Duplicate!
+            }
+            else
+            {
+                currentPtr = currentPtr->right();
+                linkLeft = false;
+            }
+        }
+
+        node_pointer newNodePtr = to_hook(_object);
+        algorithms::rb_link(m_root, m_leftmost, m_rightmost, parentPtr, linkLeft, newNodePtr);
+        ++m_size;
+
+        return GLARE_PAIR<iterator, bool>(iterator(newNodePtr), true);
+    }
+
+    template<typename T, RbTreeHook T::* _Hook, typename _KeyOf, typename _Pred>
+    void IntrusiveRbTree<T, _Hook, _KeyOf, _Pred>::erase(reference _object)
+    {
+        node_pointer nodePtr = to_hook(_object);
+        GLARE_ASSERT(nodePtr == m_root || nodePtr->parent() != nullptr, "The object is not in the tree");
+
+        algorithms::rb_remove(m_root, m_leftmost, m_rightmost, nodePtr);
+        nodePtr->reset();
+        --m_size;
+    }
+
+    template<typename T, RbTreeHook T::* _Hook, typename _KeyOf, typename _Pred>
+    typename IntrusiveRbTree<T, _Hook, _KeyOf, _Pred>::pointer IntrusiveRbTree<T, _Hook, _KeyOf, _Pred>::erase(const key_type& _key)
+    {
+        if (node_pointer nodePtr = bst_find(_key))
+        {
+            pointer object = to_object(nodePtr);
+            erase(*object);
+            return object;
+        }
+        return nullptr;
+    }
+
+    template<typename T, RbTreeHook T::* _Hook, typename _KeyOf, typename _Pred>
+    typename IntrusiveRbTree<T, _Hook, _KeyOf, _Pred>::node_pointer IntrusiveRbTree<T, _Hook, _KeyOf, _Pred>::bst_find(const key_type& _key) const
+    {
+        node_pointer currentPtr = m_root;
+
+        while(currentPtr != nullptr)
+        {
+            if (m_binPredicate(_key, key(currentPtr)))
+                currentPtr = currentPtr->left();
+            else if (_key == key(currentPtr))
+                break; // Found!
+            else
+                currentPtr = currentPtr->right();
+        }
+
+        return currentPtr;
+    }
+
+    template<typename T, RbTreeHook T::* _Hook, typename _KeyOf, typename _Pred>
+    void IntrusiveRbTree<T, _Hook, _KeyOf, _Pred>::clear()
+    {
+        // Unlink bottom up without recursion: descend to a leaf, detach it from its parent, reset it, carry on from the parent.
+        node_pointer currentPtr = m_root;
+        while (currentPtr != nullptr)
+        {
+            if (currentPtr->left())
+                currentPtr = currentPtr->left();
+            else if (currentPtr->right())
+                currentPtr = currentPtr->right();
+            else
+            {
+                node_pointer parentPtr = currentPtr->parent();
+                if (parentPtr)
+                {
+                    if (parentPtr->left() == currentPtr)
+                        parentPtr->left(nullptr);
+                    else
+                        parentPtr->right(nullptr);
+                }
+                currentPtr->reset();
+                currentPtr = parentPtr;
+            }
+        }
+
+        m_root = nullptr;
+        m_leftmost = nullptr;
+        m_rightmost = nullptr;
+        m_size = 0;
+    }
+
+    template<typename T, RbTreeHook T::* _Hook, typename _KeyOf, typename _Pred>
+    void IntrusiveRbTree<T, _Hook, _KeyOf, _Pred>::swap(IntrusiveRbTree& _tree)
+    {
+        if (this != &_tree)
+        {
+            std::swap(m_size, _tree.m_size);
+            std::swap(m_root, _tree.m_root);
+            std::swap(m_leftmost, _tree.m_leftmost);
+            std::swap(m_rightmost, _tree.m_rightmost);
+            std::swap(m_keyOf, _tree.m_keyOf);
+            std::swap(m_binPredicate, _tree.m_binPredicate);
+        }
+    }
+
+    template<typename T, RbTreeHook T::* _Hook, typename _KeyOf, typename _Pred>
+    TreeStats IntrusiveRbTree<T, _Hook, _KeyOf, _Pred>::stats() const
+    {
+        TreeStats result;
+        binary_tree_stats(static_cast<const_node_pointer>(m_root), result);
+        result.m_size = m_size;
+        result.m_bytes = result.m_nodeCount * sizeof(node_type);
+
+        for (const_node_pointer current = m_root; current != nullptr; current = current->left())
+        {
+            if (current->isBlack()) {
+                ++result.m_blackHeight;
+            }
+        }
+        return result;
+    }
+
+    template<typename T, RbTreeHook T::* _Hook, typename _KeyOf, typename _Pred>
+    void swap(IntrusiveRbTree<T, _Hook, _KeyOf, _Pred>& _left, IntrusiveRbTree<T, _Hook, _KeyOf, _Pred>& _right)
+    {
+        _left.swap(_right);
+    }
+
+} // namespace
+
+#endif // GLARE_INTRUSIVE_RB_TREE_H
@@ -0,0 +1,114 @@
+#ifndef GLARE_MORRIS_TRAVERSAL_H
+#define GLARE_MORRIS_TRAVERSAL_H
+
+#include "GlareCoreUtility.h"
+
+// In order walks of the binary trees without parent pointers (AvlTree, CBinarySearchTree) in O(1) extra space, no stack and no
+// recursion. Before going down into the left subtree of a node the walk threads it: the right link of the node's predecessor, the
+// rightmost node of that subtree and a nullptr until then, is pointed back at the node. Coming back up through the thread removes it.
+// Each edge is followed at most three times, so a full walk is O(n).
+//
+// The links are borrowed while a walk is under way. The tree must not change and must not be read by anyone else meanwhile, not
+// even through another walk. Every link is back in place once the walk reached the end or was finished.
+
+namespace glare
+{
+    namespace morris_detail
+    {
+        // Pre: _current is where the walk resumes, nullptr when it is over.
+        // Post: Returns the next node in order, nullptr past the last, and _current where the walk resumes after it.
+        template<typename _NodePointer>
+        inline _NodePointer next(_NodePointer& _current)
+        {
+            while (_current != nullptr)
+            {
+                _NodePointer node = _current;
+                if (node->m_left == nullptr)
+                {
+                    _current = node->m_right;
+                    return node;
+                }
+
+                _NodePointer predecessor = node->m_left;
+                while (predecessor->m_right != nullptr && predecessor->m_right != node) {
+                    predecessor = predecessor->m_right;
+                }
+
+                if (predecessor->m_right == nullptr)
+                {// Thread it, the left subtree comes first.
+                    predecessor->m_right = node;
+                    _current = node->m_left;
+                }
+                else
+                {// Back up through the thread, the left subtree is done.
+                    predecessor->m_right = nullptr;
+                    _current = node->m_right;
+                    return node;
+                }
+            }
+            return nullptr;
+        }
+
+        // Post: Runs the walk to the end without visiting, every link is back in place.
+        template<typename _NodePointer>
+        inline void finish(_NodePointer& _current)
+        {
+            while (next(_current) != nullptr) {}
+        }
+    }
+
+    // Pre: _func takes a node pointer and returns bool, false stops the walk.
+    // Post: Returns false when _func stopped it. The links are restored either way, stopping early costs the rest of the walk
+    //       without the visits.
+    template<typename _NodePointer, typename _Func>
+    bool morris_for_each_inorder(_NodePointer _root, _Func& _func)
+    {
+        _NodePointer current = _root;
+        for (_NodePointer node = morris_detail::next(current); node != nullptr; node = morris_detail::next(current))
+        {
+            if (!_func(node))
+            {
+                morris_detail::finish(current);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Step by step form of the walk, for the trees' in order iterators. Not copyable, two copies would take the same threads down.
+    // The destructor finishes the walk when it was left before the end.
+    template<typename _NodePointer>
+    class morris_inorder_walk
+    {
+    public:
+        explicit morris_inorder_walk(_NodePointer _root): m_current(_root)
+                                                        , m_node(nullptr)
+        {
+            advance();
+        }
+
+        ~morris_inorder_walk() { finish(); }
+
+        bool done() const { return (m_node == nullptr); }
+        _NodePointer node() const { return m_node; }
+
+        // Pre: !done().
+        void advance() { m_node = morris_detail::next(m_current); }
+
+        void finish()
+        {
+            morris_detail::finish(m_current);
+            m_node = nullptr;
+        }
+
+    private:
+        morris_inorder_walk(const morris_inorder_walk&);
+        morris_inorder_walk& operator = (const morris_inorder_walk&);
+
+        _NodePointer m_current; // Where the walk resumes.
+        _NodePointer m_node;    // The node it is on, nullptr once done.
+    };
+
+} // namespace glare
+
+#endif
@@ -0,0 +1,668 @@
+#ifndef GLARE_PERSISTENT_RB_TREE_H
+#define GLARE_PERSISTENT_RB_TREE_H
+
+#include "GlareCoreUtility.h"
+#include "TreeStats.h"
+#include "memory\allocators.h"
+#include <atomic>
+#include <iterator>
+
+// A persistent Red-Black tree: a tree is an immutable version, insert and erase leave it alone and return a new version that copies
+// the O(log n) nodes on the path to the key and shares every other node with the old one. Copying a version is O(1), so publishing one
+// to readers costs the update and nothing more, where RedBlackTree would need an O(n) deep copy for a snapshot.
+//
+//      PersistentRbTree<int, Config> current;
+//      PersistentRbTree<int, Config> next = current.insert(7, config).erase(3);    // current is unchanged.
+//
+// Nodes are reference counted, atomically, and freed with the last version that reaches them, on whichever thread drops it; the
+// allocator must therefore be stateless. Versions can be read from any number of threads, but a variable holding one is not atomic:
+// swap in a new version under the lock readers take to copy it. The nodes have no parent links, a version's iterators keep a stack.
+//
+// The balancing is the functional one of Okasaki (insertion) and Kahrs (deletion): rebuild the path bottom up, rebalancing with the
+// four red-red patterns on the way.
+
+namespace glare
+{
+    template<typename KeyType, typename ValueType>
+    class PersistentRbTreeNode
+    {
+    public:
+        typedef PersistentRbTreeNode<KeyType, ValueType>    selftype;
+        typedef selftype*                                   node_pointer;
+        typedef const selftype*                             const_node_pointer;
+        typedef GLARE_PAIR<KeyType, ValueType>              value_type;
+
+        enum Color { Black, Red };
+
+        // Pre: The caller holds a reference to _left and _right, the node takes one more.
+        PersistentRbTreeNode(Color _color, const_node_pointer _left, const value_type& _pair, const_node_pointer _right): m_left(_left)
+                                                                                                                          , m_right(_right)
+                                                                                                                          , m_color(_color)
+                                                                                                                          , m_pair(_pair)
+                                                                                                                          , m_references(0)
+        {
+            if (m_left)
+                m_left->acquire();
+            if (m_right)
+                m_right->acquire();
+        }
+
+        const KeyType&      key() const { return m_pair.first; }
+        const ValueType&    value() const { return m_pair.second; }
+        const value_type&   getData() const { return m_pair; }
+
+        const_node_pointer  left() const { return m_left; }
+        const_node_pointer  right() const { return m_right; }
+
+        Color color() const     { return m_color; }
+        bool  isBlack() const   { return m_color == Black; }
+        bool  isRed() const     { return m_color == Red; }
+
+        void acquire() const { ++m_references; }
+
+        // Post: True when that was the last reference, the node is then the caller's to free.
+        bool release() const { return --m_references == 0; }
+
+    private:
+        const_node_pointer                  m_left;
+        const_node_pointer                  m_right;
+        Color                               m_color;
+        value_type                          m_pair;
+        mutable std::atomic<std::size_t>    m_references;
+
+        PersistentRbTreeNode(const PersistentRbTreeNode&);
+        PersistentRbTreeNode& operator= (const PersistentRbTreeNode&);
+    };
+
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    // Follows the tree implementation:
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+    template<typename _KeyType, typename _ValType, typename _Pred = less<_KeyType>, typename _Alloc = default_allocator<_ValType> >
+    class PersistentRbTree
+    {
+        typedef PersistentRbTreeNode<_KeyType, _ValType>        node_type;
+        typedef typename node_type::const_node_pointer          const_node_pointer;
+
+        typedef typename 
+        _Alloc::template rebind<node_type>::other               node_allocator_type;
+
+    public:
+        typedef _ValType                                        val_type;
+        typedef _KeyType                                        key_type;
+        typedef _Pred                                           key_compare; // binary predicate.
+
+        typedef typename node_type::value_type                  value_type;
+        typedef const value_type*                               const_pointer;
+        typedef const value_type&                               const_reference;
+        typedef std::size_t                                     size_type;
+        typedef std::ptrdiff_t                                  difference_type;
+        typedef _Alloc                                          allocator_type;
+
+        // In order, forward only. Valid as long as a version holding its nodes is alive.
+        class const_iterator: public std::iterator<std::forward_iterator_tag, value_type>
+        {
+            friend class PersistentRbTree;
+
+        public:
+            const_iterator() {}
+
+            const_reference operator*() const
+            {
+                GLARE_ASSERT(!m_path.empty(), "Can't be end()");
+                return m_path.back()->getData();
+            }
+            const_pointer operator->() const
+            {
+                GLARE_ASSERT(!m_path.empty(), "Can't be end()");
+                return &m_path.back()->getData();
+            }
+            const_iterator& operator++()
+            {
+                increment();
+                return *this;
+            }
+            const_iterator operator++(int)
+            {
+                const_iterator temp = *this;
+                increment();
+                return temp;
+            }
+            bool operator==(const const_iterator& _right) const
+            {
+                return m_path.empty() ? _right.m_path.empty() : (!_right.m_path.empty() && m_path.back() == _right.m_path.back());
+            }
+            bool operator!=(const const_iterator& _right) const
+            {
+                return !(*this == _right);
+            }
+
+        private:
+            // The current node on top, under it the ancestors it is left of: the ones still to visit.
+            void push_leftmost(const_node_pointer _node)
+            {
+                for (; _node != nullptr; _node = _node->left())
+                    m_path.push_back(_node);
+            }
+
+            void increment()
+            {
+                if (m_path.empty())
+                    return;
+
+                const_node_pointer current = m_path.back();
+                m_path.pop_back();
+                push_leftmost(current->right());
+            }
+
+            GLARE_VECTOR<const_node_pointer> m_path;
+        };
+
+        typedef const_iterator                                  iterator;
+
+        PersistentRbTree();
+        PersistentRbTree(const PersistentRbTree& _other);
+        PersistentRbTree& operator= (const PersistentRbTree& _other);
+        ~PersistentRbTree();
+
+        // Post: The new version, this one unchanged. insert keeps the value of a key already there, and returns this version then,
+        //       assign replaces it. erase returns this version when _key is not there.
+        PersistentRbTree insert(const key_type& _key, const val_type& _value) const;
+        PersistentRbTree assign(const key_type& _key, const val_type& _value) const;
+        PersistentRbTree erase(const key_type& _key) const;
+
+        bool exists(const key_type& _key) const;
+        bool find(const key_type& _key, val_type& _val) const;
+        const_iterator find(const key_type& _key) const;
+
+        size_type size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        const_iterator begin() const;
+        const_iterator end() const { return const_iterator(); }
+
+        // True when both versions are the very same tree, without comparing any element.
+        bool same_version(const PersistentRbTree& _other) const { return m_root == _other.m_root; }
+
+        void swap(PersistentRbTree& _tree);
+
+        // The nodes of this version, whether shared with other versions or not.
+        TreeStats stats() const;
+
+        // Checks the RB properties, the key order and the size. O(n), for tests and debugging.
+        bool verify() const;
+
+    private:
+        // Owns one reference to a node, nullptr included.
+        class node_ref
+        {
+        public:
+            node_ref(): m_node(nullptr) {}
+            explicit node_ref(const_node_pointer _node): m_node(_node) { if (m_node) m_node->acquire(); }
+            node_ref(const node_ref& _other): m_node(_other.m_node) { if (m_node) m_node->acquire(); }
+            node_ref(node_ref&& _other): m_node(_other.m_node) { _other.m_node = nullptr; }
+            ~node_ref() { release_node(m_node); }
+
+            node_ref& operator= (node_ref _other)
+            {
+                const_node_pointer temp = m_node;
+                m_node = _other.m_node;
+                _other.m_node = temp;
+                return *this;
+            }
+
+            const_node_pointer get() const { return m_node; }
+
+            // Post: The caller owns the reference, this is empty.
+            const_node_pointer detach()
+            {
+                const_node_pointer node = m_node;
+                m_node = nullptr;
+                return node;
+            }
+
+        private:
+            const_node_pointer m_node;
+        };
+
+        PersistentRbTree(const_node_pointer _adoptedRoot, size_type _size): m_root(_adoptedRoot), m_size(_size) {}
+        PersistentRbTree with_root(node_ref _root, size_type _size) const;
+
+        const_node_pointer bst_find(const key_type& _key) const;
+
+        // Path copying. The const_node_pointer arguments are borrowed, the node_ref results are new references.
+        static node_ref make_node(typename node_type::Color _color, const_node_pointer _left, const value_type& _pair, const_node_pointer _right);
+        static node_ref paint(const_node_pointer _node, typename node_type::Color _color);
+        static node_ref balance(const_node_pointer _left, const value_type& _pair, const_node_pointer _right);
+        static node_ref balance_left(const_node_pointer _left, const value_type& _pair, const_node_pointer _right);
+        static node_ref balance_right(const_node_pointer _left, const value_type& _pair, const_node_pointer _right);
+        static node_ref append(const_node_pointer _left, const_node_pointer _right);
+
+        node_ref insert_path(const_node_pointer _node, const value_type& _pair) const;
+        node_ref erase_path(const_node_pointer _node, const key_type& _key) const;
+
+        static bool isRed(const_node_pointer _node) { return _node != nullptr && _node->isRed(); }
+        static bool isBlack(const_node_pointer _node) { return _node != nullptr && _node->isBlack(); }
+
+        // Frees _node if that was its last reference, then its children likewise.
+        static void release_node(const_node_pointer _node);
+
+        static int verify_subtree(const_node_pointer _node);
+
+        const_node_pointer  m_root;     // One reference, owned.
+        size_type           m_size;
+        key_compare         m_binPredicate;
+    };
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::PersistentRbTree(): m_root(nullptr)
+                                                                           , m_size(0)
+    {
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::PersistentRbTree(const PersistentRbTree& _other): m_root(_other.m_root)
+                                                                                                         , m_size(_other.m_size)
+                                                                                                         , m_binPredicate(_other.m_binPredicate)
+    {
+        if (m_root)
+            m_root->acquire();
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>& PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::operator= (const PersistentRbTree& _other)
+    {
+        if (_other.m_root)
+            _other.m_root->acquire(); // First, in case both share the root.
+        release_node(m_root);
+
+        m_root = _other.m_root;
+        m_size = _other.m_size;
+        m_binPredicate = _other.m_binPredicate;
+        return *this;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::~PersistentRbTree()
+    {
+        release_node(m_root);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc> PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::with_root(node_ref _root, size_type _size) const
+    {
+        PersistentRbTree result(_root.detach(), _size);
+        result.m_binPredicate = m_binPredicate;
+        return result;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc> PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::insert(const key_type& _key, const val_type& _value) const
+    {
+        if (bst_find(_key))
+            return *this; // Nothing to copy.
+
+        return assign(_key, _value);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc> PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::assign(const key_type& _key, const val_type& _value) const
+    {
+        const size_type size = bst_find(_key) ? m_size : m_size + 1;
+        node_ref root = insert_path(m_root, value_type(_key, _value));
+        return with_root(paint(root.get(), node_type::Black), size); // The root may come back red.
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc> PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::erase(const key_type& _key) const
+    {
+        // The deletion relies on the key being there: every level it goes down through loses a black node.
+        if (bst_find(_key) == nullptr)
+            return *this;
+
+        node_ref root = erase_path(m_root, _key);
+        return with_root(root.get() ? paint(root.get(), node_type::Black) : node_ref(), m_size - 1);
+    }
+
+    // Okasaki's insertion: the new node goes in red, and a black node with a red child and a red grandchild on the way back up
+    // becomes a red node with two black children.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::node_ref 
+        PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::insert_path(const_node_pointer _node, const value_type& _pair) const
+    {
+        if (_node == nullptr)
+            return make_node(node_type::Red, nullptr, _pair, nullptr);
+
+        if (m_binPredicate(_pair.first, _node->key()))
+        {
+            node_ref left = insert_path(_node->left(), _pair);
+            return _node->isBlack() ? balance(left.get(), _node->getData(), _node->right()) 
+                                    : make_node(node_type::Red, left.get(), _node->getData(), _node->right());
+        }
+        else if (m_binPredicate(_node->key(), _pair.first))
+        {
+            node_ref right = insert_path(_node->right(), _pair);
+            return _node->isBlack() ? balance(_node->left(), _node->getData(), right.get()) 
+                                    : make_node(node_type::Red, _node->left(), _node->getData(), right.get());
+        }
+
+        return make_node(_node->color(), _node->left(), _pair, _node->right()); // New value, same place.
+    }
+
+    // Kahrs' deletion. Going down through a black node, the subtree comes back one black short and balance_left/right make up for it;
+    // through a red one the result is simply red. The node holding _key is replaced by the append of its children.
+    // Pre: _key is in the subtree.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::node_ref 
+        PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::erase_path(const_node_pointer _node, const key_type& _key) const
+    {
+        GLARE_ASSERT(_node != nullptr, "The key must be in the tree");
+
+        if (m_binPredicate(_key, _node->key()))
+        {
+            node_ref left = erase_path(_node->left(), _key);
+            return isBlack(_node->left()) ? balance_left(left.get(), _node->getData(), _node->right()) 
+                                          : make_node(node_type::Red, left.get(), _node->getData(), _node->right());
+        }
+        else if (m_binPredicate(_node->key(), _key))
+        {
+            node_ref right = erase_path(_node->right(), _key);
+            return isBlack(_node->right()) ? balance_right(_node->left(), _node->getData(), right.get()) 
+                                           : make_node(node_type::Red, _node->left(), _node->getData(), right.get());
+        }
+
+        return append(_node->left(), _node->right());
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::node_ref 
+        PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::make_node(typename node_type::Color _color, const_node_pointer _left, const value_type& _pair, const_node_pointer _right)
+    {
+        node_allocator_type allocator;
+        typename node_allocator_type::pointer ptr = allocator.allocate(1);
+        new (ptr) node_type(_color, _left, _pair, _right);
+        return node_ref(ptr);
+    }
+
+    // A copy of _node in _color, or _node itself when it has that color already.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::node_ref 
+        PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::paint(const_node_pointer _node, typename node_type::Color _color)
+    {
+        if (_node == nullptr || _node->color() == _color)
+            return node_ref(_node);
+        return make_node(_color, _node->left(), _node->getData(), _node->right());
+    }
+
+    // A black node over _left and _right, or, where one of them is red with a red child, the three of them rebuilt as a red node
+    // with two black children. Both red children are turned the same way.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::node_ref 
+        PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::balance(const_node_pointer _left, const value_type& _pair, const_node_pointer _right)
+    {
+        if (isRed(_left) && isRed(_right))
+        {
+            return make_node(node_type::Red, paint(_left, node_type::Black).get(), _pair, paint(_right, node_type::Black).get());
+        }
+        if (isRed(_left))
+        {
+            if (isRed(_left->left()))
+            {
+                return make_node(node_type::Red, paint(_left->left(), node_type::Black).get(), _left->getData(), 
+                                 make_node(node_type::Black, _left->right(), _pair, _right).get());
+            }
+            if (isRed(_left->right()))
+            {
+                const_node_pointer middle = _left->right();
+                return make_node(node_type::Red, make_node(node_type::Black, _left->left(), _left->getData(), middle->left()).get(), middle->getData(),
+                                 make_node(node_type::Black, middle->right(), _pair, _right).get());
+            }
+        }
+        if (isRed(_right))
+        {
+            if (isRed(_right->right()))
+            {
+                return make_node(node_type::Red, make_node(node_type::Black, _left, _pair, _right->left()).get(), _right->getData(),
+                                 paint(_right->right(), node_type::Black).get());
+            }
+            if (isRed(_right->left()))
+            {
+                const_node_pointer middle = _right->left();
+                return make_node(node_type::Red, make_node(node_type::Black, _left, _pair, middle->left()).get(), middle->getData(),
+                                 make_node(node_type::Black, middle->right(), _right->getData(), _right->right()).get());
+            }
+        }
+        return make_node(node_type::Black, _left, _pair, _right);
+    }
+
+    // Pre: _left is one black short of _right.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::node_ref 
+        PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::balance_left(const_node_pointer _left, const value_type& _pair, const_node_pointer _right)
+    {
+        if (isRed(_left))
+            return make_node(node_type::Red, paint(_left, node_type::Black).get(), _pair, _right);
+
+        if (isBlack(_right))
+            return balance(_left, _pair, paint(_right, node_type::Red).get());
+
+        GLARE_ASSERT(isRed(_right) && isBlack(_right->left()), "The RB properties are broken");
+        const_node_pointer middle = _right->left();
+        return make_node(node_type::Red, make_node(node_type::Black, _left, _pair, middle->left()).get(), middle->getData(),
+                         balance(middle->right(), _right->getData(), paint(_right->right(), node_type::Red).get()).get());
+    }
+
+    // Pre: _right is one black short of _left.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::node_ref 
+        PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::balance_right(const_node_pointer _left, const value_type& _pair, const_node_pointer _right)
+    {
+        if (isRed(_right))
+            return make_node(node_type::Red, _left, _pair, paint(_right, node_type::Black).get());
+
+        if (isBlack(_left))
+            return balance(paint(_left, node_type::Red).get(), _pair, _right);
+
+        GLARE_ASSERT(isRed(_left) && isBlack(_left->right()), "The RB properties are broken");
+        const_node_pointer middle = _left->right();
+        return make_node(node_type::Red, balance(paint(_left->left(), node_type::Red).get(), _left->getData(), middle->left()).get(), middle->getData(),
+                         make_node(node_type::Black, middle->right(), _pair, _right).get());
+    }
+
+    // Post: One tree with the nodes of _left then those of _right, which have the same black height.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::node_ref 
+        PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::append(const_node_pointer _left, const_node_pointer _right)
+    {
+        if (_left == nullptr)
+            return node_ref(_right);
+        if (_right == nullptr)
+            return node_ref(_left);
+
+        if (_left->isRed() && _right->isRed())
+        {
+            node_ref middle = append(_left->right(), _right->left());
+            if (isRed(middle.get()))
+            {
+                return make_node(node_type::Red, make_node(node_type::Red, _left->left(), _left->getData(), middle.get()->left()).get(), middle.get()->getData(),
+                                 make_node(node_type::Red, middle.get()->right(), _right->getData(), _right->right()).get());
+            }
+            return make_node(node_type::Red, _left->left(), _left->getData(), 
+                             make_node(node_type::Red, middle.get(), _right->getData(), _right->right()).get());
+        }
+        if (_left->isBlack() && _right->isBlack())
+        {
+            node_ref middle = append(_left->right(), _right->left());
+            if (isRed(middle.get()))
+            {
+                return make_node(node_type::Red, make_node(node_type::Black, _left->left(), _left->getData(), middle.get()->left()).get(), middle.get()->getData(),
+                                 make_node(node_type::Black, middle.get()->right(), _right->getData(), _right->right()).get());
+            }
+            return balance_left(_left->left(), _left->getData(), 
+                                make_node(node_type::Black, middle.get(), _right->getData(), _right->right()).get());
+        }
+        if (_right->isRed())
+            return make_node(node_type::Red, append(_left, _right->left()).get(), _right->getData(), _right->right());
+
+        return make_node(node_type::Red, _left->left(), _left->getData(), append(_left->right(), _right).get());
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    void PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::release_node(const_node_pointer _node)
+    {
+        if (_node == nullptr || !_node->release())
+            return;
+
+        const_node_pointer left = _node->left();
+        const_node_pointer right = _node->right();
+
+        node_allocator_type allocator;
+        typename node_allocator_type::pointer ptr = const_cast<typename node_allocator_type::pointer>(_node);
+        allocator.destroy(ptr);
+        allocator.deallocate(ptr, 1);
+
+        release_node(left);
+        release_node(right);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::const_node_pointer 
+        PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::bst_find(const key_type& _key) const
+    {
+        const_node_pointer currentPtr = m_root;
+        while (currentPtr != nullptr)
+        {
+            if (m_binPredicate(_key, currentPtr->key())) // less_than(givenKey, currentPtr->key())
+                currentPtr = currentPtr->left();
+            else if (m_binPredicate(currentPtr->key(), _key))
+                currentPtr = currentPtr->right();
+            else
+                break; // Found!
+        }
+        return currentPtr;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    bool PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::exists(const key_type& _key) const
+    {
+        return (bst_find(_key) != nullptr);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    bool PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::find(const key_type& _key, val_type& _val) const
+    {
+        if (const_node_pointer nodePtr = bst_find(_key))
+        {
+            _val = nodePtr->value();
+            return true;
+        }
+        return false;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::const_iterator 
+        PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::find(const key_type& _key) const
+    {
+        // The ancestors _key is left of are the ones its iterator still has to visit.
+        const_iterator result;
+        const_node_pointer currentPtr = m_root;
+        while (currentPtr != nullptr)
+        {
+            if (m_binPredicate(_key, currentPtr->key()))
+            {
+                result.m_path.push_back(currentPtr);
+                currentPtr = currentPtr->left();
+            }
+            else if (m_binPredicate(currentPtr->key(), _key))
+            {
+                currentPtr = currentPtr->right();
+            }
+            else
+            {
+                result.m_path.push_back(currentPtr);
+                return result;
+            }
+        }
+        return end();
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::const_iterator PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::begin() const
+    {
+        const_iterator result;
+        result.push_leftmost(m_root);
+        return result;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    void PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::swap(PersistentRbTree& _tree)
+    {
+        if (this != &_tree)
+        {
+            std::swap(m_root, _tree.m_root);
+            std::swap(m_size, _tree.m_size);
+            std::swap(m_binPredicate, _tree.m_binPredicate);
+        }
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    TreeStats PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::stats() const
+    {
+        TreeStats result;
+        binary_tree_stats(m_root, result);
+        result.m_size = m_size;
+        result.m_bytes = result.m_nodeCount * sizeof(node_type);
+
+        for (const_node_pointer current = m_root; current != nullptr; current = current->left())
+        {
+            if (current->isBlack()) {
+                ++result.m_blackHeight;
+            }
+        }
+        return result;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    bool PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::verify() const
+    {
+        if (isRed(m_root) || verify_subtree(m_root) < 0)
+            return false;
+
+        size_type count = 0;
+        const value_type* previous = nullptr;
+        for (const_iterator it = begin(); it != end(); ++it, ++count)
+        {
+            if (previous && !m_binPredicate(previous->first, it->first))
+                return false;
+            previous = &*it;
+        }
+        return count == m_size;
+    }
+
+    // Post: The black height of the subtree, -1 when a red node has a red child or the black heights differ.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    int PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>::verify_subtree(const_node_pointer _node)
+    {
+        if (_node == nullptr)
+            return 0;
+
+        if (_node->isRed() && (isRed(_node->left()) || isRed(_node->right())))
+            return -1;
+
+        const int left = verify_subtree(_node->left());
+        const int right = verify_subtree(_node->right());
+        if (left < 0 || left != right)
+            return -1;
+
+        return left + (_node->isBlack() ? 1 : 0);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    void swap(PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>& _left, PersistentRbTree<_KeyType, _ValType, _Pred, _Alloc>& _right)
+    {
+        _left.swap(_right);
+    }
+
+} // namespace glare
+
+#endif // GLARE_PERSISTENT_RB_TREE_H
@@ -1,8 +1,11 @@
-#ifndef GLARE_RED_BLAC0K_TREE_H
+#ifndef GLARE_RED_BLACK_TREE_H
 #define GLARE_RED_BLACK_TREE_H
 
 #include "BSTNode.h"
+#include "TreeStats.h"
 #include "memory\allocators.h"
+#include "threading\ParallelAlgorithms.h"
+#include "threading\Reclaimer.h"
 #include <iterator>
 
 //-------------------------------------------------------------------------------------------------------------------
@@ -33,7 +36,12 @@ namespace glare
 
         RbTreeNode();
         explicit RbTreeNode(const value_type& _pair);
+        explicit RbTreeNode(value_type&& _pair);
         RbTreeNode(const RbTreeNode& _other);
+
+        // Key and value built in place from their own arguments.
+        template<typename _KeyArg, typename _ValArg>
+        RbTreeNode(_KeyArg&& _key, _ValArg&& _value);
         
         // Basic Node Functionality
         const KeyType&      key() const { return m_pair.first; }
@@ -48,6 +56,10 @@ namespace glare
         const_node_pointer  right() const { return m_right; }
         const_node_pointer  parent() const { return m_parent; }
 
+        void                left(node_pointer _node) { m_left = _node; }
+        void                right(node_pointer _node) { m_right = _node; }
+        void                parent(node_pointer _node) { m_parent = _node; }
+
         value_type&         getData() { return m_pair; }
         const value_type&   getData() const { return m_pair; }
 
@@ -57,12 +69,10 @@ namespace glare
         bool  isBlack() const   { return m_color == Black; }
         bool  isRed() const     { return m_color == Red; }
 
-    public:
+    private:
         node_pointer m_left;
         node_pointer m_right;
         node_pointer m_parent;
-
-    private:
         Color m_color;
         value_type m_pair;
 
@@ -90,6 +100,27 @@ namespace glare
     {
     }
 
+    // 1 Argument Move Constructor
+    template<typename KeyType, typename ValueType>
+    RbTreeNode<KeyType, ValueType>::RbTreeNode(value_type&& _pair): m_left(nullptr)
+                                                                  , m_right(nullptr)
+                                                                  , m_parent(nullptr)
+                                                                  , m_color(Red)
+                                                                  , m_pair(std::move(_pair))
+    {
+    }
+
+    // 2 Arguments Constructor
+    template<typename KeyType, typename ValueType>
+    template<typename _KeyArg, typename _ValArg>
+    RbTreeNode<KeyType, ValueType>::RbTreeNode(_KeyArg&& _key, _ValArg&& _value): m_left(nullptr)
+                                                                                , m_right(nullptr)
+                                                                                , m_parent(nullptr)
+                                                                                , m_color(Red)
+                                                                                , m_pair(std::forward<_KeyArg>(_key), std::forward<_ValArg>(_value))
+    {
+    }
+
     // Copy Constructor
     template<typename KeyType, typename ValueType>
     RbTreeNode<KeyType, ValueType>::RbTreeNode(const RbTreeNode& _other): m_left(nullptr)
@@ -100,20 +131,673 @@ namespace glare
     {
     }
 
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    // Red-Black balancing, shared by the RedBlackTree and the IntrusiveRbTree:
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+    // Metadata a node type keeps about its subtree, recomputed from the children whenever the subtree changes. None by default, the
+    // augmented nodes of RbTreeAugment.h specialize it.
+    template<typename _NodeType>
+    struct rb_node_augment
+    {
+        static const bool enabled = false;
+        static void update(_NodeType*) {}
+    };
+
+    // The algorithms only relink nodes, they never allocate, compare keys or touch the payload. _NodeType has the left()/right()/parent()
+    // accessors of RbTreeNode, the setters of the same names and the Color interface; how the links and the color are stored is up to
+    // the node. The tree passes its root, and its leftmost/rightmost nodes where they may change. Every relink keeps the metadata of
+    // an augmented node type up to date: the rotations recompute the two nodes they swap, linking and removing recompute the path
+    // up from the deepest node whose subtree changed, transplant included.
+    template<typename _NodeType>
+    struct rb_tree_algorithms
+    {
+        typedef _NodeType                                       node_type;
+        typedef node_type*                                      node_pointer;
+
+        // Post: The metadata of _node is recomputed from its children, which must be up to date.
+        static void augment(node_pointer _node) { rb_node_augment<node_type>::update(_node); }
+        // Post: The metadata of _node and of all its ancestors is recomputed, bottom up.
+        static void augment_path(node_pointer _node);
+
+        static void rb_link(node_pointer& _root, node_pointer& _leftmost, node_pointer& _rightmost, node_pointer _parent, bool _left, node_pointer _newNodePtr);
+        static bool rb_insert_fixup(node_pointer& _root, node_pointer _newNodePtr);
+
+        static void rb_remove(node_pointer& _root, node_pointer& _leftmost, node_pointer& _rightmost, node_pointer _nodeToDelete);
+        static void rb_remove_fixup(node_pointer& _root, node_pointer _x, node_pointer _xp);
+
+        static void transplant(node_pointer& _root, node_pointer _u, node_pointer _v);
+        static void rotate_right(node_pointer& _root, node_pointer _subRootPtr);
+        static void rotate_left(node_pointer& _root, node_pointer _subRootPtr);
+
+        static node_pointer minimum(node_pointer _u);
+        static node_pointer maximum(node_pointer _u);
+        static node_pointer successor(node_pointer _x);
+        static node_pointer predecessor(node_pointer _x);
+
+        static node_pointer rb_join(node_pointer _left, int _leftBlackHeight, node_pointer _middle, node_pointer _right, int _rightBlackHeight, int& _blackHeight);
+        static int black_height(const node_type* _root);
+        static int rb_verify(const node_type* _root);
+    };
+
+    // Pre: _parent is where the search for the new key fell off the tree, _left tells on which side; nullptr when the tree is empty.
+    // Post: _newNodePtr is linked in red, the leftmost/rightmost nodes are updated and the RB properties hold again.
+    template<typename _NodeType>
+    void rb_tree_algorithms<_NodeType>::rb_link(node_pointer& _root, node_pointer& _leftmost, node_pointer& _rightmost,
+                                                node_pointer _parent, bool _left, node_pointer _newNodePtr)
+    {
+        _newNodePtr->left(nullptr);
+        _newNodePtr->right(nullptr);
+        _newNodePtr->parent(_parent);
+        _newNodePtr->color(node_type::Red);
+
+        if(_parent) 
+        {
+            if (_left)
+            {
+                _parent->left(_newNodePtr);
+                if (_parent == _leftmost)
+                    _leftmost = _newNodePtr;
+            }
+            else
+            {
+                _parent->right(_newNodePtr);
+                if (_parent == _rightmost)
+                    _rightmost = _newNodePtr;
+            }
+
+            augment_path(_newNodePtr);
+            rb_insert_fixup(_root, _newNodePtr); // This is the only case when we need to fix the insertion.
+        }
+        else
+        {
+            _root = _newNodePtr;
+            _leftmost = _newNodePtr;
+            _rightmost = _newNodePtr;
+            _root->color(node_type::Black);
+            augment(_root);
+            // Insertion shouldn't be a problem as it is the first node to be inserted in the tree, need not be fixed.
+        }
+    }
+    
+    // Pre: The insertion might have violated the RBTree properties by having a red node with red parent.
+    // Post: The RB properties hold true and the tree becomes a legit RBtree. Returns true when the black height of the tree grew by one,
+    //       which is when the violation was passed all the way up and the root had to be painted back to black.
+    template<typename _NodeType>
+    bool rb_tree_algorithms<_NodeType>::rb_insert_fixup(node_pointer& _root, node_pointer _newNodePtr)
+    {
+        // Following loop invariant is true prior to the first iteration of the loop, 
+        // and each iteration maintains the loop invariant:
+        //
+        // a. Node Z is red, where Z is the newly inserted node prior to call.
+        // b. If Z.p is the root, then Z.p is black and did not change prior to the call.
+        // c. If the tree violates any of the red-black properties, then it violates at most
+        //    one of them, and the violation is of either property 2 or property 4. If the
+        //    tree violates property 2, it is because Z is the root and is red. If the tree
+        //    violates property 4, it is because both Z and Z.p are red.
+        
+        GLARE_ASSERT(_newNodePtr && _newNodePtr->parent(), "Both should exist for the violation to happen");
+
+        while (_newNodePtr != _root && _newNodePtr->parent()->color() == node_type::Red)
+        {
+            node_pointer grandParentPtr = _newNodePtr->parent()->parent();
+            if (_newNodePtr->parent() == grandParentPtr->left())
+            {
+                node_pointer auntPtr = grandParentPtr->right();
+                if (auntPtr && auntPtr->color() == node_type::Red)
+                {
+                    // Case 1: _newNodePtr, _newNodePtr->parent(), auntPtr all red; flip color.
+                    _newNodePtr->parent()->color(node_type::Black);                  
+                    auntPtr->color(node_type::Black);
+                    grandParentPtr->color(node_type::Red);
+                    _newNodePtr = grandParentPtr; // Problem is passed 2 levels up the tree.
+                }
+                else
+                { 
+                    // Aunt is black, this means at least 1 rotation will happen.
+                    if (_newNodePtr == _newNodePtr->parent()->right()) // Do we need a double rotation?
+                    {
+                        // Case 2: Violation is made by having a red node on a zig-zag path.
+                        _newNodePtr = _newNodePtr->parent(); // Parent becomes left child of its current child after rotation, basically transforming to case 3.
+                        rotate_left(_root, _newNodePtr); // grandParentPtr is still the same and Case 3 is converted to Case 2.
+                    }
+                    // Case 3: Simple Zig-Zig case, 1 rotation will suffice.
+                    _newNodePtr->parent()->color(node_type::Black); // If its a Case 3 then this is the updated parent after left rotation.
+                    grandParentPtr->color(node_type::Red);
+                    rotate_right(_root, grandParentPtr);
+                }
+            }
+            else
+            {
+                // New node' parent is the right child of its grand parent!
+                node_pointer auntPtr = grandParentPtr->left();
+                if (auntPtr && auntPtr->color() == node_type::Red)
+                {
+                    // Case 1: _newNodePtr, _newNodePtr->parent(), auntPtr all red; flip color.
+                    _newNodePtr->parent()->color(node_type::Black);
+                    auntPtr->color(node_type::Black);
+                    grandParentPtr->color(node_type::Red);
+                    _newNodePtr = grandParentPtr; // Problem is passed 2 levels up the tree.
+                }
+                else
+                {
+                    // Aunt is black, this means at least 1 rotation will happen.
+                    if (_newNodePtr == _newNodePtr->parent()->left()) // Do we need a double rotation?
+                    {
+                        // Case 2: Violation is made by adding a red node on a zag-zig path.
+                        _newNodePtr = _newNodePtr->parent(); // Transforming to case 3, _newNodePtr will be the violating Red Condition node after rotation.
+                        rotate_right(_root, _newNodePtr); // Transformed, now _newNodePtr points to the child that really violates the red condition!
+                    }
+                    // Case 3: Simple Zig-Zig case, 1 rotation will suffice.
+                    _newNodePtr->parent()->color(node_type::Black);
+                    grandParentPtr->color(node_type::Red);
+                    rotate_left(_root, grandParentPtr);
+                }
+            }
+        }
+
+        const bool blackHeightGrew = _root->isRed();
+        _root->color(node_type::Black);
+        return blackHeightGrew;
+    }
+
+    template<typename _NodeType>
+    void rb_tree_algorithms<_NodeType>::rotate_right(node_pointer& _root, node_pointer _subRootPtr)
+    {
+        GLARE_ASSERT(_subRootPtr && _subRootPtr->left(), "[RBTree][Logic Fail] This impossible situation shouldn't have arised.");
+
+        node_pointer leftSubtree = _subRootPtr->left();
+        _subRootPtr->left(leftSubtree->right());
+
+        if (leftSubtree->right())
+            leftSubtree->right()->parent(_subRootPtr);
+
+        leftSubtree->parent(_subRootPtr->parent());
+
+        if (_subRootPtr->parent())
+        {
+            if (_subRootPtr == _subRootPtr->parent()->left())
+                _subRootPtr->parent()->left(leftSubtree);
+            else
+                _subRootPtr->parent()->right(leftSubtree);
+        }
+        else
+        {
+            _root = leftSubtree;
+        }
+
+        leftSubtree->right(_subRootPtr);
+        _subRootPtr->parent(leftSubtree);
+
+        augment(_subRootPtr); // Now the child.
+        augment(leftSubtree);
+    }
+
+    template<typename _NodeType>
+    void rb_tree_algorithms<_NodeType>::rotate_left(node_pointer& _root, node_pointer _subRootPtr)
+    {
+        GLARE_ASSERT(_subRootPtr && _subRootPtr->right(), "[RBTree][Logic Fail] This impossible situation shouldn't have arised.");
+
+        node_pointer rightSubtree = _subRootPtr->right();
+        _subRootPtr->right(rightSubtree->left());
+
+        if(rightSubtree->left())
+            rightSubtree->left()->parent(_subRootPtr);
+
+        rightSubtree->parent(_subRootPtr->parent());
+
+        if(_subRootPtr->parent())
+        {
+            if(_subRootPtr == _subRootPtr->parent()->left())
+                _subRootPtr->parent()->left(rightSubtree);
+            else
+                _subRootPtr->parent()->right(rightSubtree);
+        }
+        else
+        {
+            _root = rightSubtree;
+        }
+
+        rightSubtree->left(_subRootPtr);
+        _subRootPtr->parent(rightSubtree);
+
+        augment(_subRootPtr); // Now the child.
+        augment(rightSubtree);
+    }
+
+    // Pre: We wand to replace the subtree rooted at node _u with the one rooted at _v.
+    // Post: node _us parent becomes node _vs parent, and _us parent ends up having _v as its appropriate child.
+    template<typename _NodeType>
+    void rb_tree_algorithms<_NodeType>::transplant(node_pointer& _root, node_pointer _u, node_pointer _v)
+    {
+        if (_u->parent() == nullptr)
+            _root = _v; // This means that _u is the root.
+        else if (_u == _u->parent()->left())
+            _u->parent()->left(_v);
+        else
+        {
+            _u->parent()->right(_v);
+        }
+
+        if (_v)
+            _v->parent(_u->parent());
+    }
+    
+    template<typename _NodeType>
+    void rb_tree_algorithms<_NodeType>::augment_path(node_pointer _node)
+    {
+        if (!rb_node_augment<node_type>::enabled)
+            return; // No walk up the tree for nothing.
+
+        for (; _node != nullptr; _node = _node->parent())
+            augment(_node);
+    }
+
+    template<typename _NodeType>
+    typename rb_tree_algorithms<_NodeType>::node_pointer 
+        rb_tree_algorithms<_NodeType>::minimum(node_pointer _nodePtr)
+    {
+        while (_nodePtr->left() != nullptr)
+            _nodePtr = _nodePtr->left();
+        return _nodePtr;
+    }
+
+    template<typename _NodeType>
+    typename rb_tree_algorithms<_NodeType>::node_pointer 
+        rb_tree_algorithms<_NodeType>::maximum(node_pointer _nodePtr)
+    {
+        while (_nodePtr->right() != nullptr)
+            _nodePtr = _nodePtr->right();
+        return _nodePtr;
+    }
+    
+    // We break the code for "inorder" successor into two cases:
+    // * If the right subtree of node x is nonempty, then the successor of x is just the leftmost node in xs right subtree.
+    // * If the right subtree of node x is empty and x has a successor y, then y is the lowest ancestor of x whose left child
+    //   is also an ancestor of x. To find y, we simply go up the tree from x until we encounter a node that is the left child of its parent.
+    template<typename _NodeType>
+    typename rb_tree_algorithms<_NodeType>::node_pointer 
+        rb_tree_algorithms<_NodeType>::successor(node_pointer _x)
+    {
+        if(_x->right() != nullptr)
+            return minimum(_x->right());
+
+        node_pointer y = _x->parent();
+        while (y != nullptr && _x == y->right())
+        {
+            _x = y;
+            y = y->parent();
+        }
+        return y;
+    }
+
+    // Code for "inorder" predecessor is symmetric to the successor's code. We break the code for predecessor into two cases:
+    // * If the left subtree of node x is nonempty, then the predecessor of x is just the rightmost node in xs left subtree.
+    // * If the left subtree of node x is empty and x has a predecessor y, then y is the highest ancestor of x whose right child
+    //   is also an ancestor of x. To find y, we simply go up the tree from x until we encounter a node that is the right child of its parent.
+    template<typename _NodeType>
+    typename rb_tree_algorithms<_NodeType>::node_pointer 
+        rb_tree_algorithms<_NodeType>::predecessor(node_pointer _x)
+    {
+        if (_x->left() != nullptr)
+            return maximum(_x->left());
+
+        node_pointer y = _x->parent();
+        while (y != nullptr && _x == y->left())
+        {
+            _x = y;
+            y = y->parent();
+        }
+        return y;
+    }
+
+
+    // Pre: _nodeToDelete is linked in the tree rooted at _root.
+    // Post: _nodeToDelete is unlinked and the RB properties are restored, freeing it is up to the caller.
+    template<typename _NodeType>
+    void rb_tree_algorithms<_NodeType>::rb_remove(node_pointer& _root, node_pointer& _leftmost, node_pointer& _rightmost, node_pointer _nodeToDelete)
+    {
+        node_pointer y = _nodeToDelete; // 'y' is a node that either gets removed from then tree or moved within the tree (in this case its a successor).
+        typename node_type::Color originalColorY = y->color();
+            
+        node_pointer x = nullptr;  // we keep track of the node 'x' that moves into node y' original position, thus replacing it. x could also be a nullptr.
+        node_pointer xp = nullptr; // New parent of x. This used to be the parent of 'y' before 'x' replaced it.
+        // So 'x' being the node replacing 'y' and xp is x's new parent after replacing y.
+
+        // We found the node to be deleted!
+        if(y->left() == nullptr)
+        {
+            x = y->right(); // x could be a nullptr.
+            xp = y->parent();
+            transplant(_root, y, x);
+            GLARE_ASSERT((x == nullptr || x->isRed()), "If a node has only one child, that child has to be Red otherwise RB Properties are violated");
+        }
+        else if(y->right() == nullptr)
+        {
+            x = y->left(); // here 'x' could not be a nullptr, otherwise it wouldn't have entered this else-if part.
+            xp = y->parent();
+            transplant(_root, y, x);
+            GLARE_ASSERT(x->isRed(), "If a node has only one child, that child has to be Red otherwise RB Properties are violated");
+        }
+        else
+        {
+            y = minimum(_nodeToDelete->right()); // 'y' now points to the successor indication that its being removed, 'cos successor replaces '_nodeToDelete' takes it's color which keeps the equation same at the _nodeToDelete level.
+                                                // The node that actually gets missing is the successor node itself, ignore its value because what matters now is its color. If it was black then we have a violation.
+            originalColorY = y->color();
+            x = y->right(); // x could be a nullptr. x will replace 'y' because y is being re-placed in the tree.
+            xp = y->parent(); // xp will be x' new parent after the transplant(_root, y, x).
+
+            if (xp == _nodeToDelete)
+                xp = y; // We don't want xp to point to _nodeToDelete as it is being deleted and also the real parent of x in this particular case will itself be y.
+            else
+            {
+                transplant(_root, y, x); // After this transplant x takes y' position and y' parent becomes x' parent, i.e. 'xp'.
+                y->right(_nodeToDelete->right());
+                _nodeToDelete->right()->parent(y);
+            }
+            transplant(_root, _nodeToDelete, y); // replace _nodeToDelete with its successor.
+            y->left(_nodeToDelete->left());
+            y->left()->parent(y);
+            y->color(_nodeToDelete->color());
+        }
+
+        // One important point, if _leftmost or _rightmost is the _nodeToDelete then 'y' can't be a successor(_nodeToDelete). 
+        // As _leftmost or _rightmost can have at the most one child right or left respectively.
+        if (_leftmost == _nodeToDelete) // Leftmost can have a right child, which could be nullptr.
+        {
+            _leftmost = (x == nullptr) ? xp : minimum(x); // x can only be right child of leftmost node.
+        }
+        // Not using else, because if leftmost == rightmost == _nodeToDelete == _root, then both should be modified.
+        if(_rightmost == _nodeToDelete)
+        {
+            _rightmost = (x == nullptr) ? xp : maximum(x);  // x can only be left child of rightmost node.
+        }
+
+        // If y is black then moving y within the tree causes any simple path that previously contained y to have one fewer black node. Thus, it violates property #5.
+        // We can correct the violation of property #5 by saying that node x, now occupying y' original position, has an "extra" black. That is, if we add 1 to the 
+        // count of black nodes on any simple path that contains x, then under this interpretation, property 5 holds. When we remove or move the black node y, we "push" 
+        // its blackness onto node x. The problem is that now node x is neither red nor black, thereby violating property 1. Instead, node x is either "doubly black" or
+        // "red-and-black," and it contributes either 2 or 1, respectively, to the count of black nodes on simple paths containing x. The color attribute of x will still 
+        // be either RED (if x is red-and-black) or BLACK (if x is doubly black). In other words, the extra black on a node is reflected in x's pointing to the node rather 
+        // than in the color attribute.
+        augment_path(xp); // Every subtree that lost a node or got one moved in is on the path up from xp, y's included.
+
+        if (originalColorY == node_type::Black)
+            rb_remove_fixup(_root, x, xp); // x can be nullptr that is why we want to send x's parent separately.
+    }
+    
+    // Pre: rb_remove may violate property #2, #4, #5
+    //  * #2, if the node to delete was root and a red root replaced it.
+    //  * #4, if the deleted node was black with a red child (right), which replaces it.
+    //  * #5, if the deleted node was black with both child nils then we are short of 1 black count on this path. 
+    //    It has supposedly pushed its blackness to its child which replaces it, and this child is now doubly black. 
+    //    1 count of black because its a nil node & 1 because it has the blackness pushed upon it by its former black parent.
+
+    // Post: Violations of property #2, #4, #5 are removed and the tree is back to being a legit RB Tree.
+    template<typename _NodeType>
+    void rb_tree_algorithms<_NodeType>::rb_remove_fixup(node_pointer& _root, node_pointer _x, node_pointer _xp)
+    {
+        // Some Conventions.
+        //       (p)
+        //      //  \
+        //     x     s
+        //
+        // x is the double black node which replaced its former black parent.
+        // s is the sibling.
+        // p is the parent.
+
+        // All possible cases for the doubly black node 'x':
+        // Case #1: sibling of x is black and has 1 red child. This is a terminal case.
+        //       a: When sibling is right and its right child is red, color of left doesn't matter. Same for when sibling is left and its left child.
+        //       b: When sibling is right and its left child is red, right is black, we transform it to case #1(a). Same for when the sibling is left
+        //          and its right child is red, and left child is black. we make rotation to transform it to case #1(a).
+        //
+        // Case #2: sibling of x is black and both of s' children are black. This is the recoloring case only.
+        //       a: If parent p is red then recoloring is the terminal case.
+        //       b: If parent p is black, then x will point to p now, indicating that it is p which is doubly black now. and propagates the problem upwards.
+        //
+        // Case #3: sibling 's' of x is red, in this case we make a rotation on 'p' and transform into one of the above mentioned cases.
+
+        node_pointer x = _x;   // Double black node.
+        node_pointer xp = _xp; // Parent of the double black node. Why take xp separately when we can do x->parent(), the answer is that x can also be nullptr and xp can't be nullptr.
+
+        while ( x != _root && (x == nullptr || x->isBlack()) )
+        {
+            // Loop Invariant:
+            // x is always the double black node in question at the beginning of the iteration.
+            // x is never a root, because when that happens we just simply discard the extra black.
+            // The idea is to find a red node on the path upward and change the pair (RED, DOUBLE-BLACK) to (BLACK, BLACK).
+            // Restructuring solves the problem locally while recoloring may propagate it upwards.
+
+            if (x == xp->left()) // x is the left child of its parent.
+            {
+                node_pointer s = xp->right();    
+
+                // Check if it is case #3 then transform it into case #1 or #2.
+                if (s->isRed()) // Case #3
+                { 
+                    // s being red means its children and its parent must be black.
+                    s->color(node_type::Black); // s replaces p so it takes its color to not change the overall picture.
+                    xp->color(node_type::Red);   // we color parent red because we already have s (its 'now' parent) as black.
+                    rotate_left(_root, xp); // 'xp' will still remain the parent of 'x' after the left rotation.
+                    s = xp->right(); // left child of older 's' now becomes new sibling after rotation. It must be black by property #4.
+                }
+
+                // At this point we know that 's' is black whatsoever, so we don't need to test for that. Either Case #1 or #2 applies.
+                if ( (s->right() == nullptr || s->right()->isBlack()) && (s->left() == nullptr || s->left()->isBlack()) )
+                {
+                    s->color(node_type::Red); // Take 1 black from both the double black node and 's' and pass it on to its parent.
+                    x = xp; // the notion of being double black or having an extra black count is reflected by 'x' pointing to a node.
+                    // So, if xp was black then it becomes double black now. if it was red then it becomes red-black node. x' pointing to it adds an extra black.
+                    // If we came from Case#3 then the loop will terminate after this as xp must be red. After the while loop x is turned to black which solves the problem.
+                    xp = xp->parent();
+                }
+                else // its case #1 then.
+                { 
+                    // Test for case #1(b), if it is then transform it to case #1(a).
+                    if (s->right() == nullptr || s->right()->isBlack()) // If s->right is black then s->left must be red, 'cos we are in the else part & we know 1 of the 2 children is RED for sure.
+                    {
+                        s->left()->color(node_type::Black);
+                        s->color(node_type::Red);
+                        rotate_right(_root, s); // Transformed!
+                        s = xp->right();  // The new sibling is black with a red right child, case #1(a), woo!
+                    }
+
+                    // Case #1(a) applies
+                    s->color(xp->color()); // Sibling takes its parent's color to keep the bigger picture similar after rotation.
+                    xp->color(node_type::Black); // Parent becomes black to consume the extra black of x.
+                    s->right()->color(node_type::Black); // s' right child becomes black to compensate for 1 black count that came from s before rotation.
+                    rotate_left(_root, xp);
+                    x = _root; // a way to break.
+                }
+            }
+            else // x is the right child of its parent, all of the above code, therefore, will be mirrored.
+            {
+                node_pointer s = xp->left();
+
+                if (s->isRed()) // Case #3
+                {
+                    s->color(node_type::Black); // We can also swap the colors but direct setting the colors is much better.
+                    xp->color(node_type::Red);
+                    rotate_right(_root, xp);
+                    s = xp->left(); // The new sibling is black, congratulations!
+                }
+
+                // At this point we know that 's' is black so one of the cases #1 or #2 apply.
+                // Test for case #2
+                if ( (s->left() == nullptr || s->left()->isBlack()) && (s->right() == nullptr || s->right()->isBlack()) )
+                {
+                    s->color(node_type::Red); // Take 1 black count from both the "supposedly" double-black node and 's' and pass it on to its parent 'p'.
+                    x = xp; // Now parent's color either become red-black or double-black. If red-black then its a terminal case.
+                    // Notion of a node being red-black or double-black is reflected by x' pointing to it. The actual color value stays red or black respectively.
+                    xp = xp->parent();
+                }
+                else
+                {
+                    // Test for case #1b, if it is #1(b), indeed, transform it to #1(a).
+                    if (s->left() == nullptr || s->left()->isBlack())
+                    {
+                        s->right()->color(node_type::Black);
+                        s->color(node_type::Red);
+                        rotate_left(_root, s);
+                        s = xp->left();
+                    }
+
+                    // Case #1(a) applies
+                    s->color(xp->color());
+                    xp->color(node_type::Black);
+                    s->left()->color(node_type::Black); // Left can never be nullptr, impossible.
+                    rotate_right(_root, xp);
+                    x = _root; // a way to break.
+                }
+            }
+        }
+
+        if (x)
+            x->color(node_type::Black); // fixes property #2, #4
+    }
+
+    // Pre: _left and _right are detached trees, nullptr or a black root without parent, of black heights _leftBlackHeight and _rightBlackHeight
+    //      (black nodes on a path from the root down to a nullptr). Every node of _left goes before _middle and every node of _right after it.
+    // Post: Returns the root of the joined tree and its black height in _blackHeight. _middle is linked in red on the spine of the taller tree,
+    //       where the black height matches the other tree, and the insertion fixup rebalances: O(difference of the black heights).
+    template<typename _NodeType>
+    typename rb_tree_algorithms<_NodeType>::node_pointer 
+        rb_tree_algorithms<_NodeType>::rb_join(node_pointer _left, int _leftBlackHeight, node_pointer _middle, node_pointer _right, int _rightBlackHeight, int& _blackHeight)
+    {
+        GLARE_ASSERT((_left == nullptr || (_left->isBlack() && _left->parent() == nullptr)) && (_right == nullptr || (_right->isBlack() && _right->parent() == nullptr)), 
+                     "Only detached trees with a black root can be joined");
+
+        if (_leftBlackHeight == _rightBlackHeight)
+        {
+            _middle->left(_left);
+            _middle->right(_right);
+            _middle->parent(nullptr);
+            _middle->color(node_type::Black);
+
+            if (_left)
+                _left->parent(_middle);
+            if (_right)
+                _right->parent(_middle);
+
+            augment(_middle);
+            _blackHeight = _leftBlackHeight + 1;
+            return _middle;
+        }
+
+        node_pointer root = nullptr;
+        node_pointer parentPtr = nullptr;
+        node_pointer currentPtr = nullptr;
+
+        if (_leftBlackHeight > _rightBlackHeight)
+        {
+            // Down the right spine of _left to the first black node, or nullptr, with the black height of _right.
+            int height = _leftBlackHeight;
+            for (currentPtr = _left; currentPtr != nullptr && (currentPtr->isRed() || height != _rightBlackHeight); currentPtr = currentPtr->right())
+            {
+                if (currentPtr->isBlack())
+                    --height;
+                parentPtr = currentPtr;
+            }
+            GLARE_ASSERT(height == _rightBlackHeight && parentPtr != nullptr, "The spine must reach the black height of the shorter tree");
+
+            _middle->left(currentPtr);
+            _middle->right(_right);
+            parentPtr->right(_middle);
+            root = _left;
+        }
+        else
+        {
+            // Down the left spine of _right, symmetric.
+            int height = _rightBlackHeight;
+            for (currentPtr = _right; currentPtr != nullptr && (currentPtr->isRed() || height != _leftBlackHeight); currentPtr = currentPtr->left())
+            {
+                if (currentPtr->isBlack())
+                    --height;
+                parentPtr = currentPtr;
+            }
+            GLARE_ASSERT(height == _leftBlackHeight && parentPtr != nullptr, "The spine must reach the black height of the shorter tree");
+
+            _middle->left(_left);
+            _middle->right(currentPtr);
+            parentPtr->left(_middle);
+            root = _right;
+        }
+
+        _middle->parent(parentPtr);
+        _middle->color(node_type::Red);
+        if (_middle->left())
+            _middle->left()->parent(_middle);
+        if (_middle->right())
+            _middle->right()->parent(_middle);
+        augment_path(_middle);
+
+        // Both children of _middle have the black height it replaced, the only possible violation is a red parent, as after an insertion.
+        _blackHeight = (_leftBlackHeight > _rightBlackHeight ? _leftBlackHeight : _rightBlackHeight);
+        if (rb_insert_fixup(root, _middle))
+            ++_blackHeight;
+
+        return root;
+    }
+
+    // Property #5, any path down to a nullptr will do.
+    template<typename _NodeType>
+    int rb_tree_algorithms<_NodeType>::black_height(const node_type* _root)
+    {
+        int height = 0;
+        for (; _root != nullptr; _root = _root->left())
+        {
+            if (_root->isBlack())
+                ++height;
+        }
+        return height;
+    }
+
+    // Post: Returns the black height of the subtree, or -1 if a parent link is wrong or a RB property is violated. Recursive, O(n), for tests.
+    template<typename _NodeType>
+    int rb_tree_algorithms<_NodeType>::rb_verify(const node_type* _root)
+    {
+        if (_root == nullptr)
+            return 0;
+
+        const node_type* children[2] = { _root->left(), _root->right() };
+        int heights[2] = { 0, 0 };
+        for (int i = 0; i < 2; ++i)
+        {
+            if (children[i] && (children[i]->parent() != _root || (_root->isRed() && children[i]->isRed())))
+                return -1;
+
+            heights[i] = rb_verify(children[i]);
+        }
+
+        if (heights[0] < 0 || heights[0] != heights[1])
+            return -1;
+
+        return heights[0] + (_root->isBlack() ? 1 : 0);
+    }
+
     // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
     // Follows the tree implementation:
     // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
-    template<typename _KeyType, typename _ValType, typename _Pred = less<_KeyType>, typename _Alloc = default_allocator<_ValType> >
+    // Key policies of RedBlackTree. With rb_multi_keys a key can be inserted any number of times, each in a node of its own placed after
+    // the equal keys already there, so they iterate in insertion order. find returns the first of them, erase(key) removes them all.
+    struct rb_unique_keys   { static const bool multi = false; };
+    struct rb_multi_keys    { static const bool multi = true; };
+
+    // _Node stores an element with its links and color, RbTreeNode or one of the smaller nodes of RbTreeCompactNode.h. The nodes of
+    // RbTreeAugment.h also keep metadata about their subtree for the order statistic, sum and interval queries. _KeyPolicy is one of
+    // the two above.
+    template<typename _KeyType, typename _ValType, typename _Pred = less<_KeyType>, typename _Alloc = default_allocator<_ValType>, typename _Node = RbTreeNode<_KeyType, _ValType>, typename _KeyPolicy = rb_unique_keys>
     class RedBlackTree
     {
-        typedef RedBlackTree<_KeyType, _ValType, _Pred, _Alloc> selftype;
-        typedef RbTreeNode<_KeyType, _ValType>                  node_type;
-        typedef typename node_type::node_pointer                node_pointer;
-        typedef typename node_type::const_node_pointer          const_node_pointer;
+        typedef RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy> selftype;
+        typedef typename _Node::node_pointer                    node_pointer;
+        typedef typename _Node::const_node_pointer              const_node_pointer;
+        typedef rb_tree_algorithms<_Node>                       algorithms;
 
         typedef typename 
-        _Alloc::template rebind<node_type>::other               node_allocator_type;
+        _Alloc::template rebind<_Node>::other                   node_allocator_type;
 
         template<typename _KeyType, typename _ValType, typename node_type, typename selftype>
         friend class rb_tree_iterator;
@@ -122,6 +806,7 @@ namespace glare
         typedef _ValType                                        val_type;
         typedef _KeyType                                        key_type;
         typedef _Pred                                           key_compare; // binary predicate.
+        typedef _Node                                           node_type;
 
         typedef typename node_type::value_type                  value_type;
         typedef value_type*                                     pointer;
@@ -137,7 +822,7 @@ namespace glare
         // ---------------------------------------------------------------------------------------------------------
         class const_iterator: public std::iterator<std::bidirectional_iterator_tag, value_type>
         {
-            template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+            template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
             friend class RedBlackTree;
 
         public:
@@ -202,7 +887,7 @@ namespace glare
 
         class iterator: public const_iterator
         {
-            template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+            template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
             friend class RedBlackTree;
 
         public:
@@ -253,7 +938,7 @@ namespace glare
 
         class const_reverse_iterator: public std::iterator<std::bidirectional_iterator_tag, value_type>
         {
-            template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+            template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
             friend class RedBlackTree;
 
         public:
@@ -319,7 +1004,7 @@ namespace glare
 
         class reverse_iterator: public const_reverse_iterator
         {
-            template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+            template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
             friend class RedBlackTree;
 
         public:
@@ -369,6 +1054,77 @@ namespace glare
                 return (m_nodePtr != _right.m_nodePtr);
             }
         };
+
+        // A pair of iterators for range-for, from range().
+        class range_view
+        {
+        public:
+            range_view(const iterator& _first, const iterator& _last): m_first(_first), m_last(_last) {}
+
+            iterator begin() const { return m_first; }
+            iterator end() const { return m_last; }
+            bool empty() const { return m_first == m_last; }
+
+        private:
+            iterator m_first;
+            iterator m_last;
+        };
+
+        // An element extracted with its node, from extract(). Owns the node until it goes back into a tree, or destroys it. Move only.
+        class node_handle
+        {
+            template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+            friend class RedBlackTree;
+
+        public:
+            node_handle(): m_node(nullptr) {}
+            node_handle(node_handle&& _other): m_node(_other.m_node), m_allocator(_other.m_allocator) { _other.m_node = nullptr; }
+            ~node_handle() { reset(); }
+
+            node_handle& operator= (node_handle&& _other)
+            {
+                if (this != &_other)
+                {
+                    reset();
+                    m_node = _other.m_node;
+                    m_allocator = _other.m_allocator;
+                    _other.m_node = nullptr;
+                }
+                return *this;
+            }
+
+            bool empty() const { return m_node == nullptr; }
+
+            // The key can be changed too, the node is in no tree.
+            key_type& key() const
+            {
+                GLARE_ASSERT(m_node != nullptr, "Can't be empty");
+                return m_node->getData().first;
+            }
+            val_type& value() const
+            {
+                GLARE_ASSERT(m_node != nullptr, "Can't be empty");
+                return m_node->getData().second;
+            }
+
+        private:
+            node_handle(node_pointer _nodePtr, const node_allocator_type& _allocator): m_node(_nodePtr), m_allocator(_allocator) {}
+            node_handle(const node_handle&);
+            node_handle& operator= (const node_handle&);
+
+            void reset()
+            {
+                if (m_node)
+                {
+                    m_allocator.destroy(m_node);
+                    m_allocator.deallocate(m_node, 1);
+                    m_node = nullptr;
+                }
+            }
+
+            node_pointer        m_node;
+            node_allocator_type m_allocator;
+        };
         // ---------------------------------------------------------------------------------------------------------
 
         RedBlackTree();
@@ -377,24 +1133,122 @@ namespace glare
         RedBlackTree(const RedBlackTree& _other);
         RedBlackTree& operator= (const RedBlackTree& _other);
 
+        // Deep copy with the subtrees of the top levels copied in parallel on _pool, the node allocator is then called from the pool
+        // threads. Sequential without a pool.
+        RedBlackTree(const RedBlackTree& _other, ThreadPool* _pool);
+
+        // Bulk construction in O(n) rather than n inserts: the nodes are linked into a perfectly balanced tree with its deepest level red.
+        // Pre: [_first, _last) is sorted by key. A repeated key keeps its first element, as insert would.
+        template<typename _InputIterator>
+        RedBlackTree(_InputIterator _first, _InputIterator _last, sorted_tag);
+
+        // Unsorted elements: the nodes are created in input order, stable sorted by key, on _pool when there is one, then linked as above.
+        template<typename _InputIterator>
+        RedBlackTree(_InputIterator _first, _InputIterator _last, ThreadPool* _pool = nullptr);
+
         GLARE_PAIR<iterator, bool> insert(const value_type& _pair);
+        GLARE_PAIR<iterator, bool> insert(value_type&& _pair);
         GLARE_PAIR<iterator, bool> insert(const key_type& _key, const val_type& _value);
 
+        // The key is looked up first and the element is built in the new node only when the key is new: nothing is constructed, copied
+        // or moved for a key already there. emplace builds the key and the value from one argument each, try_emplace takes the key as
+        // is and builds the value from its argument, or from a default constructed value moved in without one.
+        template<typename _KeyArg, typename _ValArg>
+        GLARE_PAIR<iterator, bool> emplace(_KeyArg&& _key, _ValArg&& _value);
+
+        GLARE_PAIR<iterator, bool> try_emplace(const key_type& _key);
+        template<typename _ValArg>
+        GLARE_PAIR<iterator, bool> try_emplace(const key_type& _key, _ValArg&& _value);
+
+        // Hinted insert, returns the element with the key of _pair, inserted or already there. Amortized O(1) when _pair goes right
+        // before _hint, or at the end with end() as the hint; otherwise a plain insert. Inserting each key with the iterator returned
+        // for the previous one fills the tree in order at the cost of an append.
+        iterator insert(iterator _hint, const value_type& _pair);
+
         void erase(const key_type& _key);
         void erase(iterator& _itr);
         void erase(reverse_iterator& _itr);
 
+        // Erases the keys in [_low, _high) and returns their number. The range is split out of the tree and the rest joined back in
+        // O(log n), then its nodes are freed in one go, through the reclaimer when there is one: O(k + log n) rather than k erases.
+        size_type erase(const key_type& _low, const key_type& _high);
+
+        // Moving elements between trees without the allocator: extract unlinks the node and hands it over, empty when _key is not
+        // there; insert links an extracted node back in, into this tree or another one that allocates alike, and leaves _node with
+        // it when its key is already there. merge moves every node of _other whose key this tree lacks, the others stay in _other.
+        // With rb_multi_keys every node is taken.
+        node_handle extract(const key_type& _key);
+        node_handle extract(iterator _itr);
+        GLARE_PAIR<iterator, bool> insert(node_handle&& _node);
+        void merge(RedBlackTree& _other);
+
+        // Nb of elements with _key, 0 or 1 unless keys repeat.
+        size_type count(const key_type& _key) const;
+
         bool exists(const key_type& _key) const;
         bool find(const key_type& _key, val_type& _val) const;
         iterator find(const key_type& _key) const;
 
+        // Ordered seeks in O(log n), then on through the iterators. lower_bound is the first element whose key is not less than _key,
+        // upper_bound the first whose key is greater, end() when there is none.
+        iterator lower_bound(const key_type& _key) const;
+        iterator upper_bound(const key_type& _key) const;
+        GLARE_PAIR<iterator, iterator> equal_range(const key_type& _key) const;
+
+        // The elements with keys in [_low, _high), empty unless _low < _high.
+        //      for (auto& pair : tree.range(10, 20)) ...
+        range_view range(const key_type& _low, const key_type& _high) const;
+
         void clear();
 
         size_type size() { return m_size; }
         bool empty() { return (m_size == 0); }
 
+        // Single pass over the nodes, with the black height read off the leftmost path.
+        TreeStats stats() const;
+
         void swap(RedBlackTree& _tree);
 
+        // Checks the parent links, the RB properties, the key order and the size. O(n), for tests and debugging.
+        bool verify() const;
+
+        // Join and split relink the nodes in O(log n), nothing is copied. Both trees must allocate alike since nodes change hands.
+        // Pre: Every key of this tree is less than every key of _right, or equal to the first ones when keys repeat.
+        // Post: This tree has all the elements, _right is empty.
+        void join(RedBlackTree& _right);
+
+        // Post: This tree keeps the keys less than _key, _right has the others, whatever it had before is cleared. Counting the two parts
+        //       walks the smaller one, so O(log n + min(k, n - k)) for k keys left here.
+        void split(const key_type& _key, RedBlackTree& _right);
+
+        // In place set operations by divide and conquer over split and join, O(m log(n/m + 1)) work for sizes m <= n rather than the
+        // O(m log n) of inserting or erasing one key at a time. With a _pool, the two halves of the top levels run in parallel; the node
+        // allocator is then called from the pool threads. A key in both trees keeps the value of this tree. _other is left untouched.
+        // Unique keys only.
+        void set_union(const RedBlackTree& _other, ThreadPool* _pool = nullptr);
+        void set_intersection(const RedBlackTree& _other, ThreadPool* _pool = nullptr);
+        void set_difference(const RedBlackTree& _other, ThreadPool* _pool = nullptr);
+
+        // Software prefetching for the lookups, off (0) by default. Before comparing against a node both of its children are prefetched,
+        // _lines cache lines each, so the next load overlaps the comparison. Pays off once the tree is well past the last level cache and
+        // the comparison is not trivial, tune _lines with the benchmarks.
+        void setPrefetchDistance(unsigned int _lines) { m_prefetchLines = _lines; }
+        unsigned int prefetchDistance() const { return m_prefetchLines; }
+
+        // Freeing on a background thread, off (nullptr) by default: clear() and the destructor detach the nodes and hand them to
+        // _reclaimer, so they return in O(1). Not copied nor swapped with the tree. With an allocator that frees in bulk and nodes
+        // without a destructor, the nodes are simply dropped and there is nothing to hand over.
+        void setReclaimer(Reclaimer* _reclaimer) { m_reclaimer = _reclaimer; }
+        Reclaimer* reclaimer() const { return m_reclaimer; }
+
+        key_compare key_comp() const { return m_binPredicate; }
+
+        // The root node, nullptr when empty, for the queries of RbTreeAugment.h that descend the tree. Don't relink through it.
+        node_type* root() const { return m_root; }
+
+        // Augmented nodes: recomputes the metadata above _itr after its value was changed in place. Nothing to do for the other nodes.
+        void refresh(const iterator& _itr) { algorithms::augment_path(_itr.m_nodePtr); }
+
         iterator begin()
         { 
             return iterator(m_leftmost); // minimum(m_root)
@@ -414,31 +1268,72 @@ namespace glare
         }
 
     private:
-        // Core
+        // Core, the balancing itself is done by rb_tree_algorithms.
         bool rb_insert(const value_type& _pair, node_pointer& _newNodePtr);
-        void rb_insert_fixup(node_pointer _newNodePtr);
-        
+        bool rb_insert_hint(node_pointer _hint, const value_type& _pair, node_pointer& _retNodePtr);
+        node_pointer rb_link_new(node_pointer _parent, bool _left, const value_type& _pair);
+        node_pointer rb_link_node(node_pointer _parent, bool _left, node_pointer _newNodePtr);
+
+        // Post: Returns the node holding _key if there is one, else nullptr with _parent and _left telling where it goes.
+        node_pointer find_insert_position(const key_type& _key, node_pointer& _parent, bool& _left) const;
         void rb_remove(node_pointer _nodeToDelete);
-        void rb_remove_fixup(node_pointer x, node_pointer xp);
 
         node_pointer bst_find(const key_type& _key) const;
 
-        // Helpers
-        void transplant(node_pointer _u, node_pointer _v);
-        void rotate_right(node_pointer _subRootPtr);
-        void rotate_left(node_pointer _subRootPtr);
+        // Post: The first node whose key is greater than _key, or not less than _key unless _upper; nullptr when there is none.
+        node_pointer bst_bound(const key_type& _key, bool _upper) const;
+
+        // Post-Order style clean up, returns the nb of nodes freed. Static so the nodes can be freed on a reclaimer thread after the
+        // tree is gone.
+        static size_type internal_clean(node_allocator_type& _allocator, node_pointer _subRoot);
 
-        // Post-Order style clean up.
-        void internal_clean(node_pointer _subRoot);
+        // Post: The nodes of the detached _subRoot are gone: dropped when the allocator frees in bulk and they have no destructor,
+        //       handed to the reclaimer when there is one, freed here otherwise. Returns their number when _count, else 0.
+        size_type dispose(node_pointer _subRoot, bool _count);
+        static size_type count_nodes(const_node_pointer _subRoot);
 
-        // Pre-Order style copy.
-        void internal_copy(node_pointer& _copySubroot, const_node_pointer _originalSubroot, node_pointer _parent);
+        // Pre-Order style copy, returns the copy of _originalSubroot. The size is up to the caller. The two subtrees are copied in
+        // parallel for _forkDepth levels.
+        node_pointer internal_copy(const_node_pointer _originalSubroot, node_pointer _parent, ThreadPool* _pool = nullptr, unsigned int _forkDepth = 0);
+
+        // A tree detached for join/split: nullptr or a black root without parent, and its black height.
+        struct subtree
+        {
+            node_pointer    m_root;
+            int             m_blackHeight;
+
+            subtree(): m_root(nullptr), m_blackHeight(0) {}
+            subtree(node_pointer _root, int _blackHeight): m_root(_root), m_blackHeight(_blackHeight) {}
+        };
+
+        subtree release();
+        void adopt(const subtree& _tree, size_type _size);
+
+        // Bulk construction, _nodes are in key order without repeats.
+        void adopt_sorted(const GLARE_VECTOR<node_pointer>& _nodes);
+        static node_pointer link_balanced(const node_pointer* _nodes, size_type _count, node_pointer _parent, int _depth, int _redDepth);
+
+        static subtree detach_child(node_pointer _child, const subtree& _parent);
+        static subtree join_subtrees(const subtree& _left, node_pointer _middle, const subtree& _right);
+        static subtree join_subtrees(const subtree& _left, const subtree& _right);
+        node_pointer split_subtree(subtree _tree, const key_type& _key, subtree& _less, subtree& _greater) const;
+
+        // _other is a subtree of the other tree, _otherBlackHeight counts its root. _common gets the number of keys found in both.
+        subtree union_subtrees(subtree _tree, const_node_pointer _other, int _otherBlackHeight, size_type& _common, ThreadPool* _pool, unsigned int _forkDepth);
+        subtree intersect_subtrees(subtree _tree, const_node_pointer _other, size_type& _common, ThreadPool* _pool, unsigned int _forkDepth);
+        subtree subtract_subtrees(subtree _tree, const_node_pointer _other, size_type& _common, ThreadPool* _pool, unsigned int _forkDepth);
         
         // Static Helpers
-        static node_pointer minimum(node_pointer _u);
-        static node_pointer maximum(node_pointer _u);
-        static node_pointer successor(node_pointer _x);
-        static node_pointer predecessor(node_pointer _x);
+        // True when _key can come right after _previous in the tree: greater, or equal too when keys repeat.
+        bool key_follows(const key_type& _previous, const key_type& _key) const
+        {
+            return _KeyPolicy::multi ? !m_binPredicate(_key, _previous) : m_binPredicate(_previous, _key);
+        }
+
+        static node_pointer minimum(node_pointer _u)        { return algorithms::minimum(_u); }
+        static node_pointer maximum(node_pointer _u)        { return algorithms::maximum(_u); }
+        static node_pointer successor(node_pointer _x)      { return algorithms::successor(_x); }
+        static node_pointer predecessor(node_pointer _x)    { return algorithms::predecessor(_x); }
 
         template<typename T>
         typename T::pointer createObject(T& _alloc)
@@ -449,15 +1344,23 @@ namespace glare
         }
 
         template<typename T, typename VAL>
-        typename T::pointer createObject(T& _alloc, const VAL& _value)
+        typename T::pointer createObject(T& _alloc, VAL&& _value)
+        {
+            typename T::pointer ptr = _alloc.allocate(1);
+            _alloc.construct(ptr, std::forward<VAL>(_value));
+            return ptr;
+        }
+
+        template<typename T, typename KEY, typename VAL>
+        typename T::pointer createObject(T& _alloc, KEY&& _key, VAL&& _value)
         {
             typename T::pointer ptr = _alloc.allocate(1);
-            _alloc.construct(ptr, _value);
+            _alloc.construct(ptr, std::forward<KEY>(_key), std::forward<VAL>(_value));
             return ptr;
         }
 
         template<typename T>
-        void destroyObject(T& _alloc, typename T::pointer _ptr)
+        static void destroyObject(T& _alloc, typename T::pointer _ptr)
         {
             _alloc.destroy(_ptr);
             _alloc.deallocate(_ptr, 1);
@@ -469,30 +1372,37 @@ namespace glare
         node_pointer        m_rightmost;  // Rightmost(the highest key) node stays rightmost till we insert an even higher key-value node than this is.
         key_compare         m_binPredicate;
         node_allocator_type m_nodeAllocator;
+        unsigned int        m_prefetchLines;
+        Reclaimer*          m_reclaimer;
     };
     
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::RedBlackTree(): m_size(0)
-                                                                   , m_root(nullptr)
-                                                                   , m_leftmost(nullptr)
-                                                                   , m_rightmost(nullptr)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::RedBlackTree(): m_size(0)
+                                                                          , m_root(nullptr)
+                                                                          , m_leftmost(nullptr)
+                                                                          , m_rightmost(nullptr)
+                                                                          , m_prefetchLines(0)
+                                                                          , m_reclaimer(nullptr)
     {
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::~RedBlackTree()
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::~RedBlackTree()
     {
         clear();
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::RedBlackTree(const RedBlackTree& _other): m_size(0)
-                                                                                             , m_root(nullptr)
-                                                                                             , m_leftmost(nullptr)
-                                                                                             , m_rightmost(nullptr)
-                                                                                             , m_binPredicate(_other.m_binPredicate)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::RedBlackTree(const RedBlackTree& _other): m_size(0)
+                                                                                                    , m_root(nullptr)
+                                                                                                    , m_leftmost(nullptr)
+                                                                                                    , m_rightmost(nullptr)
+                                                                                                    , m_binPredicate(_other.m_binPredicate)
+                                                                                                    , m_prefetchLines(_other.m_prefetchLines)
+                                                                                                    , m_reclaimer(nullptr)
     {
-        internal_copy(m_root, _other.m_root, nullptr); // parent of m_root is nullptr.
+        m_root = internal_copy(_other.m_root, nullptr); // parent of m_root is nullptr.
+        m_size = _other.m_size;
         if (m_root == nullptr)
         {
             m_leftmost = nullptr;
@@ -505,13 +1415,87 @@ namespace glare
         }
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>& RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::operator= (const RedBlackTree& _right)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::RedBlackTree(const RedBlackTree& _other, ThreadPool* _pool): m_size(0)
+                                                                                                                       , m_root(nullptr)
+                                                                                                                       , m_leftmost(nullptr)
+                                                                                                                       , m_rightmost(nullptr)
+                                                                                                                       , m_binPredicate(_other.m_binPredicate)
+                                                                                                                       , m_prefetchLines(_other.m_prefetchLines)
+                                                                                                                       , m_reclaimer(nullptr)
+    {
+        m_root = internal_copy(_other.m_root, nullptr, _pool, _pool ? parallel_fork_depth(*_pool) : 0);
+        m_size = _other.m_size;
+        if (m_root)
+        {
+            m_leftmost = minimum(m_root);
+            m_rightmost = maximum(m_root);
+        }
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    template<typename _InputIterator>
+    RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::RedBlackTree(_InputIterator _first, _InputIterator _last, sorted_tag): m_size(0)
+                                                                                                                               , m_root(nullptr)
+                                                                                                                               , m_leftmost(nullptr)
+                                                                                                                               , m_rightmost(nullptr)
+                                                                                                                               , m_prefetchLines(0)
+                                                                                                                               , m_reclaimer(nullptr)
+    {
+        GLARE_VECTOR<node_pointer> nodes;
+        for (; _first != _last; ++_first)
+        {
+            if (!nodes.empty() && !key_follows(nodes.back()->key(), _first->first))
+            {
+                GLARE_ASSERT(!m_binPredicate(_first->first, nodes.back()->key()), "The range must be sorted by key");
+                continue; // Repeated key.
+            }
+            nodes.push_back(createObject(m_nodeAllocator, *_first));
+        }
+
+        adopt_sorted(nodes);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    template<typename _InputIterator>
+    RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::RedBlackTree(_InputIterator _first, _InputIterator _last, ThreadPool* _pool): m_size(0)
+                                                                                                                                      , m_root(nullptr)
+                                                                                                                                      , m_leftmost(nullptr)
+                                                                                                                                      , m_rightmost(nullptr)
+                                                                                                                                      , m_prefetchLines(0)
+                                                                                                                                      , m_reclaimer(nullptr)
+    {
+        // Sorting the nodes rather than the elements, each element is copied once.
+        GLARE_VECTOR<node_pointer> nodes;
+        for (; _first != _last; ++_first)
+            nodes.push_back(createObject(m_nodeAllocator, *_first));
+
+        const key_compare& predicate = m_binPredicate;
+        parallel_stable_sort(nodes.begin(), nodes.end(), 
+                             [&predicate](node_pointer _left, node_pointer _right) { return predicate(_left->key(), _right->key()); }, _pool);
+
+        // Stable, so the first of a repeated key is the one inserted first, and repeated keys keep their input order when kept.
+        size_type unique = 0;
+        for (size_type i = 0; i < nodes.size(); ++i)
+        {
+            if (unique && !key_follows(nodes[unique - 1]->key(), nodes[i]->key()))
+                destroyObject(m_nodeAllocator, nodes[i]);
+            else
+                nodes[unique++] = nodes[i];
+        }
+        nodes.resize(unique);
+
+        adopt_sorted(nodes);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>& RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::operator= (const RedBlackTree& _right)
     {
         if (this != &_right)
         {
             clear();
-            internal_copy(m_root, _right.m_root, nullptr); // parent of m_root is nullptr.
+            m_root = internal_copy(_right.m_root, nullptr); // parent of m_root is nullptr.
+            m_size = _right.m_size;
             
             if (m_root == nullptr)
             {
@@ -525,563 +1509,835 @@ namespace glare
             }
 
             m_binPredicate = _right.m_binPredicate;
+            m_prefetchLines = _right.m_prefetchLines;
         }
         return *this;
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    GLARE_PAIR<typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::iterator, bool> RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::insert(const value_type& _pair)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    GLARE_PAIR<typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::iterator, bool> RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::insert(const value_type& _pair)
     {
         iterator nodeItr;
         bool result = rb_insert(_pair, nodeItr.m_nodePtr);
         return GLARE_PAIR<iterator, bool>(nodeItr, result);
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    GLARE_PAIR<typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::iterator, bool> RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::insert(const key_type& _key, const val_type& _value)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    GLARE_PAIR<typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::iterator, bool> RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::insert(value_type&& _pair)
+    {
+        node_pointer parentPtr = nullptr;
+        bool linkLeft = false;
+        if (node_pointer existing = find_insert_position(_pair.first, parentPtr, linkLeft))
+            return GLARE_PAIR<iterator, bool>(iterator(existing), false);
+
+        node_pointer newNodePtr = createObject(m_nodeAllocator, std::move(_pair));
+        return GLARE_PAIR<iterator, bool>(iterator(rb_link_node(parentPtr, linkLeft, newNodePtr)), true);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    GLARE_PAIR<typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::iterator, bool> RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::insert(const key_type& _key, const val_type& _value)
+    {
+        return try_emplace(_key, _value); // Copied once, straight into the node.
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    template<typename _KeyArg, typename _ValArg>
+    GLARE_PAIR<typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::iterator, bool> RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::emplace(_KeyArg&& _key, _ValArg&& _value)
+    {
+        const key_type& key = _key; // The argument itself when it is a key_type, it is only forwarded once we are done with it.
+        node_pointer parentPtr = nullptr;
+        bool linkLeft = false;
+        if (node_pointer existing = find_insert_position(key, parentPtr, linkLeft))
+            return GLARE_PAIR<iterator, bool>(iterator(existing), false);
+
+        node_pointer newNodePtr = createObject(m_nodeAllocator, std::forward<_KeyArg>(_key), std::forward<_ValArg>(_value));
+        return GLARE_PAIR<iterator, bool>(iterator(rb_link_node(parentPtr, linkLeft, newNodePtr)), true);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    GLARE_PAIR<typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::iterator, bool> RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::try_emplace(const key_type& _key)
+    {
+        node_pointer parentPtr = nullptr;
+        bool linkLeft = false;
+        if (node_pointer existing = find_insert_position(_key, parentPtr, linkLeft))
+            return GLARE_PAIR<iterator, bool>(iterator(existing), false);
+
+        node_pointer newNodePtr = createObject(m_nodeAllocator, _key, val_type());
+        return GLARE_PAIR<iterator, bool>(iterator(rb_link_node(parentPtr, linkLeft, newNodePtr)), true);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    template<typename _ValArg>
+    GLARE_PAIR<typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::iterator, bool> RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::try_emplace(const key_type& _key, _ValArg&& _value)
+    {
+        node_pointer parentPtr = nullptr;
+        bool linkLeft = false;
+        if (node_pointer existing = find_insert_position(_key, parentPtr, linkLeft))
+            return GLARE_PAIR<iterator, bool>(iterator(existing), false);
+
+        node_pointer newNodePtr = createObject(m_nodeAllocator, _key, std::forward<_ValArg>(_value));
+        return GLARE_PAIR<iterator, bool>(iterator(rb_link_node(parentPtr, linkLeft, newNodePtr)), true);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::iterator 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::insert(iterator _hint, const value_type& _pair)
+    {
+        iterator nodeItr;
+        rb_insert_hint(_hint.m_nodePtr, _pair, nodeItr.m_nodePtr);
+        return nodeItr;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    bool RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::rb_insert(const value_type& _pair, node_pointer& _retNodePtr)
     {
-        return insert(value_type(_key, _value));
+        node_pointer parentPtr = nullptr;
+        bool linkLeft = false;
+        if (node_pointer existing = find_insert_position(_pair.first, parentPtr, linkLeft))
+        {
+            _retNodePtr = existing;
+            return false; // Duplicate!
+        }
+
+        _retNodePtr = rb_link_new(parentPtr, linkLeft, _pair);
+        return true;
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    bool RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::rb_insert(const value_type& _pair, node_pointer& _retNodePtr)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::node_pointer 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::find_insert_position(const key_type& _key, node_pointer& _parent, bool& _left) const
     {
+        // Keys arriving in increasing order go right of the rightmost node, no need to descend from the root.
+        if (m_rightmost && key_follows(m_rightmost->key(), _key))
+        {
+            _parent = m_rightmost;
+            _left = false;
+            return nullptr;
+        }
+
         node_pointer parentPtr = nullptr, currentPtr = m_root;
         
         while(currentPtr != nullptr)
         {
             parentPtr = currentPtr;
-            if (m_binPredicate(_pair.first, currentPtr->key())) // less_than(givenKey, currentPtr->key())
-                currentPtr = currentPtr->m_left;
-            else if (_pair.first == currentPtr->key()) 
-            {
-                _retNodePtr = currentPtr;
-                return false; // Duplicate!
-            }
+            if (m_binPredicate(_key, currentPtr->key())) // less_than(givenKey, currentPtr->key())
+                currentPtr = currentPtr->left();
+            else if (!_KeyPolicy::multi && _key == currentPtr->key()) 
+                return currentPtr; // Duplicate!
             else
-                currentPtr = currentPtr->m_right;
+                currentPtr = currentPtr->right(); // Repeated keys go after their equals.
         }
 
-        node_pointer newNodePtr = createObject(m_nodeAllocator, _pair);
-        newNodePtr->m_parent = parentPtr;
-        // newNodePtr->color(node_type::Red); // Red by default, no need to mention!
-        _retNodePtr = newNodePtr;
-        
-        if(parentPtr) 
+        _parent = parentPtr;
+        _left = parentPtr && m_binPredicate(_key, parentPtr->key()); // less_than(givenKey, parentPtr->key())
+        return nullptr;
+    }
+
+    // The new key goes between the predecessor and the successor of _hint when it is not _hint's own key: a free child link is then
+    // found on one of the two, since of two nodes adjacent in order one is an ancestor of the other with the link between them empty.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    bool RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::rb_insert_hint(node_pointer _hint, const value_type& _pair, node_pointer& _retNodePtr)
+    {
+        const key_type& newKey = _pair.first;
+
+        if (_hint == nullptr) // end()
         {
-            if (m_binPredicate(_pair.first, parentPtr->key())) // less_than(givenKey, currentPtr->key())
+            if (m_rightmost && key_follows(m_rightmost->key(), newKey))
             {
-                parentPtr->m_left = newNodePtr;
-                if (parentPtr == m_leftmost)
-                    m_leftmost = newNodePtr;
+                _retNodePtr = rb_link_new(m_rightmost, false, _pair);
+                return true;
             }
-            else
+        }
+        else if (m_binPredicate(newKey, _hint->key())) // Goes before _hint?
+        {
+            if (_hint == m_leftmost)
             {
-                parentPtr->m_right = newNodePtr;
-                if (parentPtr == m_rightmost)
-                    m_rightmost = newNodePtr;
+                _retNodePtr = rb_link_new(_hint, true, _pair);
+                return true;
             }
 
-            rb_insert_fixup(newNodePtr); // This is the only case when we need to fix the insertion.
+            node_pointer before = predecessor(_hint);
+            if (key_follows(before->key(), newKey))
+            {
+                if (before->right() == nullptr)
+                    _retNodePtr = rb_link_new(before, false, _pair);
+                else
+                    _retNodePtr = rb_link_new(_hint, true, _pair);
+                return true;
+            }
         }
-        else
+        else if (m_binPredicate(_hint->key(), newKey)) // Goes after _hint?
         {
-            m_root = newNodePtr;
-            m_leftmost = newNodePtr;
-            m_rightmost = newNodePtr;
-            m_root->color(node_type::Black);
-            // Insertion shouldn't be a problem as it is the first node to be inserted in the tree, need not be fixed.
+            if (_hint == m_rightmost)
+            {
+                _retNodePtr = rb_link_new(_hint, false, _pair);
+                return true;
+            }
+
+            node_pointer after = successor(_hint);
+            if (m_binPredicate(newKey, after->key()))
+            {
+                if (_hint->right() == nullptr)
+                    _retNodePtr = rb_link_new(_hint, false, _pair);
+                else
+                    _retNodePtr = rb_link_new(after, true, _pair);
+                return true;
+            }
         }
+        else if (!_KeyPolicy::multi)
+        {
+            _retNodePtr = _hint;
+            return false; // Duplicate!
+        }
+
+        return rb_insert(_pair, _retNodePtr); // Wrong hint, or a repeated key that goes after all its equals.
+    }
+
+    // Pre: _parent's _left (or right) link is free and the new key belongs there, nullptr _parent when the tree is empty.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::node_pointer 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::rb_link_new(node_pointer _parent, bool _left, const value_type& _pair)
+    {
+        return rb_link_node(_parent, _left, createObject(m_nodeAllocator, _pair));
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::node_pointer 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::rb_link_node(node_pointer _parent, bool _left, node_pointer _newNodePtr)
+    {
+        algorithms::rb_link(m_root, m_leftmost, m_rightmost, _parent, _left, _newNodePtr);
         
         ++m_size; // We now have a completely balanced RB Tree with 1 more node.
-        return true;
+        return _newNodePtr;
     }
     
-    // Pre: The insertion might have violated the RBTree properties by having a red node with red parent.
-    // Post: The RB properties hold true and the tree becomes a legit RBtree.
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::rb_insert_fixup(node_pointer _newNodePtr)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::erase(const key_type& _key)
     {
-        // Following loop invariant is true prior to the first iteration of the loop, 
-        // and each iteration maintains the loop invariant:
-        //
-        // a. Node Z is red, where Z is the newly inserted node prior to call.
-        // b. If Z.p is the root, then Z.p is black and did not change prior to the call.
-        // c. If the tree violates any of the red-black properties, then it violates at most
-        //    one of them, and the violation is of either property 2 or property 4. If the
-        //    tree violates property 2, it is because Z is the root and is red. If the tree
-        //    violates property 4, it is because both Z and Z.p are red.
-        
-        GLARE_ASSERT(_newNodePtr && _newNodePtr->m_parent, "Both should exist for the violation to happen");
+        node_pointer nodeToDelete = bst_find(_key);
+        while (nodeToDelete)
+        {
+            node_pointer next = _KeyPolicy::multi ? successor(nodeToDelete) : nullptr; // Nodes are relinked, not moved: next stays valid.
+            rb_remove(nodeToDelete);
+            nodeToDelete = (next && !m_binPredicate(_key, next->key())) ? next : nullptr;
+        }
+    }
+
+    // Split off what is below _low, then what is not below _high, and join the two outer parts back without the middle one.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::size_type 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::erase(const key_type& _low, const key_type& _high)
+    {
+        if (m_root == nullptr || !m_binPredicate(_low, _high))
+            return 0;
+
+        const size_type size = m_size;
+        subtree less, rest, range, greater;
+        if (node_pointer match = split_subtree(release(), _low, less, rest))
+            rest = join_subtrees(subtree(), match, rest);       // _low itself is erased.
+        if (node_pointer match = split_subtree(rest, _high, range, greater))
+            greater = join_subtrees(subtree(), match, greater); // _high itself stays.
+
+        const size_type erased = dispose(range.m_root, true);
+        adopt(join_subtrees(less, greater), size - erased);
+        return erased;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::size_type 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::count(const key_type& _key) const
+    {
+        size_type result = 0;
+        for (node_pointer current = bst_find(_key); current && !m_binPredicate(_key, current->key()); current = successor(current))
+            ++result;
+        return result;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::erase(iterator& _itr)
+    {
+        if (_itr.m_nodePtr)
+            rb_remove(_itr.m_nodePtr);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::erase(reverse_iterator& _itr)
+    {
+        if (_itr.m_nodePtr)
+            rb_remove(_itr.m_nodePtr);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::node_handle 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::extract(const key_type& _key)
+    {
+        return extract(iterator(bst_find(_key)));
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::node_handle 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::extract(iterator _itr)
+    {
+        if (_itr.m_nodePtr == nullptr)
+            return node_handle();
+
+        algorithms::rb_remove(m_root, m_leftmost, m_rightmost, _itr.m_nodePtr); // Unlinked, the links are reset when it is linked again.
+        --m_size;
+        return node_handle(_itr.m_nodePtr, m_nodeAllocator);
+    }
 
-        while (_newNodePtr != m_root && _newNodePtr->m_parent->color() == node_type::Red)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    GLARE_PAIR<typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::iterator, bool> RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::insert(node_handle&& _node)
+    {
+        if (_node.empty())
+            return GLARE_PAIR<iterator, bool>(end(), false);
+
+        node_pointer parentPtr = nullptr;
+        bool linkLeft = false;
+        if (node_pointer existing = find_insert_position(_node.key(), parentPtr, linkLeft))
+            return GLARE_PAIR<iterator, bool>(iterator(existing), false); // _node keeps its node.
+
+        node_pointer nodePtr = _node.m_node;
+        _node.m_node = nullptr;
+        return GLARE_PAIR<iterator, bool>(iterator(rb_link_node(parentPtr, linkLeft, nodePtr)), true);
+    }
+
+    // In key order, so the keys of _other above ours take the rightmost fast path of find_insert_position.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::merge(RedBlackTree& _other)
+    {
+        if (this == &_other)
+            return;
+
+        for (node_pointer currentPtr = _other.m_leftmost; currentPtr != nullptr; )
         {
-            node_pointer grandParentPtr = _newNodePtr->m_parent->m_parent;
-            if (_newNodePtr->m_parent == grandParentPtr->m_left)
+            node_pointer nextPtr = successor(currentPtr);
+
+            node_pointer parentPtr = nullptr;
+            bool linkLeft = false;
+            if (find_insert_position(currentPtr->key(), parentPtr, linkLeft) == nullptr)
             {
-                node_pointer auntPtr = grandParentPtr->m_right;
-                if (auntPtr && auntPtr->color() == node_type::Red)
-                {
-                    // Case 1: _newNodePtr, _newNodePtr->m_parent, auntPtr all red; flip color.
-                    _newNodePtr->m_parent->color(node_type::Black);                  
-                    auntPtr->color(node_type::Black);
-                    grandParentPtr->color(node_type::Red);
-                    _newNodePtr = grandParentPtr; // Problem is passed 2 levels up the tree.
-                }
-                else
-                { 
-                    // Aunt is black, this means at least 1 rotation will happen.
-                    if (_newNodePtr == _newNodePtr->m_parent->m_right) // Do we need a double rotation?
-                    {
-                        // Case 2: Violation is made by having a red node on a zig-zag path.
-                        _newNodePtr = _newNodePtr->m_parent; // Parent becomes left child of its current child after rotation, basically transforming to case 3.
-                        rotate_left(_newNodePtr); // grandParentPtr is still the same and Case 3 is converted to Case 2.
-                    }
-                    // Case 3: Simple Zig-Zig case, 1 rotation will suffice.
-                    _newNodePtr->m_parent->color(node_type::Black); // If its a Case 3 then this is the updated parent after left rotation.
-                    grandParentPtr->color(node_type::Red);
-                    rotate_right(grandParentPtr);
-                }
+                algorithms::rb_remove(_other.m_root, _other.m_leftmost, _other.m_rightmost, currentPtr);
+                --_other.m_size;
+                rb_link_node(parentPtr, linkLeft, currentPtr);
+            }
+
+            currentPtr = nextPtr;
+        }
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::rb_remove(node_pointer _nodeToDelete)
+    {
+        algorithms::rb_remove(m_root, m_leftmost, m_rightmost, _nodeToDelete);
+
+        destroyObject(m_nodeAllocator, _nodeToDelete); // Delete the actual node now!
+        --m_size; // We have 1 less number of nodes now.
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    inline typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::node_pointer 
+    RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::bst_find(const key_type& _key) const
+    {
+        if (_KeyPolicy::multi) // The first of the equal keys, an equal one higher up may not be.
+        {
+            node_pointer lowerPtr = bst_bound(_key, false);
+            return (lowerPtr && !m_binPredicate(_key, lowerPtr->key())) ? lowerPtr : nullptr;
+        }
+
+        node_pointer currentPtr = m_root;
+
+        while(currentPtr != nullptr)
+        {
+            if (m_prefetchLines)
+            {
+                prefetch_lines(currentPtr->left(), m_prefetchLines);
+                prefetch_lines(currentPtr->right(), m_prefetchLines);
+            }
+
+            if (m_binPredicate(_key, currentPtr->key())) // less_than(givenKey, currentPtr->key())
+                currentPtr = currentPtr->left();
+            else if (_key == currentPtr->key())
+                break; // Found!
+            else
+                currentPtr = currentPtr->right();
+        }
+
+        return currentPtr; 
+    }
+
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    bool RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::exists(const key_type& _key) const
+    {
+        return (bst_find(_key) != nullptr);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    bool RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::find(const key_type& _key, val_type& _val) const
+    {
+        if(node_pointer nodePtr = bst_find(_key))
+        {
+            _val = nodePtr->value();
+            return true;
+
+        }
+        return false;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::iterator 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::find(const key_type& _key) const
+    {
+        return iterator(bst_find(_key));
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::node_pointer 
+    RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::bst_bound(const key_type& _key, bool _upper) const
+    {
+        node_pointer currentPtr = m_root;
+        node_pointer boundPtr = nullptr; // The last node we went left from.
+
+        while(currentPtr != nullptr)
+        {
+            if (m_prefetchLines)
+            {
+                prefetch_lines(currentPtr->left(), m_prefetchLines);
+                prefetch_lines(currentPtr->right(), m_prefetchLines);
+            }
+
+            if (_upper ? m_binPredicate(_key, currentPtr->key()) : !m_binPredicate(currentPtr->key(), _key))
+            {
+                boundPtr = currentPtr;
+                currentPtr = currentPtr->left();
             }
             else
             {
-                // New node' parent is the right child of its grand parent!
-                node_pointer auntPtr = grandParentPtr->m_left;
-                if (auntPtr && auntPtr->color() == node_type::Red)
-                {
-                    // Case 1: _newNodePtr, _newNodePtr->m_parent, auntPtr all red; flip color.
-                    _newNodePtr->m_parent->color(node_type::Black);
-                    auntPtr->color(node_type::Black);
-                    grandParentPtr->color(node_type::Red);
-                    _newNodePtr = grandParentPtr; // Problem is passed 2 levels up the tree.
-                }
-                else
-                {
-                    // Aunt is black, this means at least 1 rotation will happen.
-                    if (_newNodePtr == _newNodePtr->m_parent->m_left) // Do we need a double rotation?
-                    {
-                        // Case 2: Violation is made by adding a red node on a zag-zig path.
-                        _newNodePtr = _newNodePtr->m_parent; // Transforming to case 3, _newNodePtr will be the violating Red Condition node after rotation.
-                        rotate_right(_newNodePtr); // Transformed, now _newNodePtr points to the child that really violates the red condition!
-                    }
-                    // Case 3: Simple Zig-Zig case, 1 rotation will suffice.
-                    _newNodePtr->m_parent->color(node_type::Black);
-                    grandParentPtr->color(node_type::Red);
-                    rotate_left(grandParentPtr);
-                }
+                currentPtr = currentPtr->right();
+            }
+        }
+
+        return boundPtr;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::iterator 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::lower_bound(const key_type& _key) const
+    {
+        return iterator(bst_bound(_key, false));
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::iterator 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::upper_bound(const key_type& _key) const
+    {
+        return iterator(bst_bound(_key, true));
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    GLARE_PAIR<typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::iterator, typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::iterator> 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::equal_range(const key_type& _key) const
+    {
+        return GLARE_PAIR<iterator, iterator>(lower_bound(_key), upper_bound(_key));
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::range_view 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::range(const key_type& _low, const key_type& _high) const
+    {
+        if (!m_binPredicate(_low, _high))
+            return range_view(iterator(nullptr), iterator(nullptr)); // lower_bound(_high) could come first, and never be reached.
+
+        return range_view(lower_bound(_low), lower_bound(_high));
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    TreeStats RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::stats() const
+    {
+        TreeStats result;
+        binary_tree_stats(static_cast<const_node_pointer>(m_root), result);
+        result.m_size = m_size;
+        result.m_bytes = result.m_nodeCount * sizeof(node_type);
+
+        // Property #5, every path has as many black nodes, so any one of them will do.
+        for (const_node_pointer current = m_root; current != nullptr; current = current->left())
+        {
+            if (current->isBlack()) {
+                ++result.m_blackHeight;
             }
         }
-        m_root->color(node_type::Black);
+
+        GLARE_ASSERT(result.m_nodeCount == m_size, "Fatal Error: The size doesn't match the nb of nodes.");
+        return result;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    bool RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::verify() const
+    {
+        if (m_root && (m_root->isRed() || m_root->parent() != nullptr))
+            return false;
+
+        if (algorithms::rb_verify(m_root) < 0)
+            return false;
+
+        size_type count = 0;
+        for (node_pointer current = m_leftmost, previous = nullptr; current != nullptr; previous = current, current = successor(current), ++count)
+        {
+            if (previous && !key_follows(previous->key(), current->key()))
+                return false;
+        }
+
+        return count == m_size
+            && m_leftmost == (m_root ? minimum(m_root) : nullptr)
+            && m_rightmost == (m_root ? maximum(m_root) : nullptr);
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::rotate_right(node_pointer _subRootPtr)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::join(RedBlackTree& _right)
     {
-        GLARE_ASSERT(_subRootPtr && _subRootPtr->m_left, "[RBTree][Logic Fail] This impossible situation shouldn't have arised.");
+        if (this == &_right || _right.m_root == nullptr)
+            return;
 
-        node_pointer leftSubtree = _subRootPtr->m_left;
-        _subRootPtr->m_left = leftSubtree->m_right;
+        GLARE_ASSERT(m_root == nullptr || key_follows(m_rightmost->key(), _right.m_leftmost->key()), "Every key of this tree must be less than the keys of _right");
 
-        if (leftSubtree->m_right)
-            leftSubtree->m_right->m_parent = _subRootPtr;
+        // The smallest node of _right goes in between.
+        const size_type size = m_size + _right.m_size;
+        node_pointer middle = _right.m_leftmost;
+        algorithms::rb_remove(_right.m_root, _right.m_leftmost, _right.m_rightmost, middle);
 
-        leftSubtree->m_parent = _subRootPtr->m_parent;
+        subtree right = _right.release();
+        adopt(join_subtrees(release(), middle, right), size);
+    }
 
-        if (_subRootPtr->m_parent)
-        {
-            if (_subRootPtr == _subRootPtr->m_parent->m_left)
-                _subRootPtr->m_parent->m_left = leftSubtree;
-            else
-                _subRootPtr->m_parent->m_right = leftSubtree;
-        }
-        else
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::split(const key_type& _key, RedBlackTree& _right)
+    {
+        if (this == &_right)
+            return;
+
+        _right.clear();
+
+        const size_type size = m_size;
+        subtree less, greater;
+        if (node_pointer match = split_subtree(release(), _key, less, greater))
+            greater = join_subtrees(subtree(), match, greater); // _key itself goes right.
+
+        // Walk both parts together, the first to run out gives its size.
+        size_type steps = 0;
+        node_pointer lessPtr = less.m_root ? minimum(less.m_root) : nullptr;
+        node_pointer greaterPtr = greater.m_root ? minimum(greater.m_root) : nullptr;
+        for (; lessPtr && greaterPtr; ++steps)
         {
-            m_root = leftSubtree;
+            lessPtr = successor(lessPtr);
+            greaterPtr = successor(greaterPtr);
         }
+        const size_type lessSize = (lessPtr == nullptr) ? steps : size - steps;
 
-        leftSubtree->m_right = _subRootPtr;
-        _subRootPtr->m_parent = leftSubtree;
+        adopt(less, lessSize);
+        _right.adopt(greater, size - lessSize);
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::rotate_left(node_pointer _subRootPtr)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::set_union(const RedBlackTree& _other, ThreadPool* _pool)
     {
-        GLARE_ASSERT(_subRootPtr && _subRootPtr->m_right, "[RBTree][Logic Fail] This impossible situation shouldn't have arised.");
+        static_assert(!_KeyPolicy::multi, "Set operations need unique keys");
+        if (this == &_other || _other.m_root == nullptr)
+            return;
 
-        node_pointer rightSubtree = _subRootPtr->m_right;
-        _subRootPtr->m_right = rightSubtree->m_left;
+        size_type common = 0;
+        const size_type size = m_size + _other.m_size;
+        const unsigned int forkDepth = _pool ? parallel_fork_depth(*_pool) : 0;
 
-        if(rightSubtree->m_left)
-            rightSubtree->m_left->m_parent = _subRootPtr;
+        subtree result = union_subtrees(release(), _other.m_root, algorithms::black_height(_other.m_root), common, _pool, forkDepth);
+        adopt(result, size - common);
+    }
 
-        rightSubtree->m_parent = _subRootPtr->m_parent;
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::set_intersection(const RedBlackTree& _other, ThreadPool* _pool)
+    {
+        static_assert(!_KeyPolicy::multi, "Set operations need unique keys");
+        if (this == &_other)
+            return;
 
-        if(_subRootPtr->m_parent)
-        {
-            if(_subRootPtr == _subRootPtr->m_parent->m_left)
-                _subRootPtr->m_parent->m_left = rightSubtree;
-            else
-                _subRootPtr->m_parent->m_right = rightSubtree;
-        }
-        else
-        {
-            m_root = rightSubtree;
-        }
+        size_type common = 0;
+        const unsigned int forkDepth = _pool ? parallel_fork_depth(*_pool) : 0;
 
-        rightSubtree->m_left = _subRootPtr;
-        _subRootPtr->m_parent = rightSubtree;
+        subtree result = intersect_subtrees(release(), _other.m_root, common, _pool, forkDepth);
+        adopt(result, common);
     }
 
-    // Pre: We wand to replace the subtree rooted at node _u with the one rooted at _v.
-    // Post: node _us parent becomes node _vs parent, and _us parent ends up having _v as its appropriate child.
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::transplant(node_pointer _u, node_pointer _v)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::set_difference(const RedBlackTree& _other, ThreadPool* _pool)
     {
-        if (_u->parent() == nullptr)
-            m_root = _v; // This means that _u is the root.
-        else if (_u == _u->parent()->left())
-            _u->parent()->m_left = _v;
-        else
+        static_assert(!_KeyPolicy::multi, "Set operations need unique keys");
+        if (this == &_other)
         {
-            _u->parent()->m_right = _v;
+            clear();
+            return;
         }
 
-        if (_v)
-            _v->m_parent = _u->m_parent;
+        size_type common = 0;
+        const size_type size = m_size;
+        const unsigned int forkDepth = _pool ? parallel_fork_depth(*_pool) : 0;
+
+        subtree result = subtract_subtrees(release(), _other.m_root, common, _pool, forkDepth);
+        adopt(result, size - common);
     }
-    
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::node_pointer 
-        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::minimum(node_pointer _nodePtr)
+
+    // Post: The tree is empty and its nodes are returned as a detached subtree.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::subtree RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::release()
     {
-        while (_nodePtr->m_left != nullptr)
-            _nodePtr = _nodePtr->m_left;
-        return _nodePtr;
+        subtree result(m_root, algorithms::black_height(m_root));
+        m_root = nullptr;
+        m_leftmost = nullptr;
+        m_rightmost = nullptr;
+        m_size = 0;
+        return result;
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::node_pointer 
-        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::maximum(node_pointer _nodePtr)
+    // Pre: The tree is empty, _size is the number of nodes of _tree.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::adopt(const subtree& _tree, size_type _size)
     {
-        while (_nodePtr->m_right != nullptr)
-            _nodePtr = _nodePtr->m_right;
-        return _nodePtr;
+        GLARE_ASSERT(m_root == nullptr, "Adopting would leak the current nodes");
+
+        m_root = _tree.m_root;
+        m_leftmost = m_root ? minimum(m_root) : nullptr;
+        m_rightmost = m_root ? maximum(m_root) : nullptr;
+        m_size = _size;
     }
-    
-    // We break the code for "inorder" successor into two cases:
-    // * If the right subtree of node x is nonempty, then the successor of x is just the leftmost node in xs right subtree.
-    // * If the right subtree of node x is empty and x has a successor y, then y is the lowest ancestor of x whose left child
-    //   is also an ancestor of x. To find y, we simply go up the tree from x until we encounter a node that is the left child of its parent.
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::node_pointer 
-        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::successor(node_pointer _x)
+
+    // Pre: The tree is empty.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::adopt_sorted(const GLARE_VECTOR<node_pointer>& _nodes)
     {
-        if(_x->right() != nullptr)
-            return minimum(_x->right());
+        GLARE_ASSERT(m_root == nullptr, "Adopting would leak the current nodes");
 
-        node_pointer y = _x->parent();
-        while (y != nullptr && _x == y->right())
-        {
-            _x = y;
-            y = y->parent();
-        }
-        return y;
+        m_size = _nodes.size();
+        if (_nodes.empty())
+            return;
+
+        // Depth of the deepest level: the smallest d with a perfect tree of depth d holding all the nodes.
+        int redDepth = -1;
+        for (size_type perfect = 0; perfect < m_size; perfect = perfect * 2 + 1)
+            ++redDepth;
+
+        m_root = link_balanced(&_nodes[0], m_size, nullptr, 0, redDepth);
+        m_leftmost = _nodes.front();
+        m_rightmost = _nodes.back();
     }
 
-    // Code for "inorder" predecessor is symmetric to the successor's code. We break the code for predecessor into two cases:
-    // * If the left subtree of node x is nonempty, then the predecessor of x is just the rightmost node in xs left subtree.
-    // * If the left subtree of node x is empty and x has a predecessor y, then y is the highest ancestor of x whose right child
-    //   is also an ancestor of x. To find y, we simply go up the tree from x until we encounter a node that is the right child of its parent.
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::node_pointer 
-        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::predecessor(node_pointer _x)
+    // The halves differ by one node at most, so every path down to a nullptr ends on the deepest level or the one above. With the deepest
+    // level red, and the root black whatever its depth, every path has the same number of black nodes and no red node has a red child.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::node_pointer 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::link_balanced(const node_pointer* _nodes, size_type _count, node_pointer _parent, int _depth, int _redDepth)
     {
-        if (_x->left() != nullptr)
-            return maximum(_x->left());
+        if (_count == 0)
+            return nullptr;
+
+        const size_type middle = _count / 2;
+        node_pointer root = _nodes[middle];
+        root->parent(_parent);
+        root->color((_depth == _redDepth && _depth != 0) ? node_type::Red : node_type::Black);
+        root->left(link_balanced(_nodes, middle, root, _depth + 1, _redDepth));
+        root->right(link_balanced(_nodes + middle + 1, _count - middle - 1, root, _depth + 1, _redDepth));
+        algorithms::augment(root);
+        return root;
+    }
 
-        node_pointer y = _x->parent();
-        while (y != nullptr && _x == y->left())
+    // Post: _child is cut from its parent, painted black if it was red, with its black height.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::subtree 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::detach_child(node_pointer _child, const subtree& _parent)
+    {
+        int blackHeight = _parent.m_blackHeight - (_parent.m_root->isBlack() ? 1 : 0);
+        if (_child)
         {
-            _x = y;
-            y = y->parent();
+            _child->parent(nullptr);
+            if (_child->isRed())
+            {
+                _child->color(node_type::Black);
+                ++blackHeight;
+            }
         }
-        return y;
+        return subtree(_child, blackHeight);
     }
 
-
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::erase(const key_type& _key)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::subtree 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::join_subtrees(const subtree& _left, node_pointer _middle, const subtree& _right)
     {
-        if (node_pointer nodeToDelete = bst_find(_key))
-            rb_remove(nodeToDelete);
+        subtree result;
+        result.m_root = algorithms::rb_join(_left.m_root, _left.m_blackHeight, _middle, _right.m_root, _right.m_blackHeight, result.m_blackHeight);
+        return result;
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::erase(iterator& _itr)
+    // Without a middle node, the largest of _left is taken out and used as one.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::subtree 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::join_subtrees(const subtree& _left, const subtree& _right)
     {
-        if (_itr.m_nodePtr)
-            rb_remove(_itr.m_nodePtr);
+        if (_left.m_root == nullptr)
+            return _right;
+        if (_right.m_root == nullptr)
+            return _left;
+
+        node_pointer leftRoot = _left.m_root;
+        node_pointer leftmost = nullptr;
+        node_pointer rightmost = maximum(leftRoot);
+        node_pointer middle = rightmost;
+        algorithms::rb_remove(leftRoot, leftmost, rightmost, middle);
+
+        return join_subtrees(subtree(leftRoot, algorithms::black_height(leftRoot)), middle, _right);
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::erase(reverse_iterator& _itr)
+    // Post: _less and _greater get the keys less and greater than _key, the node holding _key is returned unlinked, nullptr when there is none.
+    //       Every level joins what it cut back on the way up; the costs telescope to O(log n).
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::node_pointer 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::split_subtree(subtree _tree, const key_type& _key, subtree& _less, subtree& _greater) const
     {
-        if (_itr.m_nodePtr)
-            rb_remove(_itr.m_nodePtr);
-    }
+        node_pointer root = _tree.m_root;
+        if (root == nullptr)
+        {
+            _less = subtree();
+            _greater = subtree();
+            return nullptr;
+        }
 
-    // Removal
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::rb_remove(node_pointer _nodeToDelete)
-    {
-        node_pointer y = _nodeToDelete; // 'y' is a node that either gets removed from then tree or moved within the tree (in this case its a successor).
-        node_type::Color originalColorY = y->color();
-            
-        node_pointer x = nullptr;  // we keep track of the node 'x' that moves into node y' original position, thus replacing it. x could also be a nullptr.
-        node_pointer xp = nullptr; // New parent of x. This used to be the parent of 'y' before 'x' replaced it.
-        // So 'x' being the node replacing 'y' and xp is x's new parent after replacing y.
+        subtree left = detach_child(root->left(), _tree);
+        subtree right = detach_child(root->right(), _tree);
+        root->left(nullptr);
+        root->right(nullptr);
 
-        // We found the node to be deleted!
-        if(y->m_left == nullptr)
+        if (_KeyPolicy::multi ? !m_binPredicate(root->key(), _key) : m_binPredicate(_key, root->key())) // Repeated keys can be on both sides, all go right.
         {
-            x = y->m_right; // x could be a nullptr.
-            xp = y->parent();
-            transplant(y, x);
-            GLARE_ASSERT((x == nullptr || x->isRed()), "If a node has only one child, that child has to be Red otherwise RB Properties are violated");
+            subtree between;
+            node_pointer match = split_subtree(left, _key, _less, between);
+            _greater = join_subtrees(between, root, right);
+            return match;
         }
-        else if(y->m_right == nullptr)
+        else if (_key == root->key())
         {
-            x = y->m_left; // here 'x' could not be a nullptr, otherwise it wouldn't have entered this else-if part.
-            xp = y->parent();
-            transplant(y, x);
-            GLARE_ASSERT(x->isRed(), "If a node has only one child, that child has to be Red otherwise RB Properties are violated");
+            _less = left;
+            _greater = right;
+            return root;
         }
         else
         {
-            y = minimum(_nodeToDelete->m_right); // 'y' now points to the successor indication that its being removed, 'cos successor replaces '_nodeToDelete' takes it's color which keeps the equation same at the _nodeToDelete level.
-                                                // The node that actually gets missing is the successor node itself, ignore its value because what matters now is its color. If it was black then we have a violation.
-            originalColorY = y->color();
-            x = y->right(); // x could be a nullptr. x will replace 'y' because y is being re-placed in the tree.
-            xp = y->parent(); // xp will be x' new parent after the transplant(y, x).
-
-            if (xp == _nodeToDelete)
-                xp = y; // We don't want xp to point to _nodeToDelete as it is being deleted and also the real parent of x in this particular case will itself be y.
-            else
-            {
-                transplant(y, x); // After this transplant x takes y' position and y' parent becomes x' parent, i.e. 'xp'.
-                y->m_right = _nodeToDelete->m_right;
-                _nodeToDelete->m_right->m_parent = y;
-            }
-            transplant(_nodeToDelete, y); // replace _nodeToDelete with its successor.
-            y->m_left = _nodeToDelete->m_left;
-            y->m_left->m_parent = y;
-            y->color(_nodeToDelete->color());
-        }
-
-        // One important point, if m_leftmost or m_rightmost is the _nodeToDelete then 'y' can't be a successor(_nodeToDelete). 
-        // As m_leftmost or m_rightmost can have at the most one child right or left respectively.
-        if (m_leftmost == _nodeToDelete) // Leftmost can have a right child, which could be nullptr.
-        {
-            m_leftmost = (x == nullptr) ? xp : minimum(x); // x can only be right child of leftmost node.
-        }
-        // Not using else, because if leftmost == rightmost == _nodeToDelete == m_root, then both should be modified.
-        if(m_rightmost == _nodeToDelete)
-        {
-            m_rightmost = (x == nullptr) ? xp : maximum(x);  // x can only be left child of rightmost node.
+            subtree between;
+            node_pointer match = split_subtree(right, _key, between, _greater);
+            _less = join_subtrees(left, root, between);
+            return match;
         }
-
-        // If y is black then moving y within the tree causes any simple path that previously contained y to have one fewer black node. Thus, it violates property #5.
-        // We can correct the violation of property #5 by saying that node x, now occupying y' original position, has an "extra" black. That is, if we add 1 to the 
-        // count of black nodes on any simple path that contains x, then under this interpretation, property 5 holds. When we remove or move the black node y, we "push" 
-        // its blackness onto node x. The problem is that now node x is neither red nor black, thereby violating property 1. Instead, node x is either "doubly black" or
-        // "red-and-black," and it contributes either 2 or 1, respectively, to the count of black nodes on simple paths containing x. The color attribute of x will still 
-        // be either RED (if x is red-and-black) or BLACK (if x is doubly black). In other words, the extra black on a node is reflected in x's pointing to the node rather 
-        // than in the color attribute.
-        if (originalColorY == node_type::Black)
-            rb_remove_fixup(x, xp); // x can be nullptr that is why we want to send x's parent separately.
-
-        destroyObject(m_nodeAllocator, _nodeToDelete); // Delete the actual node now!
-        --m_size; // We have 1 less number of nodes now.
     }
-    
-    // Pre: rb_remove may violate property #2, #4, #5
-    //  * #2, if the node to delete was root and a red root replaced it.
-    //  * #4, if the deleted node was black with a red child (right), which replaces it.
-    //  * #5, if the deleted node was black with both child nils then we are short of 1 black count on this path. 
-    //    It has supposedly pushed its blackness to its child which replaces it, and this child is now doubly black. 
-    //    1 count of black because its a nil node & 1 because it has the blackness pushed upon it by its former black parent.
 
-    // Post: Violations of property #2, #4, #5 are removed and the tree is back to being a legit RB Tree.
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::rb_remove_fixup(node_pointer _x, node_pointer _xp)
+    // Split this side by the root key of the other side, unite the halves with its subtrees, join back with the root in between.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::subtree 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::union_subtrees(subtree _tree, const_node_pointer _other, int _otherBlackHeight, size_type& _common, 
+                                                                        ThreadPool* _pool, unsigned int _forkDepth)
     {
-        // Some Conventions.
-        //       (p)
-        //      //  \
-        //     x     s
-        //
-        // x is the double black node which replaced its former black parent.
-        // s is the sibling.
-        // p is the parent.
-
-        // All possible cases for the doubly black node 'x':
-        // Case #1: sibling of x is black and has 1 red child. This is a terminal case.
-        //       a: When sibling is right and its right child is red, color of left doesn't matter. Same for when sibling is left and its left child.
-        //       b: When sibling is right and its left child is red, right is black, we transform it to case #1(a). Same for when the sibling is left
-        //          and its right child is red, and left child is black. we make rotation to transform it to case #1(a).
-        //
-        // Case #2: sibling of x is black and both of s' children are black. This is the recoloring case only.
-        //       a: If parent p is red then recoloring is the terminal case.
-        //       b: If parent p is black, then x will point to p now, indicating that it is p which is doubly black now. and propagates the problem upwards.
-        //
-        // Case #3: sibling 's' of x is red, in this case we make a rotation on 'p' and transform into one of the above mentioned cases.
-
-        node_pointer x = _x;   // Double black node.
-        node_pointer xp = _xp; // Parent of the double black node. Why take xp separately when we can do x->parent(), the answer is that x can also be nullptr and xp can't be nullptr.
+        if (_other == nullptr)
+            return _tree;
 
-        while ( x != m_root && (x == nullptr || x->isBlack()) )
+        if (_tree.m_root == nullptr)
         {
-            // Loop Invariant:
-            // x is always the double black node in question at the beginning of the iteration.
-            // x is never a root, because when that happens we just simply discard the extra black.
-            // The idea is to find a red node on the path upward and change the pair (RED, DOUBLE-BLACK) to (BLACK, BLACK).
-            // Restructuring solves the problem locally while recoloring may propagate it upwards.
-
-            if (x == xp->left()) // x is the left child of its parent.
+            node_pointer copyRoot = internal_copy(_other, nullptr);
+            if (copyRoot->isRed())
             {
-                node_pointer s = xp->right();    
-
-                // Check if it is case #3 then transform it into case #1 or #2.
-                if (s->isRed()) // Case #3
-                { 
-                    // s being red means its children and its parent must be black.
-                    s->color(node_type::Black); // s replaces p so it takes its color to not change the overall picture.
-                    xp->color(node_type::Red);   // we color parent red because we already have s (its 'now' parent) as black.
-                    rotate_left(xp); // 'xp' will still remain the parent of 'x' after the left rotation.
-                    s = xp->right(); // left child of older 's' now becomes new sibling after rotation. It must be black by property #4.
-                }
-
-                // At this point we know that 's' is black whatsoever, so we don't need to test for that. Either Case #1 or #2 applies.
-                if ( (s->right() == nullptr || s->right()->isBlack()) && (s->left() == nullptr || s->left()->isBlack()) )
-                {
-                    s->color(node_type::Red); // Take 1 black from both the double black node and 's' and pass it on to its parent.
-                    x = xp; // the notion of being double black or having an extra black count is reflected by 'x' pointing to a node.
-                    // So, if xp was black then it becomes double black now. if it was red then it becomes red-black node. x' pointing to it adds an extra black.
-                    // If we came from Case#3 then the loop will terminate after this as xp must be red. After the while loop x is turned to black which solves the problem.
-                    xp = xp->parent();
-                }
-                else // its case #1 then.
-                { 
-                    // Test for case #1(b), if it is then transform it to case #1(a).
-                    if (s->right() == nullptr || s->right()->isBlack()) // If s->right is black then s->left must be red, 'cos we are in the else part & we know 1 of the 2 children is RED for sure.
-                    {
-                        s->left()->color(node_type::Black);
-                        s->color(node_type::Red);
-                        rotate_right(s); // Transformed!
-                        s = xp->right();  // The new sibling is black with a red right child, case #1(a), woo!
-                    }
-
-                    // Case #1(a) applies
-                    s->color(xp->color()); // Sibling takes its parent's color to keep the bigger picture similar after rotation.
-                    xp->color(node_type::Black); // Parent becomes black to consume the extra black of x.
-                    s->right()->color(node_type::Black); // s' right child becomes black to compensate for 1 black count that came from s before rotation.
-                    rotate_left(xp);
-                    x = m_root; // a way to break.
-                }
+                copyRoot->color(node_type::Black);
+                ++_otherBlackHeight;
             }
-            else // x is the right child of its parent, all of the above code, therefore, will be mirrored.
-            {
-                node_pointer s = xp->left();
+            return subtree(copyRoot, _otherBlackHeight);
+        }
 
-                if (s->isRed()) // Case #3
-                {
-                    s->color(node_type::Black); // We can also swap the colors but direct setting the colors is much better.
-                    xp->color(node_type::Red);
-                    rotate_right(xp);
-                    s = xp->left(); // The new sibling is black, congratulations!
-                }
+        subtree less, greater;
+        node_pointer middle = split_subtree(_tree, _other->key(), less, greater);
+        if (middle)
+            ++_common; // Ours, with our value.
+        else
+            middle = createObject(m_nodeAllocator, _other->getData());
 
-                // At this point we know that 's' is black so one of the cases #1 or #2 apply.
-                // Test for case #2
-                if ( (s->left() == nullptr || s->left()->isBlack()) && (s->right() == nullptr || s->right()->isBlack()) )
-                {
-                    s->color(node_type::Red); // Take 1 black count from both the "supposedly" double-black node and 's' and pass it on to its parent 'p'.
-                    x = xp; // Now parent's color either become red-black or double-black. If red-black then its a terminal case.
-                    // Notion of a node being red-black or double-black is reflected by x' pointing to it. The actual color value stays red or black respectively.
-                    xp = xp->parent();
-                }
-                else
-                {
-                    // Test for case #1b, if it is #1(b), indeed, transform it to #1(a).
-                    if (s->left() == nullptr || s->left()->isBlack())
-                    {
-                        s->right()->color(node_type::Black);
-                        s->color(node_type::Red);
-                        rotate_left(s);
-                        s = xp->left();
-                    }
+        const int childBlackHeight = _otherBlackHeight - (_other->isBlack() ? 1 : 0);
+        const unsigned int forkDepth = _forkDepth ? _forkDepth - 1 : 0;
+        size_type leftCommon = 0, rightCommon = 0;
+        subtree left, right;
 
-                    // Case #1(a) applies
-                    s->color(xp->color());
-                    xp->color(node_type::Black);
-                    s->left()->color(node_type::Black); // Left can never be nullptr, impossible.
-                    rotate_right(xp);
-                    x = m_root; // a way to break.
-                }
-            }
-        }
+        parallel_invoke(_forkDepth ? _pool : nullptr,
+            [&]() { left = union_subtrees(less, _other->left(), childBlackHeight, leftCommon, _pool, forkDepth); },
+            [&]() { right = union_subtrees(greater, _other->right(), childBlackHeight, rightCommon, _pool, forkDepth); });
 
-        if (x)
-            x->color(node_type::Black); // fixes property #2, #4
+        _common += leftCommon + rightCommon;
+        return join_subtrees(left, middle, right);
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    inline typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::node_pointer 
-    RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::bst_find(const key_type& _key) const
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::subtree 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::intersect_subtrees(subtree _tree, const_node_pointer _other, size_type& _common, 
+                                                                            ThreadPool* _pool, unsigned int _forkDepth)
     {
-        node_pointer currentPtr = m_root;
+        if (_tree.m_root == nullptr)
+            return _tree;
 
-        while(currentPtr != nullptr)
+        if (_other == nullptr)
         {
-            if (m_binPredicate(_key, currentPtr->key())) // less_than(givenKey, currentPtr->key())
-                currentPtr = currentPtr->m_left;
-            else if (_key == currentPtr->key())
-                break; // Found!
-            else
-                currentPtr = currentPtr->m_right;
+            internal_clean(m_nodeAllocator, _tree.m_root);
+            return subtree();
         }
 
-        return currentPtr; 
-    }
+        subtree less, greater;
+        node_pointer middle = split_subtree(_tree, _other->key(), less, greater);
 
+        const unsigned int forkDepth = _forkDepth ? _forkDepth - 1 : 0;
+        size_type leftCommon = 0, rightCommon = 0;
+        subtree left, right;
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    bool RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::exists(const key_type& _key) const
-    {
-        return (bst_find(_key) != nullptr);
-    }
+        parallel_invoke(_forkDepth ? _pool : nullptr,
+            [&]() { left = intersect_subtrees(less, _other->left(), leftCommon, _pool, forkDepth); },
+            [&]() { right = intersect_subtrees(greater, _other->right(), rightCommon, _pool, forkDepth); });
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    bool RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::find(const key_type& _key, val_type& _val) const
-    {
-        if(node_pointer nodePtr = bst_find(_key))
+        _common += leftCommon + rightCommon;
+        if (middle)
         {
-            _val = nodePtr->value();
-            return true;
-
+            ++_common;
+            return join_subtrees(left, middle, right);
         }
-        return false;
+        return join_subtrees(left, right);
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::iterator 
-        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::find(const key_type& _key) const
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::subtree 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::subtract_subtrees(subtree _tree, const_node_pointer _other, size_type& _common, 
+                                                                           ThreadPool* _pool, unsigned int _forkDepth)
     {
-        return iterator(bst_find(_key));
+        if (_tree.m_root == nullptr || _other == nullptr)
+            return _tree;
+
+        subtree less, greater;
+        if (node_pointer middle = split_subtree(_tree, _other->key(), less, greater))
+        {
+            destroyObject(m_nodeAllocator, middle);
+            ++_common;
+        }
+
+        const unsigned int forkDepth = _forkDepth ? _forkDepth - 1 : 0;
+        size_type leftCommon = 0, rightCommon = 0;
+        subtree left, right;
+
+        parallel_invoke(_forkDepth ? _pool : nullptr,
+            [&]() { left = subtract_subtrees(less, _other->left(), leftCommon, _pool, forkDepth); },
+            [&]() { right = subtract_subtrees(greater, _other->right(), rightCommon, _pool, forkDepth); });
+
+        _common += leftCommon + rightCommon;
+        return join_subtrees(left, right);
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::swap(RedBlackTree& _tree)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::swap(RedBlackTree& _tree)
     {
         if (this != &_tree)
         {
@@ -1110,6 +2366,11 @@ namespace glare
             m_binPredicate = _tree.m_binPredicate;
             _tree.m_binPredicate = tmpBinPredicate;
 
+            // Swap prefetch distance
+            unsigned int tmpPrefetchLines = m_prefetchLines;
+            m_prefetchLines = _tree.m_prefetchLines;
+            _tree.m_prefetchLines = tmpPrefetchLines;
+
             // Swap allocator
             node_allocator_type tmpNodeAllocator = m_nodeAllocator;
             m_nodeAllocator = _tree.m_nodeAllocator;
@@ -1117,12 +2378,12 @@ namespace glare
         }
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    inline void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::clear()
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    inline void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::clear()
     {
         if (m_root)
         {
-            internal_clean(m_root);
+            dispose(m_root, false);
             m_root = nullptr;
             m_leftmost = nullptr;
             m_rightmost = nullptr;
@@ -1130,37 +2391,74 @@ namespace glare
         }
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::internal_clean(node_pointer _subroot)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::size_type 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::internal_clean(node_allocator_type& _allocator, node_pointer _subroot)
     {
-        if (_subroot->m_left)
-            internal_clean(_subroot->m_left);
+        size_type count = 1;
+        if (_subroot->left())
+            count += internal_clean(_allocator, _subroot->left());
         
-        if (_subroot->m_right)
-            internal_clean(_subroot->m_right);
+        if (_subroot->right())
+            count += internal_clean(_allocator, _subroot->right());
 
         // Notice: PostOrder style destruction.
-        m_nodeAllocator.destroy(_subroot);
-        m_nodeAllocator.deallocate(_subroot, 1);
+        _allocator.destroy(_subroot);
+        _allocator.deallocate(_subroot, 1);
+        return count;
     }
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    void RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>::internal_copy(node_pointer& _refSubroot, const_node_pointer _originalSubroot, node_pointer _parent)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::size_type 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::dispose(node_pointer _subRoot, bool _count)
     {
-        if (_originalSubroot == nullptr)
+        if (_subRoot == nullptr)
+            return 0;
+
+        if (allocator_frees_in_bulk<node_allocator_type>::value && GLARE_HAS_TRIVIAL_DESTRUCTOR(node_type))
         {
-            _refSubroot = nullptr;
+            // Nothing to run on the nodes, their memory goes back with the allocator.
+            return _count ? count_nodes(_subRoot) : 0;
         }
-        else
+        else if (m_reclaimer)
         {
-            // Notice: Pre-Order style create and copy.
-            _refSubroot = createObject(m_nodeAllocator, *_originalSubroot);
-            _refSubroot->m_parent = _parent;
-            ++m_size;
-
-            internal_copy(_refSubroot->m_left, _originalSubroot->m_left, _refSubroot);
-            internal_copy(_refSubroot->m_right, _originalSubroot->m_right, _refSubroot);
+            const size_type count = _count ? count_nodes(_subRoot) : 0;
+            node_allocator_type allocator(m_nodeAllocator);
+            m_reclaimer->retire([=]() mutable { internal_clean(allocator, _subRoot); });
+            return count;
         }
+        return internal_clean(m_nodeAllocator, _subRoot);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::size_type 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::count_nodes(const_node_pointer _subRoot)
+    {
+        return _subRoot ? 1 + count_nodes(_subRoot->left()) + count_nodes(_subRoot->right()) : 0;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    typename RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::node_pointer 
+        RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>::internal_copy(const_node_pointer _originalSubroot, node_pointer _parent, 
+                                                                                           ThreadPool* _pool, unsigned int _forkDepth)
+    {
+        if (_originalSubroot == nullptr)
+            return nullptr;
+
+        // Notice: Pre-Order style create and copy.
+        node_pointer copySubroot = createObject(m_nodeAllocator, *_originalSubroot);
+        copySubroot->parent(_parent);
+
+        const unsigned int forkDepth = _forkDepth ? _forkDepth - 1 : 0;
+        node_pointer left = nullptr, right = nullptr;
+        parallel_invoke(_forkDepth ? _pool : nullptr,
+            [&]() { left = internal_copy(_originalSubroot->left(), copySubroot, _pool, forkDepth); },
+            [&]() { right = internal_copy(_originalSubroot->right(), copySubroot, _pool, forkDepth); });
+
+        copySubroot->left(left);
+        copySubroot->right(right);
+        algorithms::augment(copySubroot);
+        return copySubroot;
     }
 
     // ---------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -1172,8 +2470,8 @@ namespace glare
     // If you're writing a class (not a class template), specialize std::swap for your class. So we can't fully specialize std::swap.
     // When calling swap, employ a using declaration for std::swap, then call swap without namespace qualification.
 
-    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
-    void swap(RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>& _left, RedBlackTree<_KeyType, _ValType, _Pred, _Alloc>& _right)
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc, typename _Node, typename _KeyPolicy>
+    void swap(RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>& _left, RedBlackTree<_KeyType, _ValType, _Pred, _Alloc, _Node, _KeyPolicy>& _right)
     {
         _left.swap(_right);
     }
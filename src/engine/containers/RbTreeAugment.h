@@ -0,0 +1,282 @@
+#ifndef GLARE_RB_TREE_AUGMENT_H
+#define GLARE_RB_TREE_AUGMENT_H
+
+#include "RbTree.h"
+
+// Augmented Red-Black trees: every node keeps metadata about its subtree, computed by a policy from the node and its children, and
+// rb_tree_algorithms recomputes it wherever the subtree changes (rotations, links, removals, joins). The queries below descend from
+// the root on that metadata, O(log n).
+//
+//      typedef RbTreeAugmentedNode<int, Payload, rb_size_augment>                  ranked_node_t;
+//      RedBlackTree<int, Payload, less<int>, default_allocator<Payload>, ranked_node_t> tree;
+//      rb_select(tree, 10);            // The 11th smallest key.
+//
+// A policy has a metadata_type and a static update(node&) that sets node.metadata() from the node and its children's metadata. A value
+// the metadata depends on (rb_sum_augment) must be changed in place through RedBlackTree::refresh, or by erase and insert.
+
+namespace glare
+{
+    template<typename KeyType, typename ValueType, typename _Augment>
+    class RbTreeAugmentedNode
+    {
+    public:
+        typedef RbTreeAugmentedNode<KeyType, ValueType, _Augment>   selftype;
+        typedef selftype*                                           node_pointer;
+        typedef const selftype*                                     const_node_pointer;
+        typedef GLARE_PAIR<KeyType, ValueType>                      value_type;
+        typedef _Augment                                            augment_type;
+        typedef typename _Augment::metadata_type                    metadata_type;
+
+        enum Color { Black, Red };
+
+        RbTreeAugmentedNode(): m_left(nullptr), m_right(nullptr), m_parent(nullptr), m_color(Red), m_pair(), m_metadata() {}
+        explicit RbTreeAugmentedNode(const value_type& _pair): m_left(nullptr), m_right(nullptr), m_parent(nullptr), m_color(Red), m_pair(_pair), m_metadata() {}
+        explicit RbTreeAugmentedNode(value_type&& _pair): m_left(nullptr), m_right(nullptr), m_parent(nullptr), m_color(Red), m_pair(std::move(_pair)), m_metadata() {}
+        RbTreeAugmentedNode(const RbTreeAugmentedNode& _other): m_left(nullptr)
+                                                              , m_right(nullptr)
+                                                              , m_parent(nullptr)
+                                                              , m_color(_other.m_color)
+                                                              , m_pair(_other.m_pair)
+                                                              , m_metadata()
+        {
+        }
+
+        template<typename _KeyArg, typename _ValArg>
+        RbTreeAugmentedNode(_KeyArg&& _key, _ValArg&& _value): m_left(nullptr)
+                                                             , m_right(nullptr)
+                                                             , m_parent(nullptr)
+                                                             , m_color(Red)
+                                                             , m_pair(std::forward<_KeyArg>(_key), std::forward<_ValArg>(_value))
+                                                             , m_metadata()
+        {
+        }
+
+        const KeyType&      key() const { return m_pair.first; }
+        const ValueType&    value() const { return m_pair.second; }
+        ValueType&          value() { return m_pair.second; }
+
+        node_pointer        left() { return m_left; }
+        node_pointer        right() { return m_right; }
+        node_pointer        parent() { return m_parent; }
+
+        const_node_pointer  left() const { return m_left; }
+        const_node_pointer  right() const { return m_right; }
+        const_node_pointer  parent() const { return m_parent; }
+
+        void                left(node_pointer _node) { m_left = _node; }
+        void                right(node_pointer _node) { m_right = _node; }
+        void                parent(node_pointer _node) { m_parent = _node; }
+
+        value_type&         getData() { return m_pair; }
+        const value_type&   getData() const { return m_pair; }
+
+        Color color() const     { return m_color; }
+        void  color(Color _col) { m_color = _col; }
+        bool  isBlack() const   { return m_color == Black; }
+        bool  isRed() const     { return m_color == Red; }
+
+        const metadata_type& metadata() const { return m_metadata; }
+        void  metadata(const metadata_type& _metadata) { m_metadata = _metadata; }
+
+    private:
+        node_pointer    m_left;
+        node_pointer    m_right;
+        node_pointer    m_parent;
+        Color           m_color;
+        value_type      m_pair;
+        metadata_type   m_metadata;
+
+        RbTreeAugmentedNode& operator= (const RbTreeAugmentedNode& _other);
+    };
+
+    template<typename KeyType, typename ValueType, typename _Augment>
+    struct rb_node_augment<RbTreeAugmentedNode<KeyType, ValueType, _Augment> >
+    {
+        static const bool enabled = true;
+        static void update(RbTreeAugmentedNode<KeyType, ValueType, _Augment>* _node) { _Augment::update(*_node); }
+    };
+
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    // Order statistics: the size of the subtree.
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+    struct rb_size_augment
+    {
+        typedef std::size_t metadata_type;
+
+        template<typename _Node>
+        static void update(_Node& _node)
+        {
+            _node.metadata(1 + (_node.left() ? _node.left()->metadata() : 0) + (_node.right() ? _node.right()->metadata() : 0));
+        }
+    };
+
+    // Post: The element with _index smaller keys before it, end() when _index is past the last one.
+    template<typename _Tree>
+    typename _Tree::iterator rb_select(const _Tree& _tree, std::size_t _index)
+    {
+        typename _Tree::node_type* node = _tree.root();
+        while (node != nullptr)
+        {
+            const std::size_t leftSize = node->left() ? node->left()->metadata() : 0;
+            if (_index < leftSize)
+                node = node->left();
+            else if (_index == leftSize)
+                break;
+            else
+            {
+                _index -= leftSize + 1;
+                node = node->right();
+            }
+        }
+        return typename _Tree::iterator(node);
+    }
+
+    // Post: The number of keys less than _key, whether _key is in the tree or not.
+    template<typename _Tree>
+    std::size_t rb_rank(const _Tree& _tree, const typename _Tree::key_type& _key)
+    {
+        const typename _Tree::key_compare predicate = _tree.key_comp();
+        std::size_t rank = 0;
+        for (const typename _Tree::node_type* node = _tree.root(); node != nullptr; )
+        {
+            if (predicate(node->key(), _key))
+            {
+                rank += 1 + (node->left() ? node->left()->metadata() : 0);
+                node = node->right();
+            }
+            else
+            {
+                node = node->left();
+            }
+        }
+        return rank;
+    }
+
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    // Aggregates: the sum of the values of the subtree, in _SumType.
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+    template<typename _SumType>
+    struct rb_sum_augment
+    {
+        typedef _SumType metadata_type;
+
+        template<typename _Node>
+        static void update(_Node& _node)
+        {
+            metadata_type sum = static_cast<metadata_type>(_node.value());
+            if (_node.left())
+                sum += _node.left()->metadata();
+            if (_node.right())
+                sum += _node.right()->metadata();
+            _node.metadata(sum);
+        }
+    };
+
+    // Post: The sum of the values whose key is less than _key.
+    template<typename _Tree>
+    typename _Tree::node_type::metadata_type rb_sum_less(const _Tree& _tree, const typename _Tree::key_type& _key)
+    {
+        typedef typename _Tree::node_type::metadata_type sum_type;
+
+        const typename _Tree::key_compare predicate = _tree.key_comp();
+        sum_type sum = sum_type();
+        for (const typename _Tree::node_type* node = _tree.root(); node != nullptr; )
+        {
+            if (predicate(node->key(), _key))
+            {
+                sum += static_cast<sum_type>(node->value());
+                if (node->left())
+                    sum += node->left()->metadata();
+                node = node->right();
+            }
+            else
+            {
+                node = node->left();
+            }
+        }
+        return sum;
+    }
+
+    // Post: The sum of the values whose key is in [_low, _high).
+    template<typename _Tree>
+    typename _Tree::node_type::metadata_type rb_range_sum(const _Tree& _tree, const typename _Tree::key_type& _low, const typename _Tree::key_type& _high)
+    {
+        if (!_tree.key_comp()(_low, _high))
+            return typename _Tree::node_type::metadata_type();
+
+        return rb_sum_less(_tree, _high) - rb_sum_less(_tree, _low);
+    }
+
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    // Interval tree: the keys are closed intervals GLARE_PAIR<low, high>, ordered by low then high, and the metadata is the largest high
+    // of the subtree.
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+    template<typename _Bound>
+    struct rb_interval_augment
+    {
+        typedef _Bound metadata_type;
+
+        template<typename _Node>
+        static void update(_Node& _node)
+        {
+            const metadata_type* highest = &_node.key().second;
+            if (_node.left() && *highest < _node.left()->metadata())
+                highest = &_node.left()->metadata();
+            if (_node.right() && *highest < _node.right()->metadata())
+                highest = &_node.right()->metadata();
+            _node.metadata(*highest);
+        }
+    };
+
+    namespace rb_augment_detail
+    {
+        template<typename _NodePointer, typename _Bound, typename _Func>
+        void for_each_overlap(_NodePointer _node, const _Bound& _low, const _Bound& _high, _Func& _func)
+        {
+            // Nothing in this subtree reaches _low.
+            if (_node == nullptr || _node->metadata() < _low)
+                return;
+
+            for_each_overlap(_node->left(), _low, _high, _func);
+
+            // This node and everything right of it starts after _high.
+            if (_high < _node->key().first)
+                return;
+
+            if (!(_node->key().second < _low))
+                _func(_node->getData());
+
+            for_each_overlap(_node->right(), _low, _high, _func);
+        }
+    }
+
+    // Post: An element whose interval overlaps [_low, _high], end() when there is none. O(log n).
+    template<typename _Tree, typename _Bound>
+    typename _Tree::iterator rb_find_overlap(const _Tree& _tree, const _Bound& _low, const _Bound& _high)
+    {
+        typename _Tree::node_type* node = _tree.root();
+        while (node != nullptr && (_high < node->key().first || node->key().second < _low))
+        {
+            // If the left subtree reaches _low, any overlap is there: the intervals of the right subtree start after its ones.
+            if (node->left() && !(node->left()->metadata() < _low))
+                node = node->left();
+            else
+                node = node->right();
+        }
+        return typename _Tree::iterator(node);
+    }
+
+    // Calls _func(value_type&) for every element whose interval overlaps [_low, _high], in key order. O(k log n) for k of them at
+    // most, subtrees that end before _low or start after _high are skipped.
+    template<typename _Tree, typename _Bound, typename _Func>
+    void rb_for_each_overlap(const _Tree& _tree, const _Bound& _low, const _Bound& _high, _Func _func)
+    {
+        rb_augment_detail::for_each_overlap(_tree.root(), _low, _high, _func);
+    }
+
+} // namespace glare
+
+#endif // GLARE_RB_TREE_AUGMENT_H
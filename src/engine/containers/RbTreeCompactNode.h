@@ -0,0 +1,159 @@
+#ifndef GLARE_RB_TREE_COMPACT_NODE_H
+#define GLARE_RB_TREE_COMPACT_NODE_H
+
+#include "RbTree.h"
+#include "memory\IndexPool.h"
+#include <cstdint>
+
+// Smaller nodes for the RedBlackTree, picked with its node parameter. Both keep the color in the lowest bit of the parent link, which
+// saves the Color member of RbTreeNode and the padding behind it:
+//
+//      RedBlackTree<int, int, less<int>, default_allocator<int>, RbTreeCompactNode<int, int> >     // 3 pointers
+//      RedBlackTree<int, int, less<int>, IndexPoolAllocator<int>, RbTreeIndexNode<int, int> >      // 3 x 32-bit indices
+//
+// On 64-bit a RbTreeNode<int, int> takes 40 bytes, the compact node 32 and the index node 20. The index node links through the single
+// IndexPool of its type, so the tree has to allocate it with the IndexPoolAllocator and the pool must be reserved first; all the trees
+// of that node type share the pool. Reading a link costs a mask, or an addition for an index, on top of the load.
+
+namespace glare
+{
+    template<typename KeyType, typename ValueType>
+    class RbTreeCompactNode
+    {
+    public:
+        typedef RbTreeCompactNode<KeyType, ValueType>   selftype;
+        typedef selftype*                               node_pointer;
+        typedef const selftype*                         const_node_pointer;
+        typedef GLARE_PAIR<KeyType, ValueType>          value_type;
+
+        enum Color { Black, Red };
+
+        RbTreeCompactNode(): m_left(nullptr), m_right(nullptr), m_parentColor(Red), m_pair() {}
+        explicit RbTreeCompactNode(const value_type& _pair): m_left(nullptr), m_right(nullptr), m_parentColor(Red), m_pair(_pair) {}
+        explicit RbTreeCompactNode(value_type&& _pair): m_left(nullptr), m_right(nullptr), m_parentColor(Red), m_pair(std::move(_pair)) {}
+        RbTreeCompactNode(const RbTreeCompactNode& _other): m_left(nullptr), m_right(nullptr), m_parentColor(_other.color()), m_pair(_other.m_pair) {}
+
+        template<typename _KeyArg, typename _ValArg>
+        RbTreeCompactNode(_KeyArg&& _key, _ValArg&& _value): m_left(nullptr)
+                                                           , m_right(nullptr)
+                                                           , m_parentColor(Red)
+                                                           , m_pair(std::forward<_KeyArg>(_key), std::forward<_ValArg>(_value))
+        {
+        }
+
+        const KeyType&      key() const { return m_pair.first; }
+        const ValueType&    value() const { return m_pair.second; }
+        ValueType&          value() { return m_pair.second; }
+
+        node_pointer        left() { return m_left; }
+        node_pointer        right() { return m_right; }
+        node_pointer        parent() { return reinterpret_cast<node_pointer>(m_parentColor & ~ColorMask); }
+
+        const_node_pointer  left() const { return m_left; }
+        const_node_pointer  right() const { return m_right; }
+        const_node_pointer  parent() const { return reinterpret_cast<const_node_pointer>(m_parentColor & ~ColorMask); }
+
+        void                left(node_pointer _node) { m_left = _node; }
+        void                right(node_pointer _node) { m_right = _node; }
+        void                parent(node_pointer _node) { m_parentColor = reinterpret_cast<std::uintptr_t>(_node) | (m_parentColor & ColorMask); }
+
+        value_type&         getData() { return m_pair; }
+        const value_type&   getData() const { return m_pair; }
+
+        Color color() const     { return static_cast<Color>(m_parentColor & ColorMask); }
+        void  color(Color _col) { m_parentColor = (m_parentColor & ~ColorMask) | _col; }
+        bool  isBlack() const   { return color() == Black; }
+        bool  isRed() const     { return color() == Red; }
+
+    private:
+        // Nodes are at least pointer aligned, the lowest bit of their address is always clear.
+        static const std::uintptr_t ColorMask = 1;
+
+        node_pointer    m_left;
+        node_pointer    m_right;
+        std::uintptr_t  m_parentColor;
+        value_type      m_pair;
+
+        RbTreeCompactNode& operator= (const RbTreeCompactNode& _other);
+    };
+
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    // Links as 32-bit indices into the IndexPool of the node type, the parent index shifted up by one to make room for the color.
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+    template<typename KeyType, typename ValueType>
+    class RbTreeIndexNode
+    {
+    public:
+        typedef RbTreeIndexNode<KeyType, ValueType>     selftype;
+        typedef selftype*                               node_pointer;
+        typedef const selftype*                         const_node_pointer;
+        typedef GLARE_PAIR<KeyType, ValueType>          value_type;
+        typedef IndexPool<selftype>                     pool_type;
+        typedef typename pool_type::index_type          index_type;
+
+        enum Color { Black, Red };
+
+        // The parent index gives up its top bit to the color, index_pool_limit keeps the pool under it.
+        static const index_type MAX_INDEX = 0x7FFFFFFFu;
+
+        RbTreeIndexNode(): m_left(0), m_right(0), m_parentColor(Red), m_pair() {}
+        explicit RbTreeIndexNode(const value_type& _pair): m_left(0), m_right(0), m_parentColor(Red), m_pair(_pair) {}
+        explicit RbTreeIndexNode(value_type&& _pair): m_left(0), m_right(0), m_parentColor(Red), m_pair(std::move(_pair)) {}
+        RbTreeIndexNode(const RbTreeIndexNode& _other): m_left(0), m_right(0), m_parentColor(_other.color()), m_pair(_other.m_pair) {}
+
+        template<typename _KeyArg, typename _ValArg>
+        RbTreeIndexNode(_KeyArg&& _key, _ValArg&& _value): m_left(0)
+                                                         , m_right(0)
+                                                         , m_parentColor(Red)
+                                                         , m_pair(std::forward<_KeyArg>(_key), std::forward<_ValArg>(_value))
+        {
+        }
+
+        const KeyType&      key() const { return m_pair.first; }
+        const ValueType&    value() const { return m_pair.second; }
+        ValueType&          value() { return m_pair.second; }
+
+        node_pointer        left() { return pool_type::at(m_left); }
+        node_pointer        right() { return pool_type::at(m_right); }
+        node_pointer        parent() { return pool_type::at(m_parentColor >> 1); }
+
+        const_node_pointer  left() const { return pool_type::at(m_left); }
+        const_node_pointer  right() const { return pool_type::at(m_right); }
+        const_node_pointer  parent() const { return pool_type::at(m_parentColor >> 1); }
+
+        void                left(node_pointer _node) { m_left = pool_type::index(_node); }
+        void                right(node_pointer _node) { m_right = pool_type::index(_node); }
+        void                parent(node_pointer _node)
+        {
+            const index_type index = pool_type::index(_node);
+            GLARE_ASSERT(index <= MAX_INDEX, "The top bit of the parent index would be shifted out");
+            m_parentColor = (index << 1) | (m_parentColor & 1);
+        }
+
+        value_type&         getData() { return m_pair; }
+        const value_type&   getData() const { return m_pair; }
+
+        Color color() const     { return static_cast<Color>(m_parentColor & 1); }
+        void  color(Color _col) { m_parentColor = (m_parentColor & ~index_type(1)) | _col; }
+        bool  isBlack() const   { return color() == Black; }
+        bool  isRed() const     { return color() == Red; }
+
+    private:
+        index_type      m_left;
+        index_type      m_right;
+        index_type      m_parentColor;
+        value_type      m_pair;
+
+        RbTreeIndexNode& operator= (const RbTreeIndexNode& _other);
+    };
+
+    template<typename KeyType, typename ValueType>
+    struct index_pool_limit<RbTreeIndexNode<KeyType, ValueType> >
+    {
+        static const std::uint32_t value = RbTreeIndexNode<KeyType, ValueType>::MAX_INDEX;
+    };
+
+} // namespace glare
+
+#endif // GLARE_RB_TREE_COMPACT_NODE_H
@@ -0,0 +1,147 @@
+#ifndef GLARE_RB_TREE_PARALLEL_H
+#define GLARE_RB_TREE_PARALLEL_H
+
+#include "RbTree.h"
+
+// Whole-tree traversals of a RedBlackTree over a ThreadPool. The tree is cut into subtrees down to parallel_fork_depth() levels and
+// each one is walked on its own task through the child links, without the parent pointer chasing of successor(). As everywhere else,
+// a nullptr pool runs it all on the calling thread.
+//
+//      long long total = parallel_reduce(tree, 0LL, 
+//                                        [](long long _sum, const value_type& _pair) { return _sum + _pair.second; },
+//                                        [](long long _left, long long _right) { return _left + _right; }, &pool);
+//
+// The tree must not change meanwhile. The values can, from the function they are handed to, their keys must not.
+
+namespace glare
+{
+    namespace rb_parallel_detail
+    {
+        template<typename _NodePointer, typename _Func>
+        void for_each(_NodePointer _node, const _Func& _func)
+        {
+            for (; _node != nullptr; _node = _node->right())
+            {
+                for_each(_node->left(), _func);
+                _func(_node->getData());
+            }
+        }
+
+        template<typename _NodePointer, typename _Func>
+        void parallel_for_each(_NodePointer _node, const _Func& _func, ThreadPool* _pool, unsigned int _forkDepth)
+        {
+            if (_pool == nullptr || _forkDepth == 0)
+            {
+                for_each(_node, _func);
+                return;
+            }
+            if (_node == nullptr)
+                return;
+
+            const _Func* func = &_func;
+            parallel_invoke(_pool,
+                [=]() { parallel_for_each(_node->left(), *func, _pool, _forkDepth - 1); },
+                [=]() { (*func)(_node->getData()); parallel_for_each(_node->right(), *func, _pool, _forkDepth - 1); });
+        }
+
+        template<typename _NodePointer, typename _T, typename _Accumulate>
+        _T reduce(_NodePointer _node, _T _value, const _Accumulate& _accumulate)
+        {
+            for (; _node != nullptr; _node = _node->right())
+            {
+                _value = reduce(_node->left(), _value, _accumulate);
+                _value = _accumulate(_value, _node->getData());
+            }
+            return _value;
+        }
+
+        template<typename _NodePointer, typename _T, typename _Accumulate, typename _Combine>
+        _T parallel_reduce(_NodePointer _node, const _T& _init, const _Accumulate& _accumulate, const _Combine& _combine, ThreadPool* _pool, unsigned int _forkDepth)
+        {
+            if (_pool == nullptr || _forkDepth == 0)
+                return reduce(_node, _init, _accumulate);
+            if (_node == nullptr)
+                return _init;
+
+            _T left(_init), right(_init);
+            parallel_invoke(_pool,
+                [&]() { left = parallel_reduce(_node->left(), _init, _accumulate, _combine, _pool, _forkDepth - 1); },
+                [&]() { right = parallel_reduce(_node->right(), _init, _accumulate, _combine, _pool, _forkDepth - 1); });
+
+            return _combine(_accumulate(left, _node->getData()), right); // In key order.
+        }
+
+        // The keys of the nodes down to _depth levels below _node, in order.
+        template<typename _NodePointer, typename _Key>
+        void collect_keys(_NodePointer _node, unsigned int _depth, GLARE_VECTOR<_Key>& _keys)
+        {
+            if (_node == nullptr || _depth == 0)
+                return;
+
+            collect_keys(_node->left(), _depth - 1, _keys);
+            _keys.push_back(_node->key());
+            collect_keys(_node->right(), _depth - 1, _keys);
+        }
+    }
+
+    // Post: _func(element) ran once for every element, in no particular order and concurrently from the pool threads.
+    template<typename _Tree, typename _Func>
+    void parallel_for_each(const _Tree& _tree, const _Func& _func, ThreadPool* _pool)
+    {
+        rb_parallel_detail::parallel_for_each(_tree.root(), _func, _pool, _pool ? parallel_fork_depth(*_pool) : 0);
+    }
+
+    // Post: The fold of the elements in key order. _accumulate(partial, element) folds one element in and _combine(left, right) joins
+    //       the partials of two adjacent key ranges; the subtrees start over from _init, so it must be neutral for _combine, and
+    //       _combine associative. It need not commute.
+    template<typename _Tree, typename _T, typename _Accumulate, typename _Combine>
+    _T parallel_reduce(const _Tree& _tree, const _T& _init, const _Accumulate& _accumulate, const _Combine& _combine, ThreadPool* _pool)
+    {
+        return rb_parallel_detail::parallel_reduce(_tree.root(), _init, _accumulate, _combine, _pool, _pool ? parallel_fork_depth(*_pool) : 0);
+    }
+
+    // Ordered chunks: the tree is cut into contiguous key ranges, a task each, and _func(first, last, result) handles the range
+    // [first, last) into its own slot of _results. _results comes back with a slot per range in key order, so concatenating or folding
+    // them left to right gives what a single pass would have, whichever order the tasks ran in. One range without a pool.
+    template<typename _Tree, typename _Result, typename _Func>
+    void parallel_for_each_ordered(const _Tree& _tree, GLARE_VECTOR<_Result>& _results, const _Func& _func, ThreadPool* _pool)
+    {
+        typedef typename _Tree::iterator iterator;
+
+        // Cut at the keys of the top levels, a few ranges per thread. lower_bound keeps repeated keys together.
+        GLARE_VECTOR<typename _Tree::key_type> cuts;
+        if (_pool) {
+            rb_parallel_detail::collect_keys(_tree.root(), parallel_fork_depth(*_pool), cuts);
+        }
+
+        GLARE_VECTOR<iterator> bounds;
+        typename _Tree::node_type* leftmost = _tree.root(); // The first element, end() for an empty tree.
+        for (; leftmost && leftmost->left(); leftmost = leftmost->left()) {}
+        bounds.push_back(iterator(leftmost));
+        for (std::size_t i = 0; i < cuts.size(); ++i) {
+            bounds.push_back(_tree.lower_bound(cuts[i]));
+        }
+        bounds.push_back(iterator());
+
+        _results.clear();
+        _results.resize(bounds.size() - 1);
+        if (_pool == nullptr)
+        {
+            _func(bounds[0], bounds[1], _results[0]);
+            return;
+        }
+
+        TaskGroup group(*_pool);
+        const _Func* func = &_func;
+        for (std::size_t i = 0; i + 1 < bounds.size(); ++i)
+        {
+            iterator first = bounds[i], last = bounds[i + 1];
+            _Result* result = &_results[i];
+            group.run([=]() { (*func)(first, last, *result); });
+        }
+        group.wait();
+    }
+
+} // namespace glare
+
+#endif // GLARE_RB_TREE_PARALLEL_H
@@ -4,6 +4,7 @@
 #include "GlareCoreUtility.h"
 #include "memory\allocators.h"
 #include "BSTNode.h"
+#include "TreeStats.h"
 
 // TODO Support for iterator and then return pair<bool, iterator> from the splay()
 
@@ -81,6 +82,10 @@ namespace glare
         void clear();
         void size();
 
+        // Single pass over the nodes. Splaying reshapes the tree on every access, so this is a snapshot; a deep tree here is expected
+        // after sequential accesses and is not a fault.
+        TreeStats stats() const;
+
     private: // Helpers
         void rotate_right(node_pointer& _root);
         void rotate_left(node_pointer& _root);
@@ -252,6 +257,18 @@ namespace glare
         return resFound;
     }
 
+    // ------------------------------------------------------------------------------------------------------------------------------------
+    template<typename _keyType, typename _ValueType, typename _Pred, typename _AllocatorType>
+    TreeStats SplayTree<_keyType, _ValueType, _Pred, _AllocatorType>::stats() const
+    // ------------------------------------------------------------------------------------------------------------------------------------
+    {
+        TreeStats result;
+        binary_tree_stats(static_cast<const_node_pointer>(m_root), result); // Iterative, the tree may well be a list.
+        result.m_size = m_size;
+        result.m_bytes = result.m_nodeCount * sizeof(node_type);
+        return result;
+    }
+
     // ------------------------------------------------------------------------------------------------------------------------------------
 
     // ------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,364 @@
+#ifndef GLARE_STATIC_SEARCH_TREE_H
+#define GLARE_STATIC_SEARCH_TREE_H
+
+#include "GlareCoreUtility.h"
+#include "memory\allocators.h"
+#include <iterator>
+
+// A read only search tree, built once from key ordered pairs and stored in a single array in van Emde Boas order.
+//
+// The keys form a perfect binary search tree of height h. The van Emde Boas layout cuts the tree at half its height, stores the top
+// tree first and then every bottom tree one after the other, each of them laid out the same way recursively. Whatever the size of a
+// cache line or a page, a descent then touches O(log_B n) blocks of size B, without knowing B: the layout is cache-oblivious.
+//
+// The tree is padded to 2^h - 1 slots, the slots past the last key behave as +infinity and are never compared. Only the keys are in the
+// tree, the values are kept in key order in a separate array and the in-order rank of the matching slot indexes them.
+//
+// Position of a node (Brodal, Fagerberg, Jacob): every depth d > 0 is the root depth of the bottom trees of exactly one level of the
+// recursion. At that level, the subtree being cut is rooted at depth D[d], its top tree has T[d] nodes and its bottom trees B[d] nodes.
+// With i the 1 based BFS index of the node, its position is
+//      pos[d] = pos[D[d]] + T[d] + (i & T[d]) * B[d]
+// where pos[D[d]] is the position of the ancestor at depth D[d], known since we are descending.
+
+namespace glare
+{
+    template<typename _KeyType, typename _ValType, typename _Pred = less<_KeyType>, typename _Alloc = default_allocator<_ValType> >
+    class StaticSearchTree
+    {
+        typedef typename _Alloc::template rebind<_KeyType>::other               key_allocator_type;
+
+    public:
+        typedef _KeyType                                        key_type;
+        typedef _ValType                                        value_type;
+        typedef value_type*                                     pointer;
+        typedef const value_type*                               const_pointer;
+        typedef value_type&                                     reference;
+        typedef const value_type&                               const_reference;
+        typedef std::size_t                                     size_type;
+        typedef _Alloc                                          allocator_type;
+        typedef GLARE_PAIR<key_type, value_type>                pair_type;
+
+        StaticSearchTree();
+        ~StaticSearchTree();
+        StaticSearchTree(const StaticSearchTree&);
+        StaticSearchTree& operator= (const StaticSearchTree&);
+
+        // Pre: [_first, _last) is a forward range of pairs (first: key, second: value) with strictly increasing keys,
+        //      e.g. the in-order traversal of a RedBlackTree, RedBlackTree::begin() and end().
+        template<typename _ForwardItr>
+        StaticSearchTree(_ForwardItr _first, _ForwardItr _last);
+
+        template<typename _ForwardItr>
+        void build(_ForwardItr _first, _ForwardItr _last);
+
+        bool find(const key_type& _key, value_type& _val) const;
+        const_pointer find(const key_type& _key) const;
+        bool exists(const key_type& _key) const { return internal_find(_key) != m_size; }
+
+        size_type size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        size_type height() const { return m_height; }
+
+        void clear();
+        void swap(StaticSearchTree& _other);
+
+    private:
+        static const size_type MAX_HEIGHT = sizeof(size_type) * 8;
+
+        size_type internal_find(const key_type& _key) const;
+        void build_layout_tables(size_type _rootDepth, size_type _height);
+        void build_layout(size_type _bfsIndex, size_type _depth, size_type* _pathPos, size_type* _posOfRank, GLARE_VECTOR<size_type>& _padding) const;
+        void copy(const StaticSearchTree& _other);
+
+        // Pre: _depth < m_height, _bfsIndex is the 1 based BFS index of a node at _depth.
+        // Post: The in-order rank of the node in the perfect tree of m_height levels.
+        size_type inorder_rank(size_type _bfsIndex, size_type _depth) const
+        {
+            return ((2 * (_bfsIndex - (size_type(1) << _depth)) + 1) << (m_height - _depth - 1)) - 1;
+        }
+
+        key_type*           m_keys;         // m_slotCount keys in van Emde Boas order.
+        value_type*         m_values;       // m_size values in key order.
+        size_type           m_size;
+        size_type           m_slotCount;    // 2^m_height - 1.
+        size_type           m_height;
+
+        size_type           m_topDepth[MAX_HEIGHT];     // D[d]
+        size_type           m_topSize[MAX_HEIGHT];      // T[d]
+        size_type           m_bottomSize[MAX_HEIGHT];   // B[d]
+
+        _Pred               m_binPredicate;
+        allocator_type      m_allocator;
+        key_allocator_type  m_keyAllocator;
+    }; // ----------- End of Class -----------
+
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::StaticSearchTree(): m_keys(nullptr), m_values(nullptr), m_size(0), m_slotCount(0), m_height(0)
+    {
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    template<typename _ForwardItr>
+    StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::StaticSearchTree(_ForwardItr _first, _ForwardItr _last): m_keys(nullptr), m_values(nullptr)
+                                                                                                                , m_size(0), m_slotCount(0), m_height(0)
+    {
+        build(_first, _last);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::~StaticSearchTree()
+    {
+        clear();
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::StaticSearchTree(const StaticSearchTree& _other): m_keys(nullptr), m_values(nullptr)
+                                                                                                         , m_size(0), m_slotCount(0), m_height(0)
+                                                                                                         , m_binPredicate(_other.m_binPredicate)
+    {
+        copy(_other);
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>&
+    StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::operator= (const StaticSearchTree& _other)
+    {
+        if (this != &_other)
+        {
+            clear();
+            m_binPredicate = _other.m_binPredicate;
+            copy(_other);
+        }
+        return *this;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    void StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::copy(const StaticSearchTree& _other)
+    {
+        if (_other.m_size == 0) {
+            return;
+        }
+
+        m_keys = m_keyAllocator.allocate(_other.m_slotCount);
+        m_values = m_allocator.allocate(_other.m_size);
+
+        for (size_type i = 0; i < _other.m_slotCount; ++i) {
+            m_keyAllocator.construct(m_keys + i, _other.m_keys[i]);
+        }
+        for (size_type i = 0; i < _other.m_size; ++i) {
+            m_allocator.construct(m_values + i, _other.m_values[i]);
+        }
+
+        m_size = _other.m_size;
+        m_slotCount = _other.m_slotCount;
+        m_height = _other.m_height;
+        GLARE_MEMCPY(m_topDepth, _other.m_topDepth, sizeof(m_topDepth));
+        GLARE_MEMCPY(m_topSize, _other.m_topSize, sizeof(m_topSize));
+        GLARE_MEMCPY(m_bottomSize, _other.m_bottomSize, sizeof(m_bottomSize));
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    void StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::clear()
+    {
+        if (m_keys)
+        {
+            for (size_type i = 0; i < m_slotCount; ++i) {
+                m_keyAllocator.destroy(m_keys + i);
+            }
+            m_keyAllocator.deallocate(m_keys, m_slotCount);
+            m_keys = nullptr;
+        }
+
+        if (m_values)
+        {
+            for (size_type i = 0; i < m_size; ++i) {
+                m_allocator.destroy(m_values + i);
+            }
+            m_allocator.deallocate(m_values, m_size);
+            m_values = nullptr;
+        }
+
+        m_size = 0;
+        m_slotCount = 0;
+        m_height = 0;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    void StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::swap(StaticSearchTree& _other)
+    {
+        if (this != &_other)
+        {
+            std::swap(m_keys, _other.m_keys);
+            std::swap(m_values, _other.m_values);
+            std::swap(m_size, _other.m_size);
+            std::swap(m_slotCount, _other.m_slotCount);
+            std::swap(m_height, _other.m_height);
+            std::swap(m_binPredicate, _other.m_binPredicate);
+
+            for (size_type i = 0; i < MAX_HEIGHT; ++i)
+            {
+                std::swap(m_topDepth[i], _other.m_topDepth[i]);
+                std::swap(m_topSize[i], _other.m_topSize[i]);
+                std::swap(m_bottomSize[i], _other.m_bottomSize[i]);
+            }
+        }
+    }
+
+    // Pre: [_first, _last) holds pairs with strictly increasing keys.
+    // Post: The tree holds a copy of the pairs, whatever it held before is released.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    template<typename _ForwardItr>
+    void StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::build(_ForwardItr _first, _ForwardItr _last)
+    {
+        clear();
+
+        const size_type count = static_cast<size_type>(std::distance(_first, _last));
+        if (count == 0) {
+            return;
+        }
+
+        m_size = count;
+        while (((size_type(1) << m_height) - 1) < count) {
+            ++m_height;
+        }
+        m_slotCount = (size_type(1) << m_height) - 1;
+
+        build_layout_tables(0, m_height);
+
+        // Position of every rank in the layout, and the padding slots past the last key.
+        GLARE_VECTOR<size_type> posOfRank(count);
+        GLARE_VECTOR<size_type> padding;
+        padding.reserve(m_slotCount - count);
+        size_type pathPos[MAX_HEIGHT];
+        pathPos[0] = 0;
+        build_layout(1, 0, pathPos, &posOfRank[0], padding);
+
+        m_keys = m_keyAllocator.allocate(m_slotCount);
+        m_values = m_allocator.allocate(m_size);
+
+        size_type rank = 0;
+        for (_ForwardItr itr = _first; itr != _last; ++itr, ++rank)
+        {
+            GLARE_ASSERT(rank == 0 || m_binPredicate(m_keys[posOfRank[rank-1]], itr->first), "Fatal Error: Keys must be strictly increasing.");
+            m_keyAllocator.construct(m_keys + posOfRank[rank], itr->first);
+            m_allocator.construct(m_values + rank, itr->second);
+        }
+
+        // Padding is never compared, a copy of the largest key keeps every slot constructed.
+        const key_type& largest = m_keys[posOfRank[count-1]];
+        for (size_type i = 0; i < padding.size(); ++i) {
+            m_keyAllocator.construct(m_keys + padding[i], largest);
+        }
+    }
+
+    // Pre: The subtree rooted at _rootDepth is _height levels high.
+    // Post: The tables hold D[d], T[d] and B[d] for the root depths d of every bottom tree of this subtree.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    void StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::build_layout_tables(size_type _rootDepth, size_type _height)
+    {
+        if (_height <= 1) {
+            return;
+        }
+
+        const size_type topHeight = _height / 2;
+        const size_type bottomHeight = _height - topHeight;
+        const size_type bottomDepth = _rootDepth + topHeight;
+
+        m_topDepth[bottomDepth] = _rootDepth;
+        m_topSize[bottomDepth] = (size_type(1) << topHeight) - 1;
+        m_bottomSize[bottomDepth] = (size_type(1) << bottomHeight) - 1;
+
+        build_layout_tables(_rootDepth, topHeight);
+        build_layout_tables(bottomDepth, bottomHeight); // All the bottom trees share the same depths.
+    }
+
+    // Pre: _pathPos holds the positions of the ancestors of the node, from the root down to _depth-1.
+    // Post: _posOfRank and _padding hold the positions of the node and all of its descendants.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    void StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::build_layout(size_type _bfsIndex, size_type _depth, size_type* _pathPos,
+                                                                             size_type* _posOfRank, GLARE_VECTOR<size_type>& _padding) const
+    {
+        if (_depth > 0) {
+            _pathPos[_depth] = _pathPos[m_topDepth[_depth]] + m_topSize[_depth] + (_bfsIndex & m_topSize[_depth]) * m_bottomSize[_depth];
+        }
+
+        const size_type rank = inorder_rank(_bfsIndex, _depth);
+        if (rank < m_size) {
+            _posOfRank[rank] = _pathPos[_depth];
+        }
+        else {
+            _padding.push_back(_pathPos[_depth]);
+        }
+
+        if (_depth + 1 < m_height)
+        {
+            build_layout(2 * _bfsIndex, _depth + 1, _pathPos, _posOfRank, _padding);
+            build_layout(2 * _bfsIndex + 1, _depth + 1, _pathPos, _posOfRank, _padding);
+        }
+    }
+
+    // Post: The rank of _key if found, m_size otherwise.
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::size_type
+    StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::internal_find(const key_type& _key) const
+    {
+        size_type pathPos[MAX_HEIGHT];
+        size_type bfsIndex = 1;
+
+        pathPos[0] = 0;
+        for (size_type depth = 0; depth < m_height; ++depth)
+        {
+            if (depth > 0) {
+                pathPos[depth] = pathPos[m_topDepth[depth]] + m_topSize[depth] + (bfsIndex & m_topSize[depth]) * m_bottomSize[depth];
+            }
+
+            const size_type rank = inorder_rank(bfsIndex, depth);
+            if (rank >= m_size) {
+                bfsIndex = 2 * bfsIndex; // Padding, greater than any key.
+                continue;
+            }
+
+            const key_type& key = m_keys[pathPos[depth]];
+            if (m_binPredicate(_key, key)) {
+                bfsIndex = 2 * bfsIndex;
+            }
+            else if (m_binPredicate(key, _key)) {
+                bfsIndex = 2 * bfsIndex + 1;
+            }
+            else {
+                return rank;
+            }
+        }
+
+        return m_size;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    bool StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::find(const key_type& _key, value_type& _val) const
+    {
+        const size_type rank = internal_find(_key);
+        if (rank != m_size) {
+            _val = m_values[rank];
+            return true;
+        }
+        return false;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    typename StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::const_pointer
+    StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>::find(const key_type& _key) const
+    {
+        const size_type rank = internal_find(_key);
+        return rank != m_size ? m_values + rank : nullptr;
+    }
+
+    template<typename _KeyType, typename _ValType, typename _Pred, typename _Alloc>
+    void swap(StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>& _first, StaticSearchTree<_KeyType, _ValType, _Pred, _Alloc>& _second)
+    {
+        _first.swap(_second);
+    }
+
+} // namespace
+
+#endif // GLARE_STATIC_SEARCH_TREE_H
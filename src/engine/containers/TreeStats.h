@@ -0,0 +1,94 @@
+#ifndef GLARE_TREE_STATS_H
+#define GLARE_TREE_STATS_H
+
+#include "GlareCoreUtility.h"
+
+// Shape of a tree, to tune the orders and to spot a degraded tree. Every balanced tree fills one in a single pass through stats().
+
+namespace glare
+{
+    struct TreeStats
+    {
+        std::size_t m_size;             // Nb of key-value pairs.
+        std::size_t m_nodeCount;        // Nb of nodes.
+        std::size_t m_height;           // Nb of levels, 0 when empty.
+        std::size_t m_blackHeight;      // Black nodes on any root to leaf path, the Red-Black trees only.
+        std::size_t m_maxKeysPerNode;   // MAXKEYS for a BTree, 1 for the binary trees.
+        std::size_t m_bytes;            // Bytes held by the nodes and their value blocks, the tree object itself is not counted.
+
+        GLARE_VECTOR<std::size_t> m_depthHistogram; // [d] is the nb of nodes at depth d, the root is at 0.
+        GLARE_VECTOR<std::size_t> m_fillHistogram;  // [k] is the nb of nodes holding k keys for a BTree, with k children for the binary trees.
+
+        TreeStats() { reset(); }
+
+        void reset()
+        {
+            m_size = m_nodeCount = m_height = m_blackHeight = m_bytes = 0;
+            m_maxKeysPerNode = 1;
+            m_depthHistogram.clear();
+            m_fillHistogram.clear();
+        }
+
+        // Post: A node at _depth holding _fill keys (children for the binary trees) is counted, the histograms grow as needed.
+        void addNode(std::size_t _depth, std::size_t _fill)
+        {
+            if (m_depthHistogram.size() <= _depth) {
+                m_depthHistogram.resize(_depth + 1, 0);
+            }
+            if (m_fillHistogram.size() <= _fill) {
+                m_fillHistogram.resize(_fill + 1, 0);
+            }
+            ++m_depthHistogram[_depth];
+            ++m_fillHistogram[_fill];
+            ++m_nodeCount;
+            if (m_height <= _depth) {
+                m_height = _depth + 1;
+            }
+        }
+
+        // Keys held against the keys the nodes could hold, 1.0 is a perfectly packed tree.
+        double averageFill() const
+        {
+            return m_nodeCount ? static_cast<double>(m_size) / static_cast<double>(m_nodeCount * m_maxKeysPerNode) : 0.0;
+        }
+
+        // Mean depth of a node, the expected nb of nodes visited by a successful lookup is this plus 1.
+        double averageDepth() const
+        {
+            std::size_t total = 0;
+            for (std::size_t d = 0; d < m_depthHistogram.size(); ++d) {
+                total += d * m_depthHistogram[d];
+            }
+            return m_nodeCount ? static_cast<double>(total) / static_cast<double>(m_nodeCount) : 0.0;
+        }
+    };
+
+    // Pre: _NodePointer points to a node with left() and right() accessors.
+    // Post: Counts, depths and child counts of the tree under _root are added to _stats. Iterative, so a degenerate tree (a splayed
+    //       one, say) doesn't blow the stack. m_size and m_bytes are left to the caller, which knows the node type.
+    template<typename _NodePointer>
+    void binary_tree_stats(_NodePointer _root, TreeStats& _stats)
+    {
+        GLARE_VECTOR<GLARE_PAIR<_NodePointer, std::size_t> > pending;
+        if (_root != nullptr) {
+            pending.push_back(GLARE_PAIR<_NodePointer, std::size_t>(_root, 0));
+        }
+
+        _stats.m_fillHistogram.resize(3, 0); // 0, 1 or 2 children, so the leaves are always reported.
+        while (!pending.empty())
+        {
+            const _NodePointer node = pending.back().first;
+            const std::size_t depth = pending.back().second;
+            pending.pop_back();
+
+            std::size_t children = 0;
+            if (node->left())  { ++children; pending.push_back(GLARE_PAIR<_NodePointer, std::size_t>(node->left(), depth + 1)); }
+            if (node->right()) { ++children; pending.push_back(GLARE_PAIR<_NodePointer, std::size_t>(node->right(), depth + 1)); }
+
+            _stats.addNode(depth, children);
+        }
+    }
+
+} // namespace glare
+
+#endif // GLARE_TREE_STATS_H
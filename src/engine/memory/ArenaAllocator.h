@@ -0,0 +1,189 @@
+#ifndef GLARE_ARENA_ALLOCATOR_H
+#define GLARE_ARENA_ALLOCATOR_H
+
+#include "containers\GlareCoreUtility.h"
+#include "memory\allocators.h"
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+#ifndef GLARE_ARENA_BLOCK_SIZE
+    #define GLARE_ARENA_BLOCK_SIZE  (1 << 20)
+#endif
+
+// Bump allocation from big blocks, one arena per tag type. Nothing is given back one element at a time, deallocate does nothing and
+// reset() frees every block at once. A container whose nodes have no destructor to run can then drop them all in O(1), see
+// allocator_frees_in_bulk; the memory is reclaimed by the next reset().
+//
+//      struct FrameArena {};
+//      RedBlackTree<int, int, less<int>, ArenaAllocator<int, FrameArena> > tree;
+//      ...
+//      tree.clear();                           // O(1), no node is visited.
+//      Arena<FrameArena>::reset();             // Once nothing allocated from the arena is in use.
+//
+// Allocating is serialized by a mutex so the parallel algorithms of the containers can allocate from the pool threads.
+
+namespace glare
+{
+    struct default_arena_tag {};
+
+    template<typename _Tag>
+    class Arena
+    {
+    public:
+        // Post: _bytes of storage aligned on _align, a power of two no greater than the alignment of operator new.
+        static void* allocate(std::size_t _bytes, std::size_t _align);
+
+        // Pre: Nothing allocated from the arena is in use.
+        // Post: Every block is freed.
+        static void reset();
+
+        // Bytes handed out since the last reset, and bytes held in blocks.
+        static std::size_t used() { return s_used; }
+        static std::size_t reserved() { return s_reserved; }
+
+    private:
+        // Blocks are chained through their first bytes.
+        struct block_header
+        {
+            block_header*   m_next;
+            std::size_t     m_padding;  // Keeps the payload aligned like operator new.
+        };
+
+        static block_header*    s_blocks;
+        static char*            s_current;
+        static char*            s_end;
+        static std::size_t      s_used;
+        static std::size_t      s_reserved;
+        static std::mutex       s_mutex;
+    };
+
+    template<typename _Tag> typename Arena<_Tag>::block_header* Arena<_Tag>::s_blocks = nullptr;
+    template<typename _Tag> char*                               Arena<_Tag>::s_current = nullptr;
+    template<typename _Tag> char*                               Arena<_Tag>::s_end = nullptr;
+    template<typename _Tag> std::size_t                         Arena<_Tag>::s_used = 0;
+    template<typename _Tag> std::size_t                         Arena<_Tag>::s_reserved = 0;
+    template<typename _Tag> std::mutex                          Arena<_Tag>::s_mutex;
+
+    template<typename _Tag>
+    void* Arena<_Tag>::allocate(std::size_t _bytes, std::size_t _align)
+    {
+        GLARE_ASSERT(_align && (_align & (_align - 1)) == 0, "The alignment must be a power of two");
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        std::uintptr_t address = (reinterpret_cast<std::uintptr_t>(s_current) + _align - 1) & ~static_cast<std::uintptr_t>(_align - 1);
+        if (s_current == nullptr || address + _bytes > reinterpret_cast<std::uintptr_t>(s_end))
+        {
+            // A new block, bigger than usual for a big allocation. What is left of the current one is lost.
+            const std::size_t payload = _bytes + _align > GLARE_ARENA_BLOCK_SIZE ? _bytes + _align : GLARE_ARENA_BLOCK_SIZE;
+            block_header* block = static_cast<block_header*>(::operator new(sizeof(block_header) + payload));
+            block->m_next = s_blocks;
+            s_blocks = block;
+            s_current = reinterpret_cast<char*>(block + 1);
+            s_end = s_current + payload;
+            s_reserved += payload;
+
+            address = (reinterpret_cast<std::uintptr_t>(s_current) + _align - 1) & ~static_cast<std::uintptr_t>(_align - 1);
+        }
+
+        s_current = reinterpret_cast<char*>(address + _bytes);
+        s_used += _bytes;
+        return reinterpret_cast<void*>(address);
+    }
+
+    template<typename _Tag>
+    void Arena<_Tag>::reset()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        while (s_blocks)
+        {
+            block_header* next = s_blocks->m_next;
+            ::operator delete(s_blocks);
+            s_blocks = next;
+        }
+        s_current = nullptr;
+        s_end = nullptr;
+        s_used = 0;
+        s_reserved = 0;
+    }
+
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    // Allocator interface over the arena of _Tag, for the containers: every type rebound from it shares the same arena.
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+    template<typename T, typename _Tag = default_arena_tag>
+    class ArenaAllocator
+    {
+    public:
+        typedef T value_type;
+        typedef value_type* pointer;
+        typedef const value_type* const_pointer;
+        typedef value_type& reference;
+        typedef const value_type& const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef _Tag tag_type;
+
+    public:
+        template<typename U>
+        struct rebind{
+            typedef ArenaAllocator<U, _Tag> other;
+        };
+
+    public:
+        inline ArenaAllocator() {}
+        inline ArenaAllocator(ArenaAllocator const&) {}
+
+        template<typename U>
+        inline explicit ArenaAllocator(ArenaAllocator<U, _Tag> const&) {}
+
+        inline pointer allocate(size_type cnt, std::allocator<void>::const_pointer = 0)
+        {
+            return static_cast<pointer>(Arena<_Tag>::allocate(cnt * sizeof(T), GLARE_ALIGNOF(T)));
+        }
+
+        // The memory goes back with Arena<_Tag>::reset().
+        inline void deallocate(pointer, size_type) {}
+
+        inline void construct(pointer p)
+        {
+            new (p) T;
+        }
+
+        inline void construct(pointer p, const_reference o)
+        {
+            new (p) T(o);
+        }
+
+        template<typename Other>
+        inline void construct(pointer p, Other&& ref)
+        {
+            new (p) T(std::forward<Other>(ref));
+        }
+
+        template<typename Arg1, typename Arg2>
+        inline void construct(pointer p, Arg1&& arg1, Arg2&& arg2)
+        {
+            new (p) T(std::forward<Arg1>(arg1), std::forward<Arg2>(arg2));
+        }
+
+        inline void destroy(pointer p) { p->~T(); }
+
+        inline bool operator==(ArenaAllocator const&) {return true;}
+        inline bool operator!=(ArenaAllocator const& a) {return !operator==(a);}
+
+        inline size_type max_size() const { 
+            return std::numeric_limits<size_type>::max() / sizeof(T);
+        }
+    };
+
+    template<typename T, typename _Tag>
+    struct allocator_frees_in_bulk<ArenaAllocator<T, _Tag> >
+    {
+        static const bool value = true;
+    };
+
+} // namespace
+
+#endif // GLARE_ARENA_ALLOCATOR_H
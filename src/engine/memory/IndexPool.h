@@ -0,0 +1,209 @@
+#ifndef GLARE_INDEX_POOL_H
+#define GLARE_INDEX_POOL_H
+
+#include "containers\GlareCoreUtility.h"
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+
+// A fixed capacity pool of T addressed by 32-bit indices, one pool per type. Index 0 is never handed out and stands for a null link, so
+// a structure can link its elements with 4 byte indices rather than pointers; at() and index() convert either way with an addition or a
+// subtraction on the single block of the pool. The pool never grows since its elements can't move once linked, reserve() sizes it
+// before the first allocation.
+//
+//      IndexPool<Node>::reserve(1 << 20);
+//      Node* node = IndexPool<Node>::allocate();       // Storage only, nothing is constructed.
+//      std::uint32_t link = IndexPool<Node>::index(node);
+//
+// Allocating and freeing are serialized by a mutex, at() and index() don't lock.
+
+namespace glare
+{
+    // The highest index the elements of T can hold, up to the last one before the null link wraps around. A type keeping other bits
+    // next to its indices specializes it, reserve() then holds the pool to it.
+    template<typename T>
+    struct index_pool_limit
+    {
+        static const std::uint32_t value = 0xFFFFFFFEu;
+    };
+
+    template<typename T>
+    class IndexPool
+    {
+    public:
+        typedef T                                               value_type;
+        typedef T*                                              pointer;
+        typedef const T*                                        const_pointer;
+        typedef std::uint32_t                                   index_type;
+
+        // Pre: Nothing is allocated from the pool.
+        // Post: Room for _capacity elements, indices 1 to _capacity. Zero frees the block. Over index_pool_limit<T> the capacity is
+        //       cut down to it, and allocate() throws once it is reached.
+        static void reserve(index_type _capacity);
+
+        // Post: Storage for one element, nothing constructed. Throws std::bad_alloc when the pool is full.
+        static pointer allocate();
+        static void deallocate(pointer _ptr);
+
+        static pointer at(index_type _index) { return _index ? s_elements + _index : nullptr; }
+        static index_type index(const_pointer _ptr);
+
+        static index_type capacity() { return s_capacity; }
+        static index_type size() { return s_size; }
+
+    private:
+        // A free slot holds the index of the next free slot.
+        static index_type& next_free(pointer _ptr) { return *reinterpret_cast<index_type*>(_ptr); }
+
+        static pointer      s_elements;     // s_elements[0] is never used.
+        static index_type   s_capacity;
+        static index_type   s_size;
+        static index_type   s_freeList;     // Slots freed so far.
+        static index_type   s_untouched;    // Slots from here to s_capacity were never allocated.
+        static std::mutex   s_mutex;
+    };
+
+    template<typename T> typename IndexPool<T>::pointer     IndexPool<T>::s_elements = nullptr;
+    template<typename T> typename IndexPool<T>::index_type  IndexPool<T>::s_capacity = 0;
+    template<typename T> typename IndexPool<T>::index_type  IndexPool<T>::s_size = 0;
+    template<typename T> typename IndexPool<T>::index_type  IndexPool<T>::s_freeList = 0;
+    template<typename T> typename IndexPool<T>::index_type  IndexPool<T>::s_untouched = 1;
+    template<typename T> std::mutex                         IndexPool<T>::s_mutex;
+
+    template<typename T>
+    void IndexPool<T>::reserve(index_type _capacity)
+    {
+        static_assert(sizeof(T) >= sizeof(index_type), "A free slot must hold the index of the next one");
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+        GLARE_ASSERT(s_size == 0, "The pool can't move its elements while they are in use");
+        GLARE_ASSERT(_capacity < std::numeric_limits<index_type>::max(), "Index 0 is taken by the null link");
+        GLARE_ASSERT(_capacity <= index_pool_limit<T>::value, "The elements can't link to indices that high");
+        if (_capacity > index_pool_limit<T>::value) {
+            _capacity = index_pool_limit<T>::value;
+        }
+
+        ::operator delete(s_elements);
+        s_elements = _capacity ? static_cast<pointer>(::operator new((static_cast<std::size_t>(_capacity) + 1) * sizeof(T))) : nullptr;
+        s_capacity = _capacity;
+        s_freeList = 0;
+        s_untouched = 1;
+    }
+
+    template<typename T>
+    typename IndexPool<T>::pointer IndexPool<T>::allocate()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        pointer ptr = nullptr;
+        if (s_freeList)
+        {
+            ptr = s_elements + s_freeList;
+            s_freeList = next_free(ptr);
+        }
+        else if (s_untouched <= s_capacity)
+        {
+            ptr = s_elements + s_untouched++;
+        }
+        else
+        {
+            throw std::bad_alloc();
+        }
+
+        ++s_size;
+        return ptr;
+    }
+
+    template<typename T>
+    void IndexPool<T>::deallocate(pointer _ptr)
+    {
+        if (_ptr == nullptr)
+            return;
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+        next_free(_ptr) = s_freeList;
+        s_freeList = index(_ptr);
+        --s_size;
+    }
+
+    template<typename T>
+    typename IndexPool<T>::index_type IndexPool<T>::index(const_pointer _ptr)
+    {
+        if (_ptr == nullptr)
+            return 0;
+
+        GLARE_ASSERT(_ptr > s_elements && _ptr <= s_elements + s_capacity, "The element was not allocated from this pool");
+        return static_cast<index_type>(_ptr - s_elements);
+    }
+
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    // Allocator interface over the pool of the rebound type, for the containers: every allocation is a single element.
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+    template<typename T>
+    class IndexPoolAllocator
+    {
+    public:
+        typedef T value_type;
+        typedef value_type* pointer;
+        typedef const value_type* const_pointer;
+        typedef value_type& reference;
+        typedef const value_type& const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+    public:
+        template<typename U>
+        struct rebind{
+            typedef IndexPoolAllocator<U> other;
+        };
+
+    public:
+        inline IndexPoolAllocator() {}
+        inline IndexPoolAllocator(IndexPoolAllocator const&) {}
+
+        template<typename U>
+        inline explicit IndexPoolAllocator(IndexPoolAllocator<U> const&) {}
+
+        inline pointer allocate(size_type cnt)
+        {
+            GLARE_ASSERT(cnt == 1, "The pool hands out one element at a time");
+            return IndexPool<T>::allocate();
+        }
+
+        inline void deallocate(pointer p, size_type) { IndexPool<T>::deallocate(p); }
+
+        inline void construct(pointer p)
+        {
+            new (p) T;
+        }
+
+        inline void construct(pointer p, const_reference o)
+        {
+            new (p) T(o);
+        }
+
+        template<typename Other>
+        inline void construct(pointer p, Other&& ref)
+        {
+            new (p) T(std::forward<Other>(ref));
+        }
+
+        template<typename Arg1, typename Arg2>
+        inline void construct(pointer p, Arg1&& arg1, Arg2&& arg2)
+        {
+            new (p) T(std::forward<Arg1>(arg1), std::forward<Arg2>(arg2));
+        }
+
+        inline void destroy(pointer p) { p->~T(); }
+
+        inline bool operator==(IndexPoolAllocator const&) {return true;}
+        inline bool operator!=(IndexPoolAllocator const& a) {return !operator==(a);}
+
+        inline size_type max_size() const { return IndexPool<T>::capacity(); }
+    };
+
+} // namespace
+
+#endif // GLARE_INDEX_POOL_H
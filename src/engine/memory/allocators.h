@@ -75,9 +75,15 @@ namespace glare
         }
 
         template<typename Other>
-        inline void construct(pointer p, Other& ref)
+        inline void construct(pointer p, Other&& ref)
         {
-            new (p) T(ref);
+            new (p) T(std::forward<Other>(ref));
+        }
+
+        template<typename Arg1, typename Arg2>
+        inline void construct(pointer p, Arg1&& arg1, Arg2&& arg2)
+        {
+            new (p) T(std::forward<Arg1>(arg1), std::forward<Arg2>(arg2));
         }
 
         inline void destroy(pointer p) { p->~T(); }
@@ -90,6 +96,14 @@ namespace glare
             return std::numeric_limits<size_type>::max() / sizeof(T);
         }
     };
+
+    // True for the allocators whose deallocate does nothing, the memory going back all at once some other way (ArenaAllocator). A
+    // container whose nodes have a trivial destructor then drops them without visiting them.
+    template<typename _Alloc>
+    struct allocator_frees_in_bulk
+    {
+        static const bool value = false;
+    };
 } // namespace
 
 #define default_allocator glare::Allocator
@@ -0,0 +1,46 @@
+#ifndef GLARE_PARALLEL_ALGORITHMS_H
+#define GLARE_PARALLEL_ALGORITHMS_H
+
+#include "threading\ThreadPool.h"
+#include <algorithm>
+#include <iterator>
+
+// Divide and conquer algorithms over a ThreadPool. Every one of them takes the pool by pointer and runs sequentially on the calling
+// thread when it is nullptr, so the containers can offer one code path with the pool as an option.
+
+namespace glare
+{
+    // Below this many elements a piece is not worth a task.
+    static const std::size_t PARALLEL_SORT_GRAIN = 1 << 14;
+
+    namespace parallel_detail
+    {
+        template<typename _RandomIterator, typename _Compare>
+        void stable_sort(_RandomIterator _first, _RandomIterator _last, const _Compare& _comp, ThreadPool* _pool, unsigned int _forkDepth)
+        {
+            if (_pool == nullptr || _forkDepth == 0 || static_cast<std::size_t>(_last - _first) < PARALLEL_SORT_GRAIN)
+            {
+                std::stable_sort(_first, _last, _comp);
+                return;
+            }
+
+            _RandomIterator middle = _first + (_last - _first) / 2;
+            parallel_invoke(_pool,
+                [=]() { stable_sort(_first, middle, _comp, _pool, _forkDepth - 1); },
+                [=]() { stable_sort(middle, _last, _comp, _pool, _forkDepth - 1); });
+
+            std::inplace_merge(_first, middle, _last, _comp);
+        }
+    }
+
+    // Post: [_first, _last) is sorted by _comp, equal elements keep their order. The halves are sorted in parallel and merged back on
+    //       the way up; the merges are sequential, so the last one bounds the speedup.
+    template<typename _RandomIterator, typename _Compare>
+    void parallel_stable_sort(_RandomIterator _first, _RandomIterator _last, const _Compare& _comp, ThreadPool* _pool)
+    {
+        parallel_detail::stable_sort(_first, _last, _comp, _pool, _pool ? parallel_fork_depth(*_pool) : 0);
+    }
+
+} // namespace
+
+#endif // GLARE_PARALLEL_ALGORITHMS_H
@@ -0,0 +1,125 @@
+#ifndef GLARE_RECLAIMER_H
+#define GLARE_RECLAIMER_H
+
+#include "containers\GlareCoreUtility.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// A background thread freeing what the containers hand over, so clear() and the destructor of a big tree return at once instead of
+// walking every node. A retired job owns what it frees: the nodes are detached from their container before it is queued, and the
+// container can be refilled or destroyed right away.
+//
+//      Reclaimer reclaimer;
+//      tree.setReclaimer(&reclaimer);
+//      tree.clear();                           // O(1), the nodes are freed on the reclaimer thread.
+//
+// The reclaimer must outlive the containers using it, its destructor runs the jobs left before joining. Jobs must not throw.
+
+namespace glare
+{
+    class Reclaimer
+    {
+    public:
+        typedef std::function<void()>                           job_type;
+
+        Reclaimer();
+        ~Reclaimer();
+
+        // Post: _job runs on the reclaimer thread, after the jobs retired before it.
+        void retire(const job_type& _job);
+
+        // Post: Every job retired so far has run.
+        void drain();
+
+        // Jobs retired and not completed yet.
+        std::size_t pending() const;
+
+    private:
+        Reclaimer(const Reclaimer&);
+        Reclaimer& operator= (const Reclaimer&);
+
+        void threadLoop();
+
+        std::deque<job_type>        m_jobs;
+        std::size_t                 m_running;      // 1 while a job dequeued is running.
+        mutable std::mutex          m_mutex;
+        std::condition_variable     m_wakeUp;
+        std::condition_variable     m_drained;
+        bool                        m_stopping;
+        std::thread                 m_thread;       // Last, started once the rest is initialized.
+    };
+
+    inline Reclaimer::Reclaimer(): m_running(0)
+                                 , m_stopping(false)
+    {
+        m_thread = std::thread(&Reclaimer::threadLoop, this);
+    }
+
+    inline Reclaimer::~Reclaimer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wakeUp.notify_one();
+        m_thread.join();
+    }
+
+    inline void Reclaimer::retire(const job_type& _job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push_back(_job);
+        }
+        m_wakeUp.notify_one();
+    }
+
+    inline void Reclaimer::drain()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_jobs.empty() || m_running)
+            m_drained.wait(lock);
+    }
+
+    inline std::size_t Reclaimer::pending() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_jobs.size() + m_running;
+    }
+
+    inline void Reclaimer::threadLoop()
+    {
+        for (;;)
+        {
+            job_type job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                while (!m_stopping && m_jobs.empty())
+                    m_wakeUp.wait(lock);
+
+                if (m_jobs.empty())
+                    return; // Stopping and drained.
+
+                job = m_jobs.front();
+                m_jobs.pop_front();
+                m_running = 1;
+            }
+            job();
+
+            bool drained = false;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_running = 0;
+                drained = m_jobs.empty();
+            }
+            if (drained)
+                m_drained.notify_all();
+        }
+    }
+
+} // namespace
+
+#endif // GLARE_RECLAIMER_H
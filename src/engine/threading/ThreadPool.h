@@ -0,0 +1,197 @@
+#ifndef GLARE_THREAD_POOL_H
+#define GLARE_THREAD_POOL_H
+
+#include "containers\GlareCoreUtility.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// A fixed set of worker threads fed from a single queue, sized for the fork/join algorithms of the containers: a TaskGroup forks tasks
+// onto the pool and its wait() runs queued tasks on the waiting thread instead of blocking. A task can therefore fork and wait itself,
+// at any depth, without deadlocking, and a pool without a single worker still completes everything on the caller's thread.
+//
+//      ThreadPool pool;                        // hardware_concurrency() - 1 workers, the caller is the last thread.
+//      TaskGroup group(pool);
+//      group.run([&]() { left = build(lo, mid); });
+//      right = build(mid, hi);
+//      group.wait();
+//
+// Tasks must not throw.
+
+namespace glare
+{
+    class ThreadPool
+    {
+    public:
+        typedef std::function<void()>                           task_type;
+
+        // _workers == 0 picks hardware_concurrency() - 1 since the thread waiting on a TaskGroup works too.
+        explicit ThreadPool(unsigned int _workers = 0);
+        ~ThreadPool();
+
+        unsigned int workerCount() const { return static_cast<unsigned int>(m_workers.size()); }
+
+        // Threads working on a TaskGroup: the workers and the waiting thread.
+        unsigned int concurrency() const { return workerCount() + 1; }
+
+        // Post: _task runs on a worker, or on a thread waiting on a TaskGroup, whichever dequeues it first.
+        void submit(const task_type& _task);
+
+        // Post: One queued task ran on the calling thread, false when the queue was empty.
+        bool runPending();
+
+    private:
+        ThreadPool(const ThreadPool&);
+        ThreadPool& operator= (const ThreadPool&);
+
+        void workerLoop();
+
+        GLARE_VECTOR<std::thread>   m_workers;
+        std::deque<task_type>       m_tasks;
+        std::mutex                  m_mutex;
+        std::condition_variable     m_wakeUp;
+        bool                        m_stopping;
+    };
+
+    inline ThreadPool::ThreadPool(unsigned int _workers): m_stopping(false)
+    {
+        if (_workers == 0)
+        {
+            const unsigned int hardware = std::thread::hardware_concurrency();
+            _workers = hardware > 1 ? hardware - 1 : 1;
+        }
+
+        m_workers.reserve(_workers);
+        for (unsigned int i = 0; i < _workers; ++i)
+            m_workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+    }
+
+    inline ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wakeUp.notify_all();
+
+        for (std::size_t i = 0; i < m_workers.size(); ++i)
+            m_workers[i].join();
+    }
+
+    inline void ThreadPool::submit(const task_type& _task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(_task);
+        }
+        m_wakeUp.notify_one();
+    }
+
+    inline bool ThreadPool::runPending()
+    {
+        task_type task;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_tasks.empty())
+                return false;
+
+            // Newest first: the waiting thread is most likely waiting on what it forked last.
+            task = m_tasks.back();
+            m_tasks.pop_back();
+        }
+        task();
+        return true;
+    }
+
+    inline void ThreadPool::workerLoop()
+    {
+        for (;;)
+        {
+            task_type task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                while (!m_stopping && m_tasks.empty())
+                    m_wakeUp.wait(lock);
+
+                if (m_tasks.empty())
+                    return; // Stopping and drained.
+
+                // Oldest first: the earliest forks are the biggest pieces of work.
+                task = m_tasks.front();
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    // Tasks forked together and joined by wait(). The group must outlive its tasks, the destructor waits.
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+    class TaskGroup
+    {
+    public:
+        explicit TaskGroup(ThreadPool& _pool): m_pool(_pool), m_pending(0) {}
+        ~TaskGroup() { wait(); }
+
+        template<typename _Func>
+        void run(const _Func& _func)
+        {
+            ++m_pending;
+            std::atomic<std::size_t>* pending = &m_pending;
+            m_pool.submit([=]() { _func(); --(*pending); });
+        }
+
+        // Post: Every task run so far has completed. The calling thread runs queued tasks meanwhile, its own or not.
+        void wait()
+        {
+            while (m_pending.load() != 0)
+            {
+                if (!m_pool.runPending())
+                    std::this_thread::yield();
+            }
+        }
+
+        ThreadPool& pool() const { return m_pool; }
+
+    private:
+        TaskGroup(const TaskGroup&);
+        TaskGroup& operator= (const TaskGroup&);
+
+        ThreadPool&                 m_pool;
+        std::atomic<std::size_t>    m_pending;
+    };
+
+    // Runs both, _left forked onto _pool when there is one, _right on the calling thread.
+    template<typename _Left, typename _Right>
+    void parallel_invoke(ThreadPool* _pool, const _Left& _left, const _Right& _right)
+    {
+        if (_pool)
+        {
+            TaskGroup group(*_pool);
+            group.run(_left);
+            _right();
+            group.wait();
+        }
+        else
+        {
+            _left();
+            _right();
+        }
+    }
+
+    // Fork depth that gives every thread of _pool a few pieces of work in a binary divide and conquer, so the uneven halves balance out.
+    inline unsigned int parallel_fork_depth(const ThreadPool& _pool)
+    {
+        unsigned int depth = 2;
+        for (unsigned int threads = _pool.concurrency(); threads > 1; threads = (threads + 1) / 2)
+            ++depth;
+        return depth;
+    }
+
+} // namespace
+
+#endif // GLARE_THREAD_POOL_H
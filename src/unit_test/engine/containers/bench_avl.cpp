@@ -0,0 +1,281 @@
+#include "containers/AvlTree.h"
+#include "containers/AvlIndexTree.h"
+#include "bench_containers.h"
+#include "gtest/gtest.h"
+
+
+namespace glare { namespace glare_test { namespace bench_avl
+{
+    // --------------------------------------------------------------------------------------------------
+    typedef int                                 bench_val_t;
+    typedef AvlTree<int, bench_val_t>           bench_tree_t;
+
+    // Post: Reports inserting _keys into an empty tree and then removing them in the order of _removals, with the iterative
+    //       insert() and remove() and with the recursive versions they replaced.
+    void benchUpdates(const char* _name, const std::vector<int>& _keys, const std::vector<int>& _removals)
+    {
+        char label[128];
+        for (int recursive = 0; recursive < 2; ++recursive)
+        {
+            const char* kind = recursive ? "recursive" : "iterative";
+            bench_tree_t tree;
+
+            BenchTimer timer;
+            if (recursive)
+            {
+                for (std::size_t i = 0; i < _keys.size(); ++i) {
+                    tree.insert_recursive(bench_tree_t::pair_type(_keys[i], static_cast<bench_val_t>(i)));
+                }
+            }
+            else
+            {
+                for (std::size_t i = 0; i < _keys.size(); ++i) {
+                    tree.insert(_keys[i], static_cast<bench_val_t>(i));
+                }
+            }
+            std::sprintf(label, "%s insert, %s", _name, kind);
+            benchReport(label, _keys.size(), timer.elapsedMs());
+
+            timer.reset();
+            if (recursive)
+            {
+                for (std::size_t i = 0; i < _removals.size(); ++i) {
+                    tree.remove_recursive(_removals[i]);
+                }
+            }
+            else
+            {
+                for (std::size_t i = 0; i < _removals.size(); ++i) {
+                    tree.remove(_removals[i]);
+                }
+            }
+            std::sprintf(label, "%s remove, %s", _name, kind);
+            benchReport(label, _removals.size(), timer.elapsedMs());
+
+            EXPECT_EQ(0u, tree.size());
+        }
+    }
+
+    TEST(AvlTree_Benchmark, DISABLED_iterative_updates)
+    {
+        std::vector<int> keys, removals;
+        benchRandomKeys(keys, BENCH_LARGE_SIZE);
+        benchRandomKeys(removals, BENCH_LARGE_SIZE, BENCH_SEED + 1);
+
+        benchHeader("AvlTree iterative vs recursive updates, large set");
+        benchUpdates("random", keys, removals);
+
+        // Every insertion on the right edge, the deepest path and a rotation every other key.
+        benchSequentialKeys(keys, BENCH_LARGE_SIZE);
+        benchUpdates("increasing", keys, keys);
+
+        benchRandomKeys(keys, BENCH_SMALL_SIZE);
+        benchRandomKeys(removals, BENCH_SMALL_SIZE, BENCH_SEED + 1);
+        benchHeader("AvlTree iterative vs recursive updates, small set");
+        benchUpdates("random", keys, removals);
+    }
+
+    TEST(AvlTree_Benchmark, DISABLED_snapshot)
+    {
+        std::vector<int> keys;
+        benchRandomKeys(keys, BENCH_LARGE_SIZE);
+
+        bench_tree_t tree;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            tree.insert(keys[i], static_cast<bench_val_t>(i));
+        }
+
+        benchHeader("AvlTree save and reload, random keys, large set");
+        {
+            BenchTimer timer;
+            bench_tree_t::serializable_list list;
+            tree.serializeList(list, true);
+            benchReport("serializeList to the list", keys.size(), timer.elapsedMs());
+
+            timer.reset();
+            bench_tree_t loaded;
+            loaded.serializeList(list, false);
+            benchReport("serializeList from the list", keys.size(), timer.elapsedMs());
+            EXPECT_EQ(keys.size(), loaded.size());
+        }
+        {
+            BenchTimer timer;
+            std::vector<unsigned char> buffer(tree.snapshotSize());
+            tree.writeSnapshot(&buffer[0]);
+            benchReport("writeSnapshot", keys.size(), timer.elapsedMs());
+
+            timer.reset();
+            bench_tree_t loaded;
+            EXPECT_TRUE(loaded.loadSnapshot(&buffer[0], buffer.size()));
+            benchReport("loadSnapshot", keys.size(), timer.elapsedMs());
+            EXPECT_EQ(keys.size(), loaded.size());
+        }
+    }
+
+    // The callback traversal can't carry state, it sums into here.
+    long long callbackSum = 0;
+    void sumValue(const int&, const bench_val_t& _value) { callbackSum += _value; }
+
+    // Post: Reports summing the values of _tree in each order, through traverse() and its function pointer and through the
+    //       for_each visitors.
+    void benchTraversals(const char* _name, bench_tree_t& _tree)
+    {
+        const char* orders[] = { "in order", "pre-order", "post-order" };
+        char label[128];
+        for (int order = 0; order < 3; ++order)
+        {
+            if (order == 0)      _tree.setInOrderTraversal();
+            else if (order == 1) _tree.setPreOrderTraversal();
+            else                 _tree.setPostOrderTraversal();
+
+            callbackSum = 0;
+            BenchTimer timer;
+            _tree.traverse(sumValue);
+            std::sprintf(label, "%s %s, traverse", _name, orders[order]);
+            benchReport(label, _tree.size(), timer.elapsedMs());
+
+            long long sum = 0;
+            auto visit = [&sum](const int&, const bench_val_t& _value) -> bool { sum += _value; return true; };
+            timer.reset();
+            if (order == 0)      _tree.for_each_inorder(visit);
+            else if (order == 1) _tree.for_each_preorder(visit);
+            else                 _tree.for_each_postorder(visit);
+            std::sprintf(label, "%s %s, for_each", _name, orders[order]);
+            benchReport(label, _tree.size(), timer.elapsedMs());
+
+            EXPECT_EQ(callbackSum, sum);
+        }
+    }
+
+    TEST(AvlTree_Benchmark, DISABLED_traversal)
+    {
+        std::vector<int> keys;
+        for (int large = 0; large < 2; ++large)
+        {
+            benchRandomKeys(keys, large ? BENCH_LARGE_SIZE : BENCH_SMALL_SIZE);
+
+            bench_tree_t tree;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                tree.insert(keys[i], static_cast<bench_val_t>(i));
+            }
+
+            benchHeader(large ? "AvlTree traversal, large set" : "AvlTree traversal, small set");
+            benchTraversals("random", tree);
+        }
+    }
+
+    TEST(AvlTree_Benchmark, DISABLED_morris_inorder)
+    {
+        std::vector<int> keys;
+        for (int large = 0; large < 2; ++large)
+        {
+            benchRandomKeys(keys, large ? BENCH_LARGE_SIZE : BENCH_SMALL_SIZE);
+
+            bench_tree_t tree;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                tree.insert(keys[i], static_cast<bench_val_t>(i));
+            }
+
+            benchHeader(large ? "AvlTree in order, recursive vs threaded, large set" : "AvlTree in order, recursive vs threaded, small set");
+
+            long long expected = 0;
+            BenchTimer timer;
+            tree.for_each_inorder([&expected](const int&, const bench_val_t& _value) -> bool { expected += _value; return true; });
+            benchReport("for_each_inorder", keys.size(), timer.elapsedMs());
+
+            long long sum = 0;
+            timer.reset();
+            tree.morris_for_each_inorder([&sum](const int&, const bench_val_t& _value) -> bool { sum += _value; return true; });
+            benchReport("morris_for_each_inorder", keys.size(), timer.elapsedMs());
+            EXPECT_EQ(expected, sum);
+
+            sum = 0;
+            timer.reset();
+            for (bench_tree_t::morris_iterator itr(tree); itr.valid(); ++itr) {
+                sum += itr.value();
+            }
+            benchReport("morris_iterator", keys.size(), timer.elapsedMs());
+            EXPECT_EQ(expected, sum);
+        }
+    }
+
+    // Past 10M entries, where the nodes are way past the last level cache and the TLB.
+    const std::size_t BENCH_HUGE_SIZE = 1 << 24;
+
+    // Post: Reports the updates, lookups, walk, copy and snapshot of _Tree with _keys, and the bytes it holds through
+    //       BenchAllocator.
+    template<typename _Tree>
+    void benchLayout(const char* _name, const std::vector<int>& _keys, const std::vector<int>& _lookups)
+    {
+        char label[128];
+        const std::size_t bytesBefore = benchLiveBytes();
+        _Tree tree;
+
+        BenchTimer timer;
+        for (std::size_t i = 0; i < _keys.size(); ++i) {
+            tree.insert(_keys[i], static_cast<bench_val_t>(i));
+        }
+        std::sprintf(label, "%s insert, %.1f bytes/entry", _name, static_cast<double>(benchLiveBytes() - bytesBefore) / _keys.size());
+        benchReport(label, _keys.size(), timer.elapsedMs());
+
+        std::size_t found = 0;
+        timer.reset();
+        for (std::size_t i = 0; i < _lookups.size(); ++i) {
+            found += (tree.find(_lookups[i]) != nullptr);
+        }
+        std::sprintf(label, "%s find", _name);
+        benchReport(label, _lookups.size(), timer.elapsedMs());
+        EXPECT_EQ(_lookups.size(), found);
+
+        long long sum = 0;
+        timer.reset();
+        tree.for_each_inorder([&sum](const int&, const bench_val_t& _value) -> bool { sum += _value; return true; });
+        std::sprintf(label, "%s for_each_inorder", _name);
+        benchReport(label, _keys.size(), timer.elapsedMs());
+        benchEscape(sum);
+
+        {
+            timer.reset();
+            _Tree copy(tree);
+            std::sprintf(label, "%s copy", _name);
+            benchReport(label, _keys.size(), timer.elapsedMs());
+            EXPECT_EQ(_keys.size(), copy.size());
+        }
+        {
+            timer.reset();
+            std::vector<unsigned char> buffer(tree.snapshotSize());
+            tree.writeSnapshot(&buffer[0]);
+            std::sprintf(label, "%s writeSnapshot", _name);
+            benchReport(label, _keys.size(), timer.elapsedMs());
+
+            timer.reset();
+            _Tree loaded;
+            EXPECT_TRUE(loaded.loadSnapshot(&buffer[0], buffer.size()));
+            std::sprintf(label, "%s loadSnapshot", _name);
+            benchReport(label, _keys.size(), timer.elapsedMs());
+        }
+
+        timer.reset();
+        for (std::size_t i = 0; i < _lookups.size(); ++i) {
+            tree.remove(_lookups[i]);
+        }
+        std::sprintf(label, "%s remove", _name);
+        benchReport(label, _lookups.size(), timer.elapsedMs());
+        EXPECT_EQ(0u, tree.size());
+    }
+
+    TEST(AvlTree_Benchmark, DISABLED_index_layout)
+    {
+        std::vector<int> keys, lookups;
+        benchRandomKeys(keys, BENCH_HUGE_SIZE);
+        benchRandomKeys(lookups, BENCH_HUGE_SIZE, BENCH_SEED + 1);
+
+        benchHeader("AvlTree pointer nodes vs AvlIndexTree, random keys, 16M entries");
+        benchLayout<AvlTree<int, bench_val_t, less<int>, BenchAllocator<bench_val_t> > >("AvlTree", keys, lookups);
+        benchLayout<AvlIndexTree<int, bench_val_t, less<int>, BenchAllocator<bench_val_t> > >("AvlIndexTree", keys, lookups);
+    }
+
+    // --------------------------------------------------------------------------------------------------
+}   // namespace bench_avl
+}   // namespace glare_test
+}   // namespace glare
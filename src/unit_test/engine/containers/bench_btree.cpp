@@ -0,0 +1,272 @@
+#include "containers/BTree.h"
+#include "bench_containers.h"
+#include "gtest/gtest.h"
+
+
+namespace glare { namespace glare_test { namespace bench_btree
+{
+    // --------------------------------------------------------------------------------------------------
+    typedef int         bench_val_t;
+
+    // Pre: _Tree is a BTree like container of _KeyType to bench_val_t.
+    // Post: Reports random insertion and random lookup times for _keys.
+    template<typename _Tree, typename _KeyType>
+    void benchInsertFind(const char* _name, btree_order_t _order, std::size_t _nodeBytes, const std::vector<_KeyType>& _keys)
+    {
+        char label[128];
+        _Tree tree;
+
+        BenchTimer timer;
+        for (std::size_t i = 0; i < _keys.size(); ++i) {
+            tree.insert(_keys[i], static_cast<bench_val_t>(i));
+        }
+        std::sprintf(label, "%s order %u (%u bytes) insert", _name, _order, static_cast<unsigned>(_nodeBytes));
+        benchReport(label, _keys.size(), timer.elapsedMs());
+
+        std::size_t found = 0;
+        timer.reset();
+        for (std::size_t i = _keys.size(); i > 0; --i) {
+            found += tree.find(_keys[i-1]) != nullptr;
+        }
+        std::sprintf(label, "%s order %u (%u bytes) find", _name, _order, static_cast<unsigned>(_nodeBytes));
+        benchReport(label, _keys.size(), timer.elapsedMs());
+
+        EXPECT_EQ(found, _keys.size());
+        benchEscape(found);
+    }
+
+    template<typename _KeyType, std::size_t _TargetNodeBytes>
+    void benchAutoOrder(const char* _name, const std::vector<_KeyType>& _keys)
+    {
+        typedef BTreeAuto<_KeyType, bench_val_t, _TargetNodeBytes> tree_type;
+        benchInsertFind<tree_type>(_name, tree_type::ORDER, tree_type::NODE_BYTES, _keys);
+    }
+
+    template<typename _KeyType>
+    void benchAllTargets(const char* _name, std::size_t _count)
+    {
+        std::vector<_KeyType> keys;
+        benchRandomKeys(keys, _count);
+
+        typedef BTree<_KeyType, bench_val_t, 6> fixed_tree_type;
+        benchInsertFind<fixed_tree_type>(_name, 6, sizeof(BTreeNode<_KeyType, bench_val_t, 6, default_allocator<bench_val_t> >), keys);
+
+        benchAutoOrder<_KeyType, BTREE_NODE_BYTES_CACHE_LINE>(_name, keys);
+        benchAutoOrder<_KeyType, 128>(_name, keys);
+        benchAutoOrder<_KeyType, BTREE_NODE_BYTES_256>(_name, keys);
+        benchAutoOrder<_KeyType, 512>(_name, keys);
+        benchAutoOrder<_KeyType, 1024>(_name, keys);
+        benchAutoOrder<_KeyType, BTREE_NODE_BYTES_PAGE>(_name, keys);
+    }
+
+    TEST(Btree_Benchmark, DISABLED_auto_order)
+    {
+        benchHeader("BTreeAuto, random keys, small set");
+        benchAllTargets<int>("int", BENCH_SMALL_SIZE);
+        benchAllTargets<long long>("int64", BENCH_SMALL_SIZE);
+        benchAllTargets<BenchKey32>("key32", BENCH_SMALL_SIZE);
+
+        benchHeader("BTreeAuto, random keys, large set");
+        benchAllTargets<int>("int", BENCH_LARGE_SIZE);
+        benchAllTargets<long long>("int64", BENCH_LARGE_SIZE);
+        benchAllTargets<BenchKey32>("key32", BENCH_LARGE_SIZE);
+    }
+
+    template<typename _Tree>
+    void benchAppend(const char* _name, const std::vector<int>& _keys)
+    {
+        char label[128];
+        const std::size_t bytesBefore = benchLiveBytes();
+        {
+            _Tree tree;
+
+            BenchTimer timer;
+            for (std::size_t i = 0; i < _keys.size(); ++i) {
+                tree.insert(_keys[i], static_cast<bench_val_t>(i));
+            }
+            const double ms = timer.elapsedMs();
+
+            std::sprintf(label, "%s insert, %.1f bytes/key", _name, static_cast<double>(benchLiveBytes() - bytesBefore) / _keys.size());
+            benchReport(label, _keys.size(), ms);
+        }
+        EXPECT_EQ(benchLiveBytes(), bytesBefore);
+    }
+
+    TEST(Btree_Benchmark, DISABLED_append)
+    {
+        typedef BTree<int, bench_val_t, 6, BenchAllocator<bench_val_t> >                                     btree_6_t;
+        typedef BTreeAuto<int, bench_val_t, BTREE_NODE_BYTES_256, BenchAllocator<bench_val_t> >              btree_256_t;
+        typedef BTreeAuto<int, bench_val_t, BTREE_NODE_BYTES_PAGE, BenchAllocator<bench_val_t> >             btree_page_t;
+
+        std::vector<int> sequential, random;
+        benchSequentialKeys(sequential, BENCH_LARGE_SIZE);
+        benchRandomKeys(random, BENCH_LARGE_SIZE);
+
+        benchHeader("BTree, increasing keys against random keys");
+        benchAppend<btree_6_t>("order 6 increasing", sequential);
+        benchAppend<btree_6_t>("order 6 random", random);
+        benchAppend<btree_256_t>("256 bytes increasing", sequential);
+        benchAppend<btree_256_t>("256 bytes random", random);
+        benchAppend<btree_page_t>("page increasing", sequential);
+        benchAppend<btree_page_t>("page random", random);
+    }
+
+    template<typename _Tree, typename _KeyType>
+    void benchPrefetch(const char* _name, const std::vector<_KeyType>& _keys, const std::vector<_KeyType>& _lookups)
+    {
+        char label[128];
+        _Tree tree;
+        for (std::size_t i = 0; i < _keys.size(); ++i) {
+            tree.insert(_keys[i], static_cast<bench_val_t>(i));
+        }
+
+        const unsigned int Distances[] = { 0, 1, 2, 4, 8 };
+        for (std::size_t d = 0; d < sizeof(Distances) / sizeof(Distances[0]); ++d)
+        {
+            tree.setPrefetchDistance(Distances[d]);
+
+            std::size_t found = 0;
+            BenchTimer timer;
+            for (std::size_t i = 0; i < _lookups.size(); ++i) {
+                found += tree.find(_lookups[i]) != nullptr;
+            }
+            std::sprintf(label, "%s prefetch %u lines", _name, Distances[d]);
+            benchReport(label, _lookups.size(), timer.elapsedMs());
+
+            EXPECT_EQ(found, _lookups.size());
+            benchEscape(found);
+        }
+    }
+
+    TEST(Btree_Benchmark, DISABLED_prefetch)
+    {
+        std::vector<int> keys, lookups;
+        benchRandomKeys(keys, BENCH_LARGE_SIZE);
+        benchRandomKeys(lookups, BENCH_LARGE_SIZE, BENCH_SEED + 1);
+
+        std::vector<BenchKey32> keys32, lookups32;
+        benchRandomKeys(keys32, BENCH_LARGE_SIZE);
+        benchRandomKeys(lookups32, BENCH_LARGE_SIZE, BENCH_SEED + 1);
+
+        benchHeader("BTree::find with prefetching, random keys, large set");
+        benchPrefetch<BTree<int, bench_val_t, 6> >("int order 6", keys, lookups);
+        benchPrefetch<BTreeAuto<int, bench_val_t, BTREE_NODE_BYTES_256> >("int 256 bytes", keys, lookups);
+        benchPrefetch<BTreeAuto<int, bench_val_t, 1024> >("int 1024 bytes", keys, lookups);
+        benchPrefetch<BTreeAuto<BenchKey32, bench_val_t, 1024> >("key32 1024 bytes", keys32, lookups32);
+    }
+
+    template<typename _Tree>
+    void benchBatch(const char* _name, const _Tree& _base, std::size_t _batchSize, std::size_t _totalOps)
+    {
+        typedef typename _Tree::batch_op_type   op_type;
+        typedef typename _Tree::batch_type      batch_type;
+
+        // Random keys over twice the range of the tree, a third each of inserts, updates and removes.
+        std::vector<batch_type> batches(_totalOps / _batchSize);
+        std::mt19937 random(BENCH_SEED);
+        for (std::size_t b = 0; b < batches.size(); ++b)
+        {
+            batches[b].reserve(_batchSize);
+            for (std::size_t i = 0; i < _batchSize; ++i)
+            {
+                const int key = static_cast<int>(random() % (2 * _base.size()));
+                switch (random() % 3)
+                {
+                case 0: batches[b].push_back(op_type(_Tree::BatchOp_Insert, key, key)); break;
+                case 1: batches[b].push_back(op_type(_Tree::BatchOp_Update, key, -key)); break;
+                case 2: batches[b].push_back(op_type(_Tree::BatchOp_Remove, key)); break;
+                }
+            }
+        }
+
+        char label[128];
+        std::size_t changed = 0;
+        {
+            _Tree tree(_base);
+            BenchTimer timer;
+            for (std::size_t b = 0; b < batches.size(); ++b)
+            {
+                for (std::size_t i = 0; i < batches[b].size(); ++i)
+                {
+                    const op_type& op = batches[b][i];
+                    if (op.m_op == _Tree::BatchOp_Remove) {
+                        tree.remove(op.m_key);
+                    }
+                    else if (op.m_op == _Tree::BatchOp_Insert) {
+                        tree.insert(op.m_key, op.m_value);
+                    }
+                    else if (bench_val_t* value = tree.find(op.m_key)) {
+                        *value = op.m_value;
+                    }
+                    else {
+                        tree.insert(op.m_key, op.m_value);
+                    }
+                }
+            }
+            std::sprintf(label, "%s one by one, batches of %u", _name, static_cast<unsigned>(_batchSize));
+            benchReport(label, _totalOps, timer.elapsedMs());
+            changed += tree.size();
+        }
+        {
+            _Tree tree(_base);
+            BenchTimer timer;
+            for (std::size_t b = 0; b < batches.size(); ++b) {
+                changed += tree.apply_batch(batches[b]);
+            }
+            std::sprintf(label, "%s apply_batch, batches of %u", _name, static_cast<unsigned>(_batchSize));
+            benchReport(label, _totalOps, timer.elapsedMs());
+        }
+        benchEscape(changed);
+    }
+
+    template<typename _Tree>
+    void benchBatchSizes(const char* _name)
+    {
+        std::vector<int> keys;
+        benchRandomKeys(keys, BENCH_LARGE_SIZE);
+
+        _Tree base;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            base.insert(keys[i], static_cast<bench_val_t>(i));
+        }
+
+        const std::size_t TotalOps = 1 << 20;
+        benchBatch(_name, base, 64, TotalOps);
+        benchBatch(_name, base, 4096, TotalOps);
+        benchBatch(_name, base, 65536, TotalOps);
+    }
+
+    TEST(Btree_Benchmark, DISABLED_apply_batch)
+    {
+        benchHeader("BTree mixed batches against one op at a time, large set");
+        benchBatchSizes<BTree<int, bench_val_t, 6> >("order 6");
+        benchBatchSizes<BTreeAuto<int, bench_val_t> >("256 bytes");
+    }
+
+    struct bench_btree_arena_tag {};
+
+    TEST(Btree_Benchmark, DISABLED_copy_and_destroy)
+    {
+        typedef ArenaAllocator<bench_val_t, bench_btree_arena_tag> arena_allocator_t;
+
+        std::vector<int> keys;
+        benchRandomKeys(keys, BENCH_LARGE_SIZE);
+        benchCopyAndDestroy<BTree<int, bench_val_t, 6>, BTree<int, bench_val_t, 6, arena_allocator_t>, bench_btree_arena_tag>("BTree order 6", keys);
+        benchCopyAndDestroy<BTree<int, bench_val_t, 64>, BTree<int, bench_val_t, 64, arena_allocator_t>, bench_btree_arena_tag>("BTree order 64", keys);
+    }
+
+    TEST(Btree_Benchmark, DISABLED_range_erase)
+    {
+        typedef BTree<int, bench_val_t, 6>  small_tree_t;
+        typedef BTree<int, bench_val_t, 64> wide_tree_t;
+
+        std::vector<int> keys;
+        benchRandomKeys(keys, BENCH_LARGE_SIZE);
+        benchRangeErase<small_tree_t>("BTree order 6", keys, [](small_tree_t& _tree, int _key) { _tree.remove(_key); });
+        benchRangeErase<wide_tree_t>("BTree order 64", keys, [](wide_tree_t& _tree, int _key) { _tree.remove(_key); });
+    }
+
+    // --------------------------------------------------------------------------------------------------
+}   // namespace bench_btree
+}   // namespace glare_test
+}   // namespace glare
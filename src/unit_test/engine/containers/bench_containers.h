@@ -0,0 +1,241 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdio>
+#include <cstring>
+#include "memory\allocators.h"
+#include "memory\ArenaAllocator.h"
+#include "threading\Reclaimer.h"
+#include "threading\ThreadPool.h"
+
+// Benchmarks live next to the unit tests as disabled gtest cases, so a normal run skips them. To run them:
+//      unit_test --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+// Numbers are printed, not checked, compare them on the same machine with an optimized build.
+
+namespace glare
+{
+    const std::size_t BENCH_SMALL_SIZE = 1 << 16;   // Fits in the caches.
+    const std::size_t BENCH_LARGE_SIZE = 1 << 22;   // Way past the last level cache.
+    const unsigned    BENCH_SEED       = 0x5eed;
+
+    class BenchTimer
+    {
+        typedef std::chrono::high_resolution_clock clock_type;
+
+    public:
+        BenchTimer(): m_start(clock_type::now()) {}
+
+        void reset() { m_start = clock_type::now(); }
+
+        double elapsedMs() const
+        {
+            return std::chrono::duration<double, std::milli>(clock_type::now() - m_start).count();
+        }
+
+    private:
+        clock_type::time_point m_start;
+    };
+
+    // A 32 byte key, stands in for the fixed size string keys we use for names.
+    struct BenchKey32
+    {
+        char m_data[32];
+
+        BenchKey32() { clear(); }
+        BenchKey32(int _value)
+        {
+            clear();
+            std::sprintf(m_data, "key_%024d", _value); // Zero padded, so the order matches the integer order.
+        }
+
+        bool operator <  (const BenchKey32& _other) const { return std::memcmp(m_data, _other.m_data, sizeof(m_data)) <  0; }
+        bool operator >  (const BenchKey32& _other) const { return std::memcmp(m_data, _other.m_data, sizeof(m_data)) >  0; }
+        bool operator == (const BenchKey32& _other) const { return std::memcmp(m_data, _other.m_data, sizeof(m_data)) == 0; }
+
+    private:
+        void clear() { std::memset(m_data, 0, sizeof(m_data)); }
+    };
+
+    // Pre: _count > 0.
+    // Post: _keys holds 0 .. _count-1 in ascending order.
+    template<typename _KeyType>
+    void benchSequentialKeys(std::vector<_KeyType>& _keys, std::size_t _count)
+    {
+        _keys.clear();
+        _keys.reserve(_count);
+        for (std::size_t i = 0; i < _count; ++i) {
+            _keys.push_back(_KeyType(static_cast<int>(i)));
+        }
+    }
+
+    // Post: _keys holds 0 .. _count-1 shuffled, the same shuffle for the same seed.
+    template<typename _KeyType>
+    void benchRandomKeys(std::vector<_KeyType>& _keys, std::size_t _count, unsigned _seed = BENCH_SEED)
+    {
+        std::vector<int> order(_count);
+        for (std::size_t i = 0; i < _count; ++i) {
+            order[i] = static_cast<int>(i);
+        }
+        std::shuffle(order.begin(), order.end(), std::mt19937(_seed));
+
+        _keys.clear();
+        _keys.reserve(_count);
+        for (std::size_t i = 0; i < _count; ++i) {
+            _keys.push_back(_KeyType(order[i]));
+        }
+    }
+
+    inline void benchHeader(const char* _title)
+    {
+        std::printf("\n%s\n", _title);
+        std::printf("%-56s %12s %12s\n", "case", "total ms", "ns/op");
+    }
+
+    inline void benchReport(const char* _name, std::size_t _ops, double _ms)
+    {
+        std::printf("%-56s %12.2f %12.2f\n", _name, _ms, _ops ? (_ms * 1e6) / static_cast<double>(_ops) : 0.0);
+    }
+
+    // Bytes currently held through BenchAllocator, all the rebinds share it.
+    inline std::size_t& benchLiveBytes()
+    {
+        static std::size_t bytes = 0;
+        return bytes;
+    }
+
+    // default_allocator that keeps count of the live bytes, to report the memory a container holds on to.
+    template<typename T>
+    class BenchAllocator: public Allocator<T>
+    {
+    public:
+        typedef typename Allocator<T>::pointer      pointer;
+        typedef typename Allocator<T>::size_type    size_type;
+
+        template<typename U>
+        struct rebind{
+            typedef BenchAllocator<U> other;
+        };
+
+        BenchAllocator() {}
+
+        template<typename U>
+        explicit BenchAllocator(BenchAllocator<U> const&) {}
+
+        pointer allocate(size_type _count, std::allocator<void>::const_pointer _hint = 0)
+        {
+            benchLiveBytes() += _count * sizeof(T);
+            return Allocator<T>::allocate(_count, _hint);
+        }
+
+        void deallocate(pointer _ptr, size_type _count)
+        {
+            benchLiveBytes() -= _count * sizeof(T);
+            Allocator<T>::deallocate(_ptr, _count);
+        }
+    };
+
+    // Keeps the optimizer from throwing away lookups whose result we don't use otherwise.
+    inline void benchEscape(std::size_t _value)
+    {
+        static volatile std::size_t sink = 0;
+        sink = sink + _value;
+    }
+
+    // Pre: _Tree maps _KeyType to int, copies on a ThreadPool and frees through a Reclaimer. _ArenaTree is the same tree allocating
+    //      from Arena<_ArenaTag>.
+    // Post: Reports the deep copy and the destruction of a tree of _keys: sequential, on a pool, through a reclaimer and from an arena.
+    template<typename _Tree, typename _ArenaTree, typename _ArenaTag, typename _KeyType>
+    void benchCopyAndDestroy(const char* _name, const std::vector<_KeyType>& _keys)
+    {
+        ThreadPool pool;
+        char label[128];
+        std::sprintf(label, "%s copy and destruction, random keys, %u threads", _name, pool.concurrency());
+        benchHeader(label);
+
+        _Tree source;
+        for (std::size_t i = 0; i < _keys.size(); ++i) {
+            source.insert(_keys[i], static_cast<int>(i));
+        }
+
+        {
+            BenchTimer timer;
+            _Tree* copy = new _Tree(source, nullptr);
+            benchReport("copy", _keys.size(), timer.elapsedMs());
+
+            timer.reset();
+            delete copy;
+            benchReport("destructor", _keys.size(), timer.elapsedMs());
+        }
+        {
+            BenchTimer timer;
+            _Tree* copy = new _Tree(source, &pool);
+            benchReport("copy on the pool", _keys.size(), timer.elapsedMs());
+
+            Reclaimer reclaimer;
+            copy->setReclaimer(&reclaimer);
+            timer.reset();
+            delete copy;
+            benchReport("destructor with a reclaimer", _keys.size(), timer.elapsedMs());
+
+            timer.reset();
+            reclaimer.drain();
+            benchReport("  then draining the reclaimer", _keys.size(), timer.elapsedMs());
+        }
+        {
+            _ArenaTree arenaTree;
+            for (std::size_t i = 0; i < _keys.size(); ++i) {
+                arenaTree.insert(_keys[i], static_cast<int>(i));
+            }
+
+            BenchTimer timer;
+            arenaTree.clear();
+            benchReport("clear from an arena", _keys.size(), timer.elapsedMs());
+
+            timer.reset();
+            Arena<_ArenaTag>::reset();
+            benchReport("  then resetting the arena", _keys.size(), timer.elapsedMs());
+        }
+    }
+
+    // Pre: _Tree maps int to int, _keys holds 0 .. n-1 and _eraseOne(tree, key) erases a single key.
+    // Post: Reports erasing a contiguous range of keys from a tree of _keys, key by key and with a single erase(lo, hi).
+    template<typename _Tree, typename _EraseOne>
+    void benchRangeErase(const char* _name, const std::vector<int>& _keys, _EraseOne _eraseOne)
+    {
+        char label[128];
+        std::sprintf(label, "%s range erase, random keys", _name);
+        benchHeader(label);
+
+        const unsigned Percents[] = { 1, 10, 50 };
+        for (std::size_t p = 0; p < sizeof(Percents) / sizeof(Percents[0]); ++p)
+        {
+            const int low = static_cast<int>(_keys.size() / 4);
+            const int high = low + static_cast<int>(_keys.size() * Percents[p] / 100);
+            for (int pass = 0; pass < 2; ++pass)
+            {
+                _Tree tree;
+                for (std::size_t i = 0; i < _keys.size(); ++i) {
+                    tree.insert(_keys[i], static_cast<int>(i));
+                }
+
+                BenchTimer timer;
+                if (pass == 0)
+                {
+                    for (int key = low; key < high; ++key) {
+                        _eraseOne(tree, key);
+                    }
+                }
+                else {
+                    benchEscape(tree.erase(low, high));
+                }
+
+                std::sprintf(label, "%u%% of the keys, %s", Percents[p], pass == 0 ? "one at a time" : "erase(lo, hi)");
+                benchReport(label, static_cast<std::size_t>(high - low), timer.elapsedMs());
+            }
+        }
+    }
+
+} // namespace glare
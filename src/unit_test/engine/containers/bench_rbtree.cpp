@@ -0,0 +1,861 @@
+#include "containers/RbTree.h"
+#include "containers/IntrusiveRbTree.h"
+#include "containers/RbTreeCompactNode.h"
+#include "containers/RbTreeAugment.h"
+#include "containers/PersistentRbTree.h"
+#include "containers/RbTreeParallel.h"
+#include "bench_containers.h"
+#include "gtest/gtest.h"
+#include <string>
+
+
+namespace glare { namespace glare_test { namespace bench_rbtree
+{
+    // --------------------------------------------------------------------------------------------------
+    typedef int         bench_val_t;
+
+    template<typename _KeyType>
+    void benchPrefetch(const char* _name, const std::vector<_KeyType>& _keys, const std::vector<_KeyType>& _lookups)
+    {
+        char label[128];
+        RedBlackTree<_KeyType, bench_val_t> tree;
+        for (std::size_t i = 0; i < _keys.size(); ++i) {
+            tree.insert(_keys[i], static_cast<bench_val_t>(i));
+        }
+
+        const unsigned int Distances[] = { 0, 1, 2 };
+        for (std::size_t d = 0; d < sizeof(Distances) / sizeof(Distances[0]); ++d)
+        {
+            tree.setPrefetchDistance(Distances[d]);
+
+            std::size_t found = 0;
+            BenchTimer timer;
+            for (std::size_t i = 0; i < _lookups.size(); ++i) {
+                found += tree.exists(_lookups[i]);
+            }
+            std::sprintf(label, "%s prefetch %u lines", _name, Distances[d]);
+            benchReport(label, _lookups.size(), timer.elapsedMs());
+
+            EXPECT_EQ(found, _lookups.size());
+            benchEscape(found);
+        }
+    }
+
+    TEST(RedBlackTree_Benchmark, DISABLED_prefetch)
+    {
+        std::vector<int> keys, lookups;
+        benchRandomKeys(keys, BENCH_LARGE_SIZE);
+        benchRandomKeys(lookups, BENCH_LARGE_SIZE, BENCH_SEED + 1);
+
+        std::vector<BenchKey32> keys32, lookups32;
+        benchRandomKeys(keys32, BENCH_LARGE_SIZE);
+        benchRandomKeys(lookups32, BENCH_LARGE_SIZE, BENCH_SEED + 1);
+
+        benchHeader("RedBlackTree::find with prefetching, random keys, large set");
+        benchPrefetch("int", keys, lookups);
+        benchPrefetch("key32", keys32, lookups32);
+    }
+
+    // --------------------------------------------------------------------------------------------------
+    struct BenchEntity
+    {
+        int         m_key;
+        int         m_payload[6];
+        RbTreeHook  m_hook;
+    };
+
+    struct BenchEntityKey
+    {
+        typedef int key_type;
+        const key_type& operator() (const BenchEntity& _entity) const { return _entity.m_key; }
+    };
+
+    TEST(RedBlackTree_Benchmark, DISABLED_intrusive)
+    {
+        std::vector<int> keys;
+        benchRandomKeys(keys, BENCH_LARGE_SIZE);
+
+        // The objects live in a pool either way, RedBlackTree copies them into its nodes.
+        std::vector<BenchEntity> pool(keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            pool[i].m_key = keys[i];
+        }
+
+        benchHeader("RedBlackTree vs IntrusiveRbTree, pooled objects, random keys, large set");
+
+        {
+            typedef RedBlackTree<int, BenchEntity, less<int>, BenchAllocator<BenchEntity> > tree_t;
+            tree_t tree;
+            const std::size_t bytesBefore = benchLiveBytes();
+
+            BenchTimer insertTimer;
+            for (std::size_t i = 0; i < pool.size(); ++i) {
+                tree.insert(pool[i].m_key, pool[i]);
+            }
+            char label[128];
+            std::sprintf(label, "RedBlackTree insert, %.1f bytes/key", static_cast<double>(benchLiveBytes() - bytesBefore) / pool.size());
+            benchReport(label, pool.size(), insertTimer.elapsedMs());
+
+            std::size_t found = 0;
+            BenchTimer findTimer;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                found += tree.exists(keys[i]);
+            }
+            benchReport("RedBlackTree find", keys.size(), findTimer.elapsedMs());
+            benchEscape(found);
+
+            BenchTimer eraseTimer;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                tree.erase(keys[i]);
+            }
+            benchReport("RedBlackTree erase", keys.size(), eraseTimer.elapsedMs());
+        }
+
+        {
+            typedef IntrusiveRbTree<BenchEntity, &BenchEntity::m_hook, BenchEntityKey> tree_t;
+            tree_t tree;
+
+            BenchTimer insertTimer;
+            for (std::size_t i = 0; i < pool.size(); ++i) {
+                tree.insert(pool[i]);
+            }
+            benchReport("IntrusiveRbTree insert", pool.size(), insertTimer.elapsedMs());
+
+            std::size_t found = 0;
+            BenchTimer findTimer;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                found += tree.exists(keys[i]);
+            }
+            benchReport("IntrusiveRbTree find", keys.size(), findTimer.elapsedMs());
+            benchEscape(found);
+
+            BenchTimer eraseTimer;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                tree.erase(keys[i]);
+            }
+            benchReport("IntrusiveRbTree erase", keys.size(), eraseTimer.elapsedMs());
+            EXPECT_TRUE(tree.empty());
+        }
+    }
+
+    // --------------------------------------------------------------------------------------------------
+    typedef RedBlackTree<int, bench_val_t> bench_rbtree_t;
+
+    void benchSetOperations(const char* _name, const bench_rbtree_t& _big, bench_rbtree_t& _small, ThreadPool& _pool)
+    {
+        char label[128];
+        const std::size_t ops = _small.size();
+
+        {
+            bench_rbtree_t tree(_big);
+            BenchTimer timer;
+            for (bench_rbtree_t::iterator it = _small.begin(); it != _small.end(); ++it) {
+                tree.insert(*it);
+            }
+            std::sprintf(label, "%s union, one insert at a time", _name);
+            benchReport(label, ops, timer.elapsedMs());
+        }
+        {
+            bench_rbtree_t tree(_big);
+            BenchTimer timer;
+            tree.set_union(_small);
+            std::sprintf(label, "%s set_union", _name);
+            benchReport(label, ops, timer.elapsedMs());
+        }
+        {
+            bench_rbtree_t tree(_big);
+            BenchTimer timer;
+            tree.set_union(_small, &_pool);
+            std::sprintf(label, "%s set_union, %u threads", _name, _pool.concurrency());
+            benchReport(label, ops, timer.elapsedMs());
+        }
+        {
+            bench_rbtree_t tree(_big);
+            BenchTimer timer;
+            for (bench_rbtree_t::iterator it = _small.begin(); it != _small.end(); ++it) {
+                tree.erase(it->first);
+            }
+            std::sprintf(label, "%s difference, one erase at a time", _name);
+            benchReport(label, ops, timer.elapsedMs());
+        }
+        {
+            bench_rbtree_t tree(_big);
+            BenchTimer timer;
+            tree.set_difference(_small);
+            std::sprintf(label, "%s set_difference", _name);
+            benchReport(label, ops, timer.elapsedMs());
+        }
+        {
+            bench_rbtree_t tree(_big);
+            BenchTimer timer;
+            tree.set_difference(_small, &_pool);
+            std::sprintf(label, "%s set_difference, %u threads", _name, _pool.concurrency());
+            benchReport(label, ops, timer.elapsedMs());
+        }
+    }
+
+    TEST(RedBlackTree_Benchmark, DISABLED_set_operations)
+    {
+        std::vector<int> bigKeys, smallKeys, sameSizeKeys;
+        benchRandomKeys(bigKeys, BENCH_LARGE_SIZE);
+        benchRandomKeys(smallKeys, BENCH_SMALL_SIZE, BENCH_SEED + 1);
+        benchRandomKeys(sameSizeKeys, BENCH_LARGE_SIZE, BENCH_SEED + 2);
+
+        bench_rbtree_t big, small, sameSize;
+        for (std::size_t i = 0; i < bigKeys.size(); ++i) {
+            big.insert(bigKeys[i], static_cast<bench_val_t>(i));
+            sameSize.insert(sameSizeKeys[i], static_cast<bench_val_t>(i));
+        }
+        for (std::size_t i = 0; i < smallKeys.size(); ++i) {
+            small.insert(smallKeys[i], static_cast<bench_val_t>(i));
+        }
+
+        ThreadPool pool;
+        benchHeader("RedBlackTree set operations, random keys, ns per element of the second tree");
+        benchSetOperations("large with small", big, small, pool);
+        benchSetOperations("large with large", big, sameSize, pool);
+    }
+
+    // --------------------------------------------------------------------------------------------------
+    void benchBulkBuild(const char* _name, const std::vector<GLARE_PAIR<int, bench_val_t> >& _values, bool _sorted, ThreadPool& _pool)
+    {
+        char label[128];
+        {
+            BenchTimer timer;
+            bench_rbtree_t tree;
+            for (std::size_t i = 0; i < _values.size(); ++i) {
+                tree.insert(_values[i]);
+            }
+            std::sprintf(label, "%s, one insert at a time", _name);
+            benchReport(label, _values.size(), timer.elapsedMs());
+        }
+        if (_sorted)
+        {
+            BenchTimer timer;
+            bench_rbtree_t tree(_values.begin(), _values.end(), sorted_tag());
+            std::sprintf(label, "%s, sorted_tag", _name);
+            benchReport(label, _values.size(), timer.elapsedMs());
+        }
+        {
+            BenchTimer timer;
+            bench_rbtree_t tree(_values.begin(), _values.end());
+            std::sprintf(label, "%s, sort and build", _name);
+            benchReport(label, _values.size(), timer.elapsedMs());
+        }
+        {
+            BenchTimer timer;
+            bench_rbtree_t tree(_values.begin(), _values.end(), &_pool);
+            std::sprintf(label, "%s, sort and build, %u threads", _name, _pool.concurrency());
+            benchReport(label, _values.size(), timer.elapsedMs());
+        }
+    }
+
+    TEST(RedBlackTree_Benchmark, DISABLED_bulk_construction)
+    {
+        std::vector<int> sequential, random;
+        benchSequentialKeys(sequential, BENCH_LARGE_SIZE);
+        benchRandomKeys(random, BENCH_LARGE_SIZE);
+
+        std::vector<GLARE_PAIR<int, bench_val_t> > sortedValues, randomValues;
+        for (std::size_t i = 0; i < sequential.size(); ++i) {
+            sortedValues.push_back(GLARE_PAIR<int, bench_val_t>(sequential[i], static_cast<bench_val_t>(i)));
+            randomValues.push_back(GLARE_PAIR<int, bench_val_t>(random[i], static_cast<bench_val_t>(i)));
+        }
+
+        ThreadPool pool;
+        benchHeader("RedBlackTree construction, large set");
+        benchBulkBuild("sorted keys", sortedValues, true, pool);
+        benchBulkBuild("random keys", randomValues, false, pool);
+    }
+
+    // --------------------------------------------------------------------------------------------------
+    void benchHintedInsert(const char* _name, const std::vector<int>& _keys)
+    {
+        char label[128];
+        {
+            BenchTimer timer;
+            bench_rbtree_t tree;
+            for (std::size_t i = 0; i < _keys.size(); ++i) {
+                tree.insert(_keys[i], static_cast<bench_val_t>(i));
+            }
+            std::sprintf(label, "%s, insert", _name);
+            benchReport(label, _keys.size(), timer.elapsedMs());
+        }
+        {
+            BenchTimer timer;
+            bench_rbtree_t tree;
+            for (std::size_t i = 0; i < _keys.size(); ++i) {
+                tree.insert(tree.end(), GLARE_PAIR<int, bench_val_t>(_keys[i], static_cast<bench_val_t>(i)));
+            }
+            std::sprintf(label, "%s, insert hinted end()", _name);
+            benchReport(label, _keys.size(), timer.elapsedMs());
+        }
+        {
+            BenchTimer timer;
+            bench_rbtree_t tree;
+            bench_rbtree_t::iterator hint = tree.end();
+            for (std::size_t i = 0; i < _keys.size(); ++i) {
+                hint = tree.insert(hint, GLARE_PAIR<int, bench_val_t>(_keys[i], static_cast<bench_val_t>(i)));
+            }
+            std::sprintf(label, "%s, insert hinted previous", _name);
+            benchReport(label, _keys.size(), timer.elapsedMs());
+        }
+    }
+
+    TEST(RedBlackTree_Benchmark, DISABLED_hinted_insert)
+    {
+        std::vector<int> ascending, nearlySorted, random;
+        benchSequentialKeys(ascending, BENCH_LARGE_SIZE);
+        benchRandomKeys(random, BENCH_LARGE_SIZE);
+
+        // Sorted, with one key in 16 out of place.
+        nearlySorted = ascending;
+        for (std::size_t i = 0; i < nearlySorted.size(); i += 16) {
+            nearlySorted[i] = random[i];
+        }
+
+        benchHeader("RedBlackTree hinted insert, large set");
+        benchHintedInsert("ascending", ascending);
+        benchHintedInsert("nearly sorted", nearlySorted);
+        benchHintedInsert("random", random);
+    }
+
+    // --------------------------------------------------------------------------------------------------
+    TEST(RedBlackTree_Benchmark, DISABLED_emplace)
+    {
+        typedef RedBlackTree<int, std::string> string_tree_t;
+        typedef GLARE_PAIR<int, std::string> string_pair_t;
+
+        // Every key twice, so half of the inserts find it already there.
+        std::vector<int> keys;
+        benchRandomKeys(keys, BENCH_SMALL_SIZE);
+        keys.insert(keys.end(), keys.begin(), keys.end());
+        const std::string heavy(200, 'x');
+
+        benchHeader("RedBlackTree insert with 200 byte string values, half the keys already there");
+        {
+            BenchTimer timer;
+            string_tree_t tree;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                const string_pair_t pair(keys[i], heavy);
+                tree.insert(pair);
+            }
+            benchReport("insert(const value_type&)", keys.size(), timer.elapsedMs());
+        }
+        {
+            BenchTimer timer;
+            string_tree_t tree;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                tree.insert(string_pair_t(keys[i], heavy));
+            }
+            benchReport("insert(value_type&&)", keys.size(), timer.elapsedMs());
+        }
+        {
+            BenchTimer timer;
+            string_tree_t tree;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                tree.insert(keys[i], heavy);
+            }
+            benchReport("insert(key, value)", keys.size(), timer.elapsedMs());
+        }
+        {
+            BenchTimer timer;
+            string_tree_t tree;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                tree.try_emplace(keys[i], heavy);
+            }
+            benchReport("try_emplace(key, value)", keys.size(), timer.elapsedMs());
+        }
+    }
+
+    // --------------------------------------------------------------------------------------------------
+    template<typename _Tree>
+    void benchNodeType(const char* _name, std::size_t _nodeSize, const std::vector<int>& _keys, const std::vector<int>& _lookups)
+    {
+        char label[128];
+        _Tree tree;
+
+        BenchTimer insertTimer;
+        for (std::size_t i = 0; i < _keys.size(); ++i) {
+            tree.insert(_keys[i], static_cast<bench_val_t>(i));
+        }
+        std::sprintf(label, "%s insert, %u bytes/node", _name, static_cast<unsigned int>(_nodeSize));
+        benchReport(label, _keys.size(), insertTimer.elapsedMs());
+
+        std::size_t found = 0;
+        BenchTimer findTimer;
+        for (std::size_t i = 0; i < _lookups.size(); ++i) {
+            found += tree.exists(_lookups[i]);
+        }
+        std::sprintf(label, "%s find", _name);
+        benchReport(label, _lookups.size(), findTimer.elapsedMs());
+        EXPECT_EQ(found, _lookups.size());
+        benchEscape(found);
+
+        std::size_t sum = 0;
+        BenchTimer iterateTimer;
+        for (typename _Tree::iterator it = tree.begin(); it != tree.end(); ++it) {
+            sum += it->second;
+        }
+        std::sprintf(label, "%s iterate", _name);
+        benchReport(label, _keys.size(), iterateTimer.elapsedMs());
+        benchEscape(sum);
+
+        BenchTimer eraseTimer;
+        for (std::size_t i = 0; i < _keys.size(); ++i) {
+            tree.erase(_keys[i]);
+        }
+        std::sprintf(label, "%s erase", _name);
+        benchReport(label, _keys.size(), eraseTimer.elapsedMs());
+    }
+
+    TEST(RedBlackTree_Benchmark, DISABLED_compact_nodes)
+    {
+        typedef RbTreeNode<int, bench_val_t>            pointer_node_t;
+        typedef RbTreeCompactNode<int, bench_val_t>     compact_node_t;
+        typedef RbTreeIndexNode<int, bench_val_t>       index_node_t;
+
+        std::vector<int> keys, lookups;
+        benchRandomKeys(keys, BENCH_LARGE_SIZE);
+        benchRandomKeys(lookups, BENCH_LARGE_SIZE, BENCH_SEED + 1);
+
+        benchHeader("RedBlackTree node layouts, random keys, large set");
+        benchNodeType<RedBlackTree<int, bench_val_t> >("RbTreeNode", sizeof(pointer_node_t), keys, lookups);
+        benchNodeType<RedBlackTree<int, bench_val_t, less<int>, default_allocator<bench_val_t>, compact_node_t> >("RbTreeCompactNode", sizeof(compact_node_t), keys, lookups);
+
+        IndexPool<index_node_t>::reserve(static_cast<std::uint32_t>(keys.size()));
+        benchNodeType<RedBlackTree<int, bench_val_t, less<int>, IndexPoolAllocator<bench_val_t>, index_node_t> >("RbTreeIndexNode", sizeof(index_node_t), keys, lookups);
+        IndexPool<index_node_t>::reserve(0);
+    }
+
+    // --------------------------------------------------------------------------------------------------
+    template<typename _Tree>
+    void benchAugmentUpkeep(const char* _name, const std::vector<int>& _keys)
+    {
+        char label[128];
+        _Tree tree;
+
+        BenchTimer insertTimer;
+        for (std::size_t i = 0; i < _keys.size(); ++i) {
+            tree.insert(_keys[i], static_cast<bench_val_t>(i));
+        }
+        std::sprintf(label, "%s insert", _name);
+        benchReport(label, _keys.size(), insertTimer.elapsedMs());
+
+        BenchTimer eraseTimer;
+        for (std::size_t i = 0; i < _keys.size(); ++i) {
+            tree.erase(_keys[i]);
+        }
+        std::sprintf(label, "%s erase", _name);
+        benchReport(label, _keys.size(), eraseTimer.elapsedMs());
+    }
+
+    TEST(RedBlackTree_Benchmark, DISABLED_augmented)
+    {
+        typedef RbTreeAugmentedNode<int, bench_val_t, rb_size_augment>                              ranked_node_t;
+        typedef RbTreeAugmentedNode<int, bench_val_t, rb_sum_augment<long long> >                   sum_node_t;
+        typedef RedBlackTree<int, bench_val_t, less<int>, default_allocator<bench_val_t>, ranked_node_t> ranked_tree_t;
+        typedef RedBlackTree<int, bench_val_t, less<int>, default_allocator<bench_val_t>, sum_node_t>    sum_tree_t;
+
+        std::vector<int> keys;
+        benchRandomKeys(keys, BENCH_LARGE_SIZE);
+
+        benchHeader("RedBlackTree upkeep of the augmented nodes, random keys, large set");
+        benchAugmentUpkeep<RedBlackTree<int, bench_val_t> >("plain", keys);
+        benchAugmentUpkeep<ranked_tree_t>("rank/select", keys);
+        benchAugmentUpkeep<sum_tree_t>("sum", keys);
+
+        std::vector<int> smallKeys;
+        benchRandomKeys(smallKeys, BENCH_SMALL_SIZE);
+        ranked_tree_t ranked;
+        sum_tree_t summed;
+        for (std::size_t i = 0; i < smallKeys.size(); ++i)
+        {
+            ranked.insert(smallKeys[i], 1);
+            summed.insert(smallKeys[i], 1);
+        }
+        const std::size_t Queries = 4096;
+
+        benchHeader("RedBlackTree queries on the augmented nodes vs walking the iterators, small set");
+        {
+            std::size_t found = 0;
+            BenchTimer timer;
+            for (std::size_t q = 0; q < Queries; ++q) {
+                found += rb_select(ranked, (q * 7919) % ranked.size())->second;
+            }
+            benchReport("rb_select", Queries, timer.elapsedMs());
+            benchEscape(found);
+        }
+        {
+            std::size_t found = 0;
+            BenchTimer timer;
+            for (std::size_t q = 0; q < Queries; ++q)
+            {
+                ranked_tree_t::iterator it = ranked.begin();
+                std::advance(it, (q * 7919) % ranked.size());
+                found += it->second;
+            }
+            benchReport("std::advance from begin()", Queries, timer.elapsedMs());
+            benchEscape(found);
+        }
+        {
+            long long sum = 0;
+            BenchTimer timer;
+            for (std::size_t q = 0; q < Queries; ++q) {
+                sum += rb_range_sum(summed, smallKeys[q], smallKeys[q] + (1 << 24));
+            }
+            benchReport("rb_range_sum", Queries, timer.elapsedMs());
+            benchEscape(sum);
+        }
+        {
+            long long sum = 0;
+            BenchTimer timer;
+            for (std::size_t q = 0; q < Queries; ++q)
+            {
+                for (sum_tree_t::iterator it = summed.find(smallKeys[q]); it != summed.end() && it->first < smallKeys[q] + (1 << 24); ++it)
+                    sum += it->second;
+            }
+            benchReport("range sum walking the iterators", Queries, timer.elapsedMs());
+            benchEscape(sum);
+        }
+    }
+
+    TEST(RedBlackTree_Benchmark, DISABLED_interval_overlap)
+    {
+        typedef GLARE_PAIR<int, int>                                                                interval_t;
+        typedef RbTreeAugmentedNode<interval_t, bench_val_t, rb_interval_augment<int> >            interval_node_t;
+        typedef RedBlackTree<interval_t, bench_val_t, less<interval_t>, default_allocator<bench_val_t>, interval_node_t> interval_tree_t;
+
+        std::vector<int> lows;
+        benchRandomKeys(lows, BENCH_SMALL_SIZE);
+        interval_tree_t tree;
+        std::vector<interval_t> intervals;
+        for (std::size_t i = 0; i < lows.size(); ++i)
+        {
+            const interval_t interval(lows[i], lows[i] + 256);
+            intervals.push_back(interval);
+            tree.insert(interval, 1);
+        }
+
+        const std::size_t Queries = 1024;
+        benchHeader("Interval overlap queries, small set");
+        std::size_t treeHits = 0, scanHits = 0;
+        {
+            BenchTimer timer;
+            for (std::size_t q = 0; q < Queries; ++q) {
+                rb_for_each_overlap(tree, lows[q], lows[q] + 1024, [&treeHits](const interval_tree_t::value_type&) { ++treeHits; });
+            }
+            benchReport("rb_for_each_overlap", Queries, timer.elapsedMs());
+        }
+        {
+            BenchTimer timer;
+            for (std::size_t q = 0; q < Queries; ++q)
+            {
+                for (std::size_t i = 0; i < intervals.size(); ++i)
+                    scanHits += !(lows[q] + 1024 < intervals[i].first || intervals[i].second < lows[q]);
+            }
+            benchReport("linear scan", Queries, timer.elapsedMs());
+        }
+        EXPECT_EQ(scanHits, treeHits);
+    }
+
+    TEST(RedBlackTree_Benchmark, DISABLED_persistent)
+    {
+        typedef RedBlackTree<int, bench_val_t>        tree_t;
+        typedef PersistentRbTree<int, bench_val_t>    persistent_tree_t;
+
+        std::vector<int> keys, updates;
+        benchRandomKeys(keys, BENCH_SMALL_SIZE);
+        benchRandomKeys(updates, 1024, BENCH_SEED + 1);
+        for (std::size_t i = 0; i < updates.size(); ++i) {
+            updates[i] += static_cast<int>(BENCH_SMALL_SIZE); // New keys.
+        }
+
+        tree_t tree;
+        persistent_tree_t persistent;
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            tree.insert(keys[i], 1);
+            persistent = persistent.insert(keys[i], 1);
+        }
+
+        // A writer publishing a snapshot after every update: readers keep the previous one as long as they need it.
+        benchHeader("Update and publish a snapshot, small set");
+        std::size_t sizes = 0;
+        {
+            tree_t published;
+            BenchTimer timer;
+            for (std::size_t i = 0; i < updates.size(); ++i)
+            {
+                tree.insert(updates[i], 2);
+                published = tree;
+                sizes += published.size();
+            }
+            benchReport("RedBlackTree insert and copy", updates.size(), timer.elapsedMs());
+        }
+        {
+            persistent_tree_t published;
+            BenchTimer timer;
+            for (std::size_t i = 0; i < updates.size(); ++i)
+            {
+                persistent = persistent.insert(updates[i], 2);
+                published = persistent;
+                sizes += published.size();
+            }
+            benchReport("PersistentRbTree insert", updates.size(), timer.elapsedMs());
+        }
+        benchEscape(sizes);
+
+        benchHeader("Lookups, small set");
+        std::size_t found = 0;
+        {
+            BenchTimer timer;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                found += tree.exists(keys[i]);
+            }
+            benchReport("RedBlackTree", keys.size(), timer.elapsedMs());
+        }
+        {
+            BenchTimer timer;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                found += persistent.exists(keys[i]);
+            }
+            benchReport("PersistentRbTree", keys.size(), timer.elapsedMs());
+        }
+        EXPECT_EQ(2 * keys.size(), found);
+    }
+
+    TEST(RedBlackTree_Benchmark, DISABLED_range_queries)
+    {
+        typedef RedBlackTree<int, bench_val_t> tree_t;
+
+        std::vector<int> keys, lows;
+        benchRandomKeys(keys, BENCH_SMALL_SIZE);
+        benchRandomKeys(lows, 1024, BENCH_SEED + 1);
+        tree_t tree;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            tree.insert(keys[i], 1);
+        }
+
+        // Windows of 64 keys anywhere in the set.
+        benchHeader("Range queries of 64 keys, small set");
+        std::size_t seekCount = 0, scanCount = 0;
+        {
+            BenchTimer timer;
+            for (std::size_t q = 0; q < lows.size(); ++q)
+            {
+                tree_t::range_view view = tree.range(lows[q] * 64, lows[q] * 64 + 64);
+                for (tree_t::iterator it = view.begin(); it != view.end(); ++it)
+                    seekCount += it->second;
+            }
+            benchReport("range()", lows.size(), timer.elapsedMs());
+        }
+        {
+            BenchTimer timer;
+            for (std::size_t q = 0; q < lows.size(); ++q)
+            {
+                for (tree_t::iterator it = tree.begin(); it != tree.end() && it->first < lows[q] * 64 + 64; ++it)
+                    scanCount += it->first >= lows[q] * 64 ? it->second : 0;
+            }
+            benchReport("scan from begin()", lows.size(), timer.elapsedMs());
+        }
+        EXPECT_EQ(scanCount, seekCount);
+    }
+
+    TEST(RedBlackTree_Benchmark, DISABLED_node_handle)
+    {
+        typedef RedBlackTree<int, bench_val_t> tree_t;
+
+        std::vector<int> keys;
+        benchRandomKeys(keys, BENCH_SMALL_SIZE);
+
+        // Rebalancing shards: every key moves from one tree to the other.
+        benchHeader("Moving every element to another tree, small set");
+        {
+            tree_t source, target;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                source.insert(keys[i], 1);
+            }
+            BenchTimer timer;
+            for (std::size_t i = 0; i < keys.size(); ++i)
+            {
+                bench_val_t value = 0;
+                source.find(keys[i], value);
+                source.erase(keys[i]);
+                target.insert(keys[i], value);
+            }
+            benchReport("erase and insert", keys.size(), timer.elapsedMs());
+            EXPECT_EQ(keys.size(), target.size());
+        }
+        {
+            tree_t source, target;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                source.insert(keys[i], 1);
+            }
+            BenchTimer timer;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                target.insert(source.extract(keys[i]));
+            }
+            benchReport("extract and insert", keys.size(), timer.elapsedMs());
+            EXPECT_EQ(keys.size(), target.size());
+        }
+        {
+            tree_t source, target;
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                source.insert(keys[i], 1);
+            }
+            BenchTimer timer;
+            target.merge(source);
+            benchReport("merge", keys.size(), timer.elapsedMs());
+            EXPECT_EQ(keys.size(), target.size());
+        }
+    }
+
+    typedef std::vector<bench_val_t, BenchAllocator<bench_val_t> >                                                         bench_bucket_t;
+    typedef RedBlackTree<int, bench_bucket_t, less<int>, BenchAllocator<bench_bucket_t> >                                   bench_bucket_tree_t;
+    typedef RedBlackTree<int, bench_val_t, less<int>, BenchAllocator<bench_val_t>, RbTreeNode<int, bench_val_t>, rb_multi_keys> bench_multi_tree_t;
+
+    // _keys / _perKey distinct keys, each with _perKey elements on average.
+    void benchSecondaryIndex(const char* _name, std::vector<int> _keys, int _perKey)
+    {
+        for (std::size_t i = 0; i < _keys.size(); ++i) {
+            _keys[i] /= _perKey;
+        }
+
+        char label[128];
+        std::size_t sum = 0;
+        {
+            const std::size_t bytesBefore = benchLiveBytes();
+            bench_bucket_tree_t tree;
+            BenchTimer insertTimer;
+            for (std::size_t i = 0; i < _keys.size(); ++i) {
+                tree.try_emplace(_keys[i]).first->second.push_back(static_cast<bench_val_t>(i));
+            }
+            std::sprintf(label, "%s tree of vectors insert, %.1f bytes/element", _name, static_cast<double>(benchLiveBytes() - bytesBefore) / _keys.size());
+            benchReport(label, _keys.size(), insertTimer.elapsedMs());
+
+            BenchTimer readTimer;
+            for (std::size_t i = 0; i < _keys.size(); ++i)
+            {
+                const bench_bucket_t& bucket = tree.find(_keys[i])->second;
+                for (std::size_t j = 0; j < bucket.size(); ++j)
+                    sum += bucket[j];
+            }
+            std::sprintf(label, "%s tree of vectors read all of a key", _name);
+            benchReport(label, _keys.size(), readTimer.elapsedMs());
+        }
+        {
+            const std::size_t bytesBefore = benchLiveBytes();
+            bench_multi_tree_t tree;
+            BenchTimer insertTimer;
+            for (std::size_t i = 0; i < _keys.size(); ++i) {
+                tree.insert(_keys[i], static_cast<bench_val_t>(i));
+            }
+            std::sprintf(label, "%s rb_multi_keys insert, %.1f bytes/element", _name, static_cast<double>(benchLiveBytes() - bytesBefore) / _keys.size());
+            benchReport(label, _keys.size(), insertTimer.elapsedMs());
+
+            BenchTimer readTimer;
+            for (std::size_t i = 0; i < _keys.size(); ++i)
+            {
+                GLARE_PAIR<bench_multi_tree_t::iterator, bench_multi_tree_t::iterator> range = tree.equal_range(_keys[i]);
+                for (bench_multi_tree_t::iterator it = range.first; it != range.second; ++it)
+                    sum -= it->second;
+            }
+            std::sprintf(label, "%s rb_multi_keys read all of a key", _name);
+            benchReport(label, _keys.size(), readTimer.elapsedMs());
+        }
+        EXPECT_EQ(0u, sum);
+    }
+
+    TEST(RedBlackTree_Benchmark, DISABLED_multi_keys)
+    {
+        std::vector<int> keys;
+        benchRandomKeys(keys, BENCH_SMALL_SIZE);
+
+        benchHeader("Secondary index, tree of vectors vs repeated keys, small set");
+        benchSecondaryIndex("2/key", keys, 2);
+        benchSecondaryIndex("8/key", keys, 8);
+    }
+
+    TEST(RedBlackTree_Benchmark, DISABLED_parallel_traversal)
+    {
+        typedef RedBlackTree<int, bench_val_t> tree_t;
+
+        std::vector<int> keys;
+        benchRandomKeys(keys, BENCH_LARGE_SIZE);
+        tree_t tree;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            tree.insert(keys[i], static_cast<bench_val_t>(i & 0xff));
+        }
+
+        ThreadPool pool;
+        char label[128];
+        std::sprintf(label, "Summing every value, random keys, large set, %u threads", pool.concurrency());
+        benchHeader(label);
+
+        long long iterated = 0;
+        {
+            BenchTimer timer;
+            for (tree_t::iterator it = tree.begin(); it != tree.end(); ++it) {
+                iterated += it->second;
+            }
+            benchReport("iterators", keys.size(), timer.elapsedMs());
+        }
+
+        struct Sum
+        {
+            long long operator()(long long _sum, const tree_t::value_type& _pair) const { return _sum + _pair.second; }
+            long long operator()(long long _left, long long _right) const { return _left + _right; }
+        };
+        ThreadPool* const Pools[] = { nullptr, &pool };
+        const char* const Names[] = { "parallel_reduce, no pool", "parallel_reduce" };
+        for (int p = 0; p < 2; ++p)
+        {
+            BenchTimer timer;
+            const long long reduced = parallel_reduce(tree, 0LL, Sum(), Sum(), Pools[p]);
+            benchReport(Names[p], keys.size(), timer.elapsedMs());
+            EXPECT_EQ(iterated, reduced);
+        }
+        {
+            std::vector<long long> partials;
+            BenchTimer timer;
+            parallel_for_each_ordered(tree, partials, [](tree_t::iterator _first, tree_t::iterator _last, long long& _sum)
+            {
+                for (_sum = 0; _first != _last; ++_first)
+                    _sum += _first->second;
+            }, &pool);
+            benchReport("parallel_for_each_ordered", keys.size(), timer.elapsedMs());
+
+            long long total = 0;
+            for (std::size_t i = 0; i < partials.size(); ++i) {
+                total += partials[i];
+            }
+            EXPECT_EQ(iterated, total);
+        }
+    }
+
+    struct bench_rbtree_arena_tag {};
+
+    TEST(RedBlackTree_Benchmark, DISABLED_copy_and_destroy)
+    {
+        typedef RedBlackTree<int, bench_val_t>                                                              tree_t;
+        typedef RedBlackTree<int, bench_val_t, less<int>, ArenaAllocator<bench_val_t, bench_rbtree_arena_tag> >   arena_tree_t;
+
+        std::vector<int> keys;
+        benchRandomKeys(keys, BENCH_LARGE_SIZE);
+        benchCopyAndDestroy<tree_t, arena_tree_t, bench_rbtree_arena_tag>("RedBlackTree", keys);
+    }
+
+    TEST(RedBlackTree_Benchmark, DISABLED_range_erase)
+    {
+        typedef RedBlackTree<int, bench_val_t> tree_t;
+
+        std::vector<int> keys;
+        benchRandomKeys(keys, BENCH_LARGE_SIZE);
+        benchRangeErase<tree_t>("RedBlackTree", keys, [](tree_t& _tree, int _key) { _tree.erase(_key); });
+    }
+
+    // --------------------------------------------------------------------------------------------------
+}   // namespace bench_rbtree
+}   // namespace glare_test
+}   // namespace glare
@@ -0,0 +1,79 @@
+#include "containers/StaticSearchTree.h"
+#include "containers/BTree.h"
+#include "containers/RbTree.h"
+#include "bench_containers.h"
+#include "gtest/gtest.h"
+
+
+namespace glare { namespace glare_test { namespace bench_static_search_tree
+{
+    // --------------------------------------------------------------------------------------------------
+    typedef int                                     bench_val_t;
+    typedef GLARE_PAIR<int, bench_val_t>            bench_pair_t;
+
+    void benchLookups(std::size_t _count)
+    {
+        std::vector<int> keys, lookups;
+        benchSequentialKeys(keys, _count);
+        benchRandomKeys(lookups, _count);
+
+        std::vector<bench_pair_t> pairs;
+        pairs.reserve(_count);
+        for (std::size_t i = 0; i < _count; ++i) {
+            pairs.push_back(bench_pair_t(keys[i], static_cast<bench_val_t>(i)));
+        }
+
+        StaticSearchTree<int, bench_val_t> staticTree(pairs.begin(), pairs.end());
+        BTree<int, bench_val_t, 6> btree6;
+        BTreeAuto<int, bench_val_t> btree256;
+        RedBlackTree<int, bench_val_t> rbtree;
+
+        for (std::size_t i = 0; i < _count; ++i)
+        {
+            btree6.insert(lookups[i], static_cast<bench_val_t>(i));
+            btree256.insert(lookups[i], static_cast<bench_val_t>(i));
+            rbtree.insert(lookups[i], static_cast<bench_val_t>(i));
+        }
+
+        std::size_t found = 0;
+        BenchTimer timer;
+        for (std::size_t i = 0; i < _count; ++i) {
+            found += staticTree.find(lookups[i]) != nullptr;
+        }
+        benchReport("StaticSearchTree::find", _count, timer.elapsedMs());
+
+        timer.reset();
+        for (std::size_t i = 0; i < _count; ++i) {
+            found += btree6.find(lookups[i]) != nullptr;
+        }
+        benchReport("BTree<order 6>::find", _count, timer.elapsedMs());
+
+        timer.reset();
+        for (std::size_t i = 0; i < _count; ++i) {
+            found += btree256.find(lookups[i]) != nullptr;
+        }
+        benchReport("BTreeAuto<256 bytes>::find", _count, timer.elapsedMs());
+
+        timer.reset();
+        for (std::size_t i = 0; i < _count; ++i) {
+            found += rbtree.find(lookups[i]) != rbtree.end();
+        }
+        benchReport("RedBlackTree::find", _count, timer.elapsedMs());
+
+        EXPECT_EQ(found, 4 * _count);
+        benchEscape(found);
+    }
+
+    TEST(StaticSearchTree_Benchmark, DISABLED_find)
+    {
+        benchHeader("Random lookups, small set");
+        benchLookups(BENCH_SMALL_SIZE);
+
+        benchHeader("Random lookups, large set");
+        benchLookups(BENCH_LARGE_SIZE);
+    }
+
+    // --------------------------------------------------------------------------------------------------
+}   // namespace bench_static_search_tree
+}   // namespace glare_test
+}   // namespace glare
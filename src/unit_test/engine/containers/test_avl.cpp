@@ -1,9 +1,13 @@
 #include "test_containers.h"
 #include "containers/AvlTree.h"
 #include "containers/GlareCoreUtility.h"
+#include "memory/ArenaAllocator.h"
+#include "gtest/gtest.h"
 
 #include <vector>
 #include <map>
+#include <cmath>
+#include <cstdio>
 
 namespace glare
 {
@@ -178,4 +182,427 @@ namespace glare
         TestObjectLogType::verbose(false);
         return  TestResult_Success;
     }
+
+    TEST(AvlTree_Test, test_stats)
+    {
+        AvlTree<int, int> tree;
+        TreeStats empty = tree.stats();
+        EXPECT_EQ(0u, empty.m_nodeCount);
+        EXPECT_EQ(0u, empty.m_height);
+
+        // Increasing keys, the worst case for an unbalanced tree.
+        const int Count = 1023;
+        for (int i = 0; i < Count; ++i)
+            tree.insert(i, i);
+
+        TreeStats stats = tree.stats();
+        EXPECT_EQ(static_cast<size_t>(Count), stats.m_size);
+        EXPECT_EQ(static_cast<size_t>(Count), stats.m_nodeCount);
+        EXPECT_EQ(stats.m_height, stats.m_depthHistogram.size());
+        EXPECT_LE(stats.m_height, 15u) << "An AVL tree is at most 1.44 lg(n) high";
+        EXPECT_EQ(1u, stats.m_depthHistogram[0]);
+        EXPECT_EQ(Count * sizeof(AvlTreeNode<int, int>), stats.m_bytes);
+        EXPECT_DOUBLE_EQ(1.0, stats.averageFill());
+
+        size_t nodes = 0, edges = 0;
+        for (size_t c = 0; c < stats.m_fillHistogram.size(); ++c)
+        {
+            nodes += stats.m_fillHistogram[c];
+            edges += c * stats.m_fillHistogram[c];
+        }
+        EXPECT_EQ(stats.m_nodeCount, nodes);
+        EXPECT_EQ(stats.m_nodeCount - 1, edges);
+    }
+
+    struct avl_arena_tag {};
+
+    TEST(AvlTree_Test, test_parallel_copy_and_reclaim)
+    {
+        ThreadPool pool(3), singleWorker(1);
+
+        for (int count = 0; count < 5000; count = count * 3 + 1)
+        {
+            AvlTree<int, int> source;
+            for (int i = 0; i < count; ++i)
+                source.insert((i * 7919) % count, i);
+
+            AvlTree<int, int> sequential(source, nullptr), parallel(source, &pool), single(source, &singleWorker);
+            AvlTree<int, int>* copies[] = { &sequential, &parallel, &single };
+            for (int c = 0; c < 3; ++c)
+            {
+                EXPECT_EQ(static_cast<size_t>(count), copies[c]->size());
+                EXPECT_EQ(source.stats().m_height, copies[c]->stats().m_height);
+                for (int i = 0; i < count; ++i)
+                {
+                    const int* value = copies[c]->find((i * 7919) % count);
+                    ASSERT_TRUE(value != nullptr);
+                    EXPECT_EQ(i, *value);
+                }
+            }
+        }
+
+        // The element counters are not atomic, nothing is built while the reclaimer runs.
+        TestInfoObject::state_type::state_object_type& state = TestInfoObject::getState().getStateInfo();
+        const size_t alive = state.m_constructor_count + state.m_copyConstructor_count - state.m_destructor_count;
+        Reclaimer reclaimer;
+        {
+            TestAvlTreeInfoType tree;
+            tree.setReclaimer(&reclaimer);
+            for (int i = 0; i < 1000; ++i)
+                tree.insert(i, TestInfoObject());
+
+            tree.clear();
+            EXPECT_EQ(0u, tree.size());
+            EXPECT_TRUE(tree.find(10) == nullptr);
+            reclaimer.drain();
+
+            tree.insert(1, TestInfoObject());
+        }
+        reclaimer.drain();
+        EXPECT_EQ(alive, state.m_constructor_count + state.m_copyConstructor_count - state.m_destructor_count) << "Fatal Error, possible memory leak";
+
+        // An arena takes its memory back in bulk, clear() gives nothing back and visits nothing.
+        {
+            AvlTree<int, int, less<int>, ArenaAllocator<int, avl_arena_tag> > tree;
+            for (int i = 0; i < 1000; ++i)
+                tree.insert(i, i);
+
+            const size_t used = Arena<avl_arena_tag>::used();
+            EXPECT_GE(used, 1000 * sizeof(AvlTreeNode<int, int>));
+            tree.clear();
+            EXPECT_EQ(used, Arena<avl_arena_tag>::used());
+            EXPECT_EQ(0u, tree.size());
+
+            tree.insert(7, 7);
+            EXPECT_TRUE(tree.find(7) != nullptr);
+        }
+        Arena<avl_arena_tag>::reset();
+        EXPECT_EQ(0u, Arena<avl_arena_tag>::reserved());
+    }
+
+    // Same keys, values and balance factors in the same pre-order, so the same shape.
+    void checkSameTree(AvlTree<int, int>& _tree, AvlTree<int, int>& _reference)
+    {
+        AvlTree<int, int>::serializable_list nodes, referenceNodes;
+        _tree.serializeList(nodes, true);
+        _reference.serializeList(referenceNodes, true);
+
+        ASSERT_EQ(referenceNodes.size(), nodes.size());
+        ASSERT_EQ(_reference.size(), _tree.size());
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            ASSERT_EQ(referenceNodes[i].m_pair.first, nodes[i].m_pair.first) << "node " << i;
+            ASSERT_EQ(referenceNodes[i].m_pair.second, nodes[i].m_pair.second) << "node " << i;
+            ASSERT_EQ(referenceNodes[i].m_balanceFactor, nodes[i].m_balanceFactor) << "node " << i;
+        }
+    }
+
+    TEST(AvlTree_Test, test_iterative_updates)
+    {
+        srand(46);
+        for (int range = 1; range < 5000; range = range * 3 + 1)
+        {
+            AvlTree<int, int> tree, reference;
+            std::map<int, int> expected;
+
+            // Inserts then removes taking over, every rotation case on the way up and down.
+            for (int round = 0; round < 4; ++round)
+            {
+                for (int i = 0; i < range; ++i)
+                {
+                    const int key = rand() % range;
+                    if (rand() % 4 < 3 - round)
+                    {
+                        const bool inserted = expected.insert(std::make_pair(key, i)).second;
+                        EXPECT_EQ(inserted, tree.insert(key, i));
+                        EXPECT_EQ(inserted, reference.insert_recursive(AvlTree<int, int>::pair_type(key, i)));
+                    }
+                    else
+                    {
+                        expected.erase(key);
+                        tree.remove(key);
+                        reference.remove_recursive(key);
+                    }
+                }
+                checkSameTree(tree, reference);
+
+                TreeStats stats = tree.stats();
+                EXPECT_EQ(expected.size(), stats.m_size);
+                EXPECT_LE(static_cast<double>(stats.m_height), 1.45 * std::log(static_cast<double>(expected.size() + 2)) / std::log(2.0));
+                for (std::map<int, int>::const_iterator itr = expected.begin(); itr != expected.end(); ++itr)
+                {
+                    const int* value = tree.find(itr->first);
+                    ASSERT_TRUE(value != nullptr);
+                    EXPECT_EQ(itr->second, *value);
+                }
+            }
+
+            for (int key = 0; key < range; ++key)
+                tree.remove(key);
+            EXPECT_EQ(0u, tree.size());
+            EXPECT_EQ(0u, tree.stats().m_nodeCount);
+        }
+    }
+
+    TEST(AvlTree_Test, test_snapshot)
+    {
+        typedef AvlTree<int, int> tree_t;
+        srand(47);
+        for (int count = 0; count < 5000; count = count * 3 + 1)
+        {
+            tree_t tree;
+            for (int i = 0; i < count; ++i)
+                tree.insert(rand() % (count * 2), i);
+            for (int i = 0; i < count / 3; ++i)
+                tree.remove(rand() % (count * 2));
+
+            std::vector<unsigned char> buffer(tree.snapshotSize());
+            tree.writeSnapshot(&buffer[0]);
+
+            // Same shape and balance factors, the same tree always gives the same bytes.
+            tree_t loaded;
+            loaded.insert(-1, -1);
+            ASSERT_TRUE(loaded.loadSnapshot(&buffer[0], buffer.size()));
+            checkSameTree(loaded, tree);
+
+            std::vector<unsigned char> again(loaded.snapshotSize());
+            loaded.writeSnapshot(&again[0]);
+            EXPECT_TRUE(buffer == again);
+
+            // Still a regular tree afterwards.
+            for (int i = 0; i < 10; ++i)
+            {
+                const int key = rand() % (count * 2 + 1);
+                tree.insert(key, i);
+                loaded.insert(key, i);
+                tree.remove(key + 1);
+                loaded.remove(key + 1);
+            }
+            checkSameTree(loaded, tree);
+        }
+
+        tree_t tree, loaded;
+        for (int i = 0; i < 100; ++i)
+            tree.insert(i, i * 2);
+        loaded.insert(7, 7);
+
+        std::vector<unsigned char> buffer(tree.snapshotSize());
+        tree.writeSnapshot(&buffer[0]);
+
+        // Not a snapshot of this tree, or cut short: the tree is left as it was.
+        std::vector<unsigned char> broken(buffer);
+        broken[0] ^= 1;
+        EXPECT_FALSE(loaded.loadSnapshot(&broken[0], broken.size()));
+        EXPECT_FALSE(loaded.loadSnapshot(&buffer[0], buffer.size() - 1));
+        AvlTree<int, double> otherValues;
+        EXPECT_FALSE(otherValues.loadSnapshot(&buffer[0], buffer.size()));
+
+        // A record promising a child that never comes.
+        broken = buffer;
+        tree_t::snapshot_record last;
+        memcpy(&last, &broken[broken.size() - sizeof(last)], sizeof(last));
+        last.m_flags |= tree_t::snapshot_record::HasLeft;
+        memcpy(&broken[broken.size() - sizeof(last)], &last, sizeof(last));
+        EXPECT_FALSE(loaded.loadSnapshot(&broken[0], broken.size()));
+
+        // A well formed shape with a wrong balance factor: the last record is a leaf, claimed left higher.
+        broken = buffer;
+        memcpy(&last, &broken[broken.size() - sizeof(last)], sizeof(last));
+        last.m_flags = static_cast<unsigned char>((last.m_flags & ~tree_t::snapshot_record::BalanceMask) | 2);
+        memcpy(&broken[broken.size() - sizeof(last)], &last, sizeof(last));
+        EXPECT_FALSE(loaded.loadSnapshot(&broken[0], broken.size()));
+
+        // A left chain deeper than any AVL tree, every node claiming equal heights. It would overrun the paths of insert().
+        const int chain = 200;
+        broken.assign(buffer.begin(), buffer.begin() + sizeof(tree_t::snapshot_header));
+        tree_t::snapshot_header header;
+        memcpy(&header, &broken[0], sizeof(header));
+        header.m_count = chain;
+        memcpy(&broken[0], &header, sizeof(header));
+        for (int i = 0; i < chain; ++i)
+        {
+            tree_t::snapshot_record record;
+            memset(&record, 0, sizeof(record));
+            record.m_key = chain - i;
+            record.m_value = i;
+            record.m_flags = static_cast<unsigned char>(1 | (i + 1 < chain ? tree_t::snapshot_record::HasLeft : 0));
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&record);
+            broken.insert(broken.end(), bytes, bytes + sizeof(record));
+        }
+        EXPECT_FALSE(loaded.loadSnapshot(&broken[0], broken.size()));
+
+        EXPECT_EQ(1u, loaded.size());
+        EXPECT_TRUE(loaded.find(7) != nullptr);
+
+        // Through a file, and an empty tree.
+        const char* path = "avl_snapshot_test.bin";
+        ASSERT_TRUE(tree.saveSnapshot(path));
+        ASSERT_TRUE(loaded.loadSnapshot(path));
+        checkSameTree(loaded, tree);
+
+        tree.clear();
+        ASSERT_TRUE(tree.saveSnapshot(path));
+        ASSERT_TRUE(loaded.loadSnapshot(path));
+        EXPECT_EQ(0u, loaded.size());
+        std::remove(path);
+        EXPECT_FALSE(loaded.loadSnapshot(path));
+    }
+
+    // The callback traversal writes here, it can't carry state.
+    std::vector<int> traversedKeys;
+    void collectKey(const int& _key, const int&) { traversedKeys.push_back(_key); }
+
+    TEST(AvlTree_Test, test_for_each)
+    {
+        typedef AvlTree<int, int> tree_t;
+        srand(48);
+
+        tree_t tree;
+        std::vector<int> visited;
+        EXPECT_TRUE(tree.for_each_inorder([&](const int& _key, const int&) { visited.push_back(_key); return true; }));
+        EXPECT_TRUE(tree.for_each_preorder([&](const int& _key, const int&) { visited.push_back(_key); return true; }));
+        EXPECT_TRUE(tree.for_each_postorder([&](const int& _key, const int&) { visited.push_back(_key); return true; }));
+        EXPECT_TRUE(visited.empty());
+
+        std::map<int, int> expected;
+        for (int i = 0; i < 3000; ++i)
+        {
+            const int key = rand() % 5000;
+            if (tree.insert(key, -key))
+                expected[key] = -key;
+        }
+
+        // Same order as the callback traversal.
+        for (int order = 0; order < 3; ++order)
+        {
+            visited.clear();
+            traversedKeys.clear();
+            long long sum = 0;
+            auto visit = [&](const int& _key, const int& _value) -> bool
+            {
+                EXPECT_EQ(-_key, _value);
+                visited.push_back(_key);
+                sum += _key;
+                return true;
+            };
+
+            if (order == 0) {
+                tree.setInOrderTraversal();
+                EXPECT_TRUE(tree.for_each_inorder(visit));
+            }
+            else if (order == 1) {
+                tree.setPreOrderTraversal();
+                EXPECT_TRUE(tree.for_each_preorder(visit));
+            }
+            else {
+                tree.setPostOrderTraversal();
+                EXPECT_TRUE(tree.for_each_postorder(visit));
+            }
+            tree.traverse(collectKey);
+
+            ASSERT_EQ(expected.size(), visited.size());
+            EXPECT_TRUE(visited == traversedKeys) << "order " << order;
+
+            long long expectedSum = 0;
+            for (std::map<int, int>::const_iterator itr = expected.begin(); itr != expected.end(); ++itr)
+                expectedSum += itr->first;
+            EXPECT_EQ(expectedSum, sum);
+        }
+
+        // In order is sorted.
+        std::vector<int> sorted;
+        tree.for_each_inorder([&](const int& _key, const int&) { sorted.push_back(_key); return true; });
+        std::map<int, int>::const_iterator itr = expected.begin();
+        for (size_t i = 0; i < sorted.size(); ++i, ++itr)
+            ASSERT_EQ(itr->first, sorted[i]);
+
+        // Early exit, the visitor isn't called again once it returned false.
+        const size_t stops[] = { 1, 2, expected.size() / 2, expected.size() };
+        for (size_t s = 0; s < sizeof(stops) / sizeof(stops[0]); ++s)
+        {
+            for (int order = 0; order < 3; ++order)
+            {
+                size_t calls = 0;
+                auto visit = [&](const int&, const int&) { return ++calls < stops[s]; };
+                const bool completed = order == 0 ? tree.for_each_inorder(visit)
+                                     : order == 1 ? tree.for_each_preorder(visit)
+                                     : tree.for_each_postorder(visit);
+                EXPECT_FALSE(completed);
+                EXPECT_EQ(stops[s], calls) << "order " << order;
+            }
+        }
+
+        // The first key of the in order walk past a bound.
+        int found = -1;
+        EXPECT_FALSE(tree.for_each_inorder([&](const int& _key, const int&) { found = _key; return _key <= 2500; }));
+        EXPECT_EQ(expected.upper_bound(2500)->first, found);
+    }
+
+
+    TEST(AvlTree_Test, test_morris_inorder)
+    {
+        typedef AvlTree<int, int> tree_t;
+        srand(49);
+
+        tree_t tree;
+        size_t calls = 0;
+        EXPECT_TRUE(tree.morris_for_each_inorder([&](const int&, const int&) { ++calls; return true; }));
+        EXPECT_FALSE(tree_t::morris_iterator(tree).valid());
+        EXPECT_EQ(0u, calls);
+
+        for (int i = 0; i < 3000; ++i)
+        {
+            const int key = rand() % 5000;
+            tree.insert(key, -key);
+        }
+        tree_t reference(tree);
+
+        std::vector<int> expected;
+        tree.for_each_inorder([&](const int& _key, const int&) { expected.push_back(_key); return true; });
+
+        std::vector<int> visited;
+        EXPECT_TRUE(tree.morris_for_each_inorder([&](const int& _key, const int& _value) { EXPECT_EQ(-_key, _value); visited.push_back(_key); return true; }));
+        EXPECT_TRUE(expected == visited);
+        checkSameTree(tree, reference);
+
+        visited.clear();
+        for (tree_t::morris_iterator itr(tree); itr.valid(); ++itr)
+        {
+            EXPECT_EQ(-itr.key(), itr.value());
+            visited.push_back(itr.key());
+        }
+        EXPECT_TRUE(expected == visited);
+        checkSameTree(tree, reference);
+
+        // Leaving early gives every thread back, whichever way it's left.
+        const size_t stops[] = { 1, 2, 3, 7, expected.size() / 3, expected.size() - 1 };
+        for (size_t s = 0; s < sizeof(stops) / sizeof(stops[0]); ++s)
+        {
+            calls = 0;
+            EXPECT_FALSE(tree.morris_for_each_inorder([&](const int&, const int&) { return ++calls < stops[s]; }));
+            EXPECT_EQ(stops[s], calls);
+            checkSameTree(tree, reference);
+
+            {
+                tree_t::morris_iterator itr(tree);
+                for (size_t k = 0; k < stops[s]; ++k, ++itr)
+                    ASSERT_EQ(expected[k], itr.key());
+                EXPECT_EQ(expected[stops[s]], itr.key());
+            }
+            checkSameTree(tree, reference);
+
+            tree_t::morris_iterator itr(tree);
+            for (size_t k = 0; k < stops[s]; ++k)
+                ++itr;
+            itr.stop();
+            EXPECT_FALSE(itr.valid());
+            checkSameTree(tree, reference);
+        }
+
+        // The values can change through the iterator.
+        for (tree_t::morris_iterator itr(tree); itr.valid(); ++itr)
+            itr.value() = itr.key();
+        EXPECT_TRUE(tree.for_each_inorder([](const int& _key, const int& _value) { return _key == _value; }));
+    }
+
 }
\ No newline at end of file
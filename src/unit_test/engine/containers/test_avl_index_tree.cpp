@@ -0,0 +1,239 @@
+#include "containers/AvlIndexTree.h"
+#include "containers/AvlTree.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <map>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace glare
+{
+    namespace
+    {
+        typedef AvlIndexTree<int, int>      index_tree_t;
+        typedef AvlIndexNode<int, int>      index_node_t;
+
+        struct ShapeEntry
+        {
+            int m_key;
+            int m_value;
+            bool operator == (const ShapeEntry& _other) const { return m_key == _other.m_key && m_value == _other.m_value; }
+        };
+
+        // Pre-order keys and values, equal for two trees of the same shape.
+        template<typename _Tree>
+        std::vector<ShapeEntry> preorderOf(const _Tree& _tree)
+        {
+            std::vector<ShapeEntry> entries;
+            _tree.for_each_preorder([&](const int& _key, const int& _value) { ShapeEntry e = { _key, _value }; entries.push_back(e); return true; });
+            return entries;
+        }
+    }
+
+    TEST(AvlIndexTree_Test, test_updates)
+    {
+        EXPECT_EQ(16u, sizeof(index_node_t));
+
+        srand(50);
+        for (int range = 1; range < 5000; range = range * 3 + 1)
+        {
+            index_tree_t tree;
+            AvlTree<int, int> reference;
+            std::map<int, int> expected;
+
+            for (int round = 0; round < 4; ++round)
+            {
+                for (int i = 0; i < range; ++i)
+                {
+                    const int key = rand() % range;
+                    if (rand() % 4 < 3 - round)
+                    {
+                        const bool inserted = expected.insert(std::make_pair(key, i)).second;
+                        EXPECT_EQ(inserted, tree.insert(key, i));
+                        reference.insert(key, i);
+                    }
+                    else
+                    {
+                        expected.erase(key);
+                        tree.remove(key);
+                        reference.remove(key);
+                    }
+                }
+
+                // Same rotations as AvlTree, so the same shape.
+                ASSERT_EQ(expected.size(), tree.size());
+                EXPECT_TRUE(preorderOf(tree) == preorderOf(reference));
+
+                TreeStats stats = tree.stats();
+                EXPECT_EQ(expected.size(), stats.m_nodeCount);
+                EXPECT_LE(static_cast<double>(stats.m_height), 1.45 * std::log(static_cast<double>(expected.size() + 2)) / std::log(2.0));
+                for (std::map<int, int>::const_iterator itr = expected.begin(); itr != expected.end(); ++itr)
+                {
+                    const int* value = tree.find(itr->first);
+                    ASSERT_TRUE(value != nullptr);
+                    EXPECT_EQ(itr->second, *value);
+                }
+                EXPECT_TRUE(tree.find(range) == nullptr);
+            }
+
+            // The freed slots are taken again before the array grows.
+            const size_t bytes = tree.stats().m_bytes;
+            const size_t count = tree.size();
+            for (int key = 0; key < range; ++key)
+                tree.remove(key);
+            EXPECT_EQ(0u, tree.size());
+            for (int key = 0; key < static_cast<int>(count); ++key)
+                tree.insert(key, key);
+            EXPECT_EQ(bytes, tree.stats().m_bytes);
+
+            int value = -1;
+            if (count > 0)
+            {
+                EXPECT_TRUE(tree.find(0, value));
+                EXPECT_EQ(0, value);
+            }
+            tree.clear();
+            EXPECT_TRUE(tree.empty());
+            EXPECT_FALSE(tree.find(0, value));
+        }
+    }
+
+    TEST(AvlIndexTree_Test, test_copy_and_walks)
+    {
+        srand(51);
+        index_tree_t tree;
+        std::map<int, int> expected;
+        for (int i = 0; i < 3000; ++i)
+        {
+            const int key = rand() % 5000;
+            if (tree.insert(key, -key))
+                expected[key] = -key;
+            if (i % 3 == 0)
+            {
+                tree.remove(key / 2);
+                expected.erase(key / 2);
+            }
+        }
+
+        std::vector<int> keys;
+        EXPECT_TRUE(tree.for_each_inorder([&](const int& _key, const int& _value) { EXPECT_EQ(-_key, _value); keys.push_back(_key); return true; }));
+        ASSERT_EQ(expected.size(), keys.size());
+        std::map<int, int>::const_iterator itr = expected.begin();
+        for (size_t i = 0; i < keys.size(); ++i, ++itr)
+            ASSERT_EQ(itr->first, keys[i]);
+
+        size_t calls = 0;
+        EXPECT_FALSE(tree.for_each_postorder([&](const int&, const int&) { return ++calls < 10; }));
+        EXPECT_EQ(10u, calls);
+
+        // The copy is the array, free slots and all, then the two go their own ways.
+        index_tree_t copy(tree);
+        EXPECT_TRUE(preorderOf(copy) == preorderOf(tree));
+        EXPECT_EQ(tree.stats().m_nodeCount, copy.stats().m_nodeCount);
+
+        copy.insert(-1, 1);
+        copy.remove(keys[0]);
+        EXPECT_TRUE(tree.find(-1) == nullptr);
+        EXPECT_TRUE(tree.find(keys[0]) != nullptr);
+
+        index_tree_t assigned;
+        assigned.insert(1, 1);
+        assigned = tree;
+        EXPECT_TRUE(preorderOf(assigned) == preorderOf(tree));
+    }
+
+    TEST(AvlIndexTree_Test, test_snapshot)
+    {
+        srand(52);
+        for (int count = 0; count < 5000; count = count * 3 + 1)
+        {
+            index_tree_t tree;
+            for (int i = 0; i < count; ++i)
+                tree.insert(rand() % (count * 2), i);
+            for (int i = 0; i < count / 3; ++i)
+                tree.remove(rand() % (count * 2)); // Leaves free slots in the array.
+
+            std::vector<unsigned char> buffer(tree.snapshotSize());
+            tree.writeSnapshot(&buffer[0]);
+
+            index_tree_t loaded;
+            loaded.insert(-1, -1);
+            ASSERT_TRUE(loaded.loadSnapshot(&buffer[0], buffer.size()));
+            EXPECT_EQ(tree.size(), loaded.size());
+            EXPECT_TRUE(preorderOf(loaded) == preorderOf(tree));
+
+            // Still a regular tree afterwards, the free slots included.
+            for (int i = 0; i < 10; ++i)
+            {
+                const int key = rand() % (count * 2 + 1);
+                tree.insert(key, i);
+                loaded.insert(key, i);
+                tree.remove(key + 1);
+                loaded.remove(key + 1);
+            }
+            EXPECT_TRUE(preorderOf(loaded) == preorderOf(tree));
+        }
+
+        index_tree_t tree, loaded;
+        for (int i = 0; i < 100; ++i)
+            tree.insert(i, i * 2);
+        for (int i = 0; i < 100; i += 7)
+            tree.remove(i);
+        loaded.insert(7, 7);
+
+        std::vector<unsigned char> buffer(tree.snapshotSize());
+        tree.writeSnapshot(&buffer[0]);
+
+        // Not a snapshot of this tree, or cut short: the tree is left as it was.
+        std::vector<unsigned char> broken(buffer);
+        broken[0] ^= 1;
+        EXPECT_FALSE(loaded.loadSnapshot(&broken[0], broken.size()));
+        EXPECT_FALSE(loaded.loadSnapshot(&buffer[0], buffer.size() - 1));
+        AvlIndexTree<int, double> otherValues;
+        EXPECT_FALSE(otherValues.loadSnapshot(&buffer[0], buffer.size()));
+
+        // Links that don't make a tree: past the array, back up to the root, into the free list, a bad balance factor and a node
+        // of its own.
+        index_tree_t::snapshot_header header;
+        std::memcpy(&header, &buffer[0], sizeof(header));
+        for (int corruption = 0; corruption < 7; ++corruption)
+        {
+            broken = buffer;
+            index_node_t* nodes = reinterpret_cast<index_node_t*>(&broken[sizeof(header)]);
+
+            index_node_t::index_type leaf = header.m_root;
+            while (nodes[leaf].left())
+                leaf = nodes[leaf].left();
+
+            switch (corruption)
+            {
+            case 0: nodes[leaf].setLeft(static_cast<index_node_t::index_type>(header.m_slots)); break;
+            case 1: nodes[leaf].setLeft(header.m_root); break;
+            case 2: nodes[leaf].setLeft(header.m_freeList); break;
+            case 3: nodes[leaf].m_rightBalance |= index_node_t::BalanceMask; break;
+            case 4: nodes[leaf].setLeft(leaf); break;
+            // Valid encodings, wrong balance factors.
+            case 5: nodes[leaf].setBalanceFactor(index_node_t::LeftHigher); break;
+            case 6: nodes[header.m_root].setBalanceFactor(nodes[header.m_root].balanceFactor() == index_node_t::EqualHeight ? index_node_t::RightHigher : index_node_t::EqualHeight); break;
+            }
+            EXPECT_FALSE(loaded.loadSnapshot(&broken[0], broken.size())) << "corruption " << corruption;
+        }
+        EXPECT_EQ(1u, loaded.size());
+        EXPECT_TRUE(loaded.find(7) != nullptr);
+
+        // Through a file, and an empty tree.
+        const char* path = "avl_index_snapshot_test.bin";
+        ASSERT_TRUE(tree.saveSnapshot(path));
+        ASSERT_TRUE(loaded.loadSnapshot(path));
+        EXPECT_TRUE(preorderOf(loaded) == preorderOf(tree));
+
+        tree.clear();
+        ASSERT_TRUE(tree.saveSnapshot(path));
+        ASSERT_TRUE(loaded.loadSnapshot(path));
+        EXPECT_EQ(0u, loaded.size());
+        std::remove(path);
+        EXPECT_FALSE(loaded.loadSnapshot(path));
+    }
+}
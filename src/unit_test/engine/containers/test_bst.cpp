@@ -0,0 +1,141 @@
+#include "containers/BinarySearchTree.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <set>
+
+namespace glare
+{
+    namespace
+    {
+        typedef CBinarySearchTree<int> bst_t;
+
+        std::vector<int> traversedValues;
+        void collectValue(const int& _value) { traversedValues.push_back(_value); }
+    }
+
+    TEST(BinarySearchTree_Test, test_for_each)
+    {
+        srand(48);
+
+        bst_t tree;
+        std::vector<int> visited;
+        EXPECT_TRUE(tree.for_each_inorder([&](const int& _value) { visited.push_back(_value); return true; }));
+        EXPECT_TRUE(tree.for_each_preorder([&](const int& _value) { visited.push_back(_value); return true; }));
+        EXPECT_TRUE(tree.for_each_postorder([&](const int& _value) { visited.push_back(_value); return true; }));
+        EXPECT_TRUE(visited.empty());
+
+        std::set<int> expected;
+        for (int i = 0; i < 2000; ++i)
+        {
+            const int value = rand() % 3000;
+            tree.insert(value);
+            expected.insert(value);
+        }
+        ASSERT_EQ(expected.size(), tree.size());
+
+        // Same order as the callback traversal.
+        for (int order = 0; order < 3; ++order)
+        {
+            visited.clear();
+            traversedValues.clear();
+            auto visit = [&](const int& _value) { visited.push_back(_value); return true; };
+
+            if (order == 0) {
+                tree.setInOrderTraversal();
+                EXPECT_TRUE(tree.for_each_inorder(visit));
+            }
+            else if (order == 1) {
+                tree.setPreOrderTraversal();
+                EXPECT_TRUE(tree.for_each_preorder(visit));
+            }
+            else {
+                tree.setPostOrderTraversal();
+                EXPECT_TRUE(tree.for_each_postorder(visit));
+            }
+            tree.traverse(collectValue);
+
+            ASSERT_EQ(expected.size(), visited.size());
+            EXPECT_TRUE(visited == traversedValues) << "order " << order;
+            if (order == 0)
+                EXPECT_TRUE(std::vector<int>(expected.begin(), expected.end()) == visited) << "In order is sorted";
+        }
+
+        // Early exit, the visitor isn't called again once it returned false.
+        const size_t stops[] = { 1, 2, expected.size() / 2, expected.size() };
+        for (size_t s = 0; s < sizeof(stops) / sizeof(stops[0]); ++s)
+        {
+            for (int order = 0; order < 3; ++order)
+            {
+                size_t calls = 0;
+                auto visit = [&](const int&) { return ++calls < stops[s]; };
+                const bool completed = order == 0 ? tree.for_each_inorder(visit)
+                                     : order == 1 ? tree.for_each_preorder(visit)
+                                     : tree.for_each_postorder(visit);
+                EXPECT_FALSE(completed);
+                EXPECT_EQ(stops[s], calls) << "order " << order;
+            }
+        }
+
+        for (std::set<int>::const_iterator itr = expected.begin(); itr != expected.end(); ++itr)
+            tree.remove(*itr);
+        EXPECT_EQ(0u, tree.size());
+    }
+
+    TEST(BinarySearchTree_Test, test_morris_inorder)
+    {
+        srand(49);
+
+        bst_t tree;
+        EXPECT_TRUE(tree.morris_for_each_inorder([](const int&) { return false; }));
+        EXPECT_FALSE(bst_t::morris_iterator(tree).valid());
+
+        std::set<int> expected;
+        for (int i = 0; i < 2000; ++i)
+        {
+            const int value = rand() % 3000;
+            tree.insert(value);
+            expected.insert(value);
+        }
+        std::vector<int> preorder;
+        tree.for_each_preorder([&](const int& _value) { preorder.push_back(_value); return true; });
+
+        std::vector<int> visited;
+        EXPECT_TRUE(tree.morris_for_each_inorder([&](const int& _value) { visited.push_back(_value); return true; }));
+        EXPECT_TRUE(std::vector<int>(expected.begin(), expected.end()) == visited);
+
+        visited.clear();
+        for (bst_t::morris_iterator itr(tree); itr.valid(); ++itr)
+            visited.push_back(*itr);
+        EXPECT_TRUE(std::vector<int>(expected.begin(), expected.end()) == visited);
+
+        // Leaving early gives every thread back: same shape, so the same pre-order.
+        for (size_t stop = 1; stop < expected.size(); stop = stop * 5 + 1)
+        {
+            size_t calls = 0;
+            EXPECT_FALSE(tree.morris_for_each_inorder([&](const int&) { return ++calls < stop; }));
+            EXPECT_EQ(stop, calls);
+            {
+                bst_t::morris_iterator itr(tree);
+                for (size_t k = 0; k < stop; ++k)
+                    ++itr;
+                ASSERT_TRUE(itr.valid());
+            }
+
+            std::vector<int> after;
+            tree.for_each_preorder([&](const int& _value) { after.push_back(_value); return true; });
+            EXPECT_TRUE(preorder == after) << "stopped after " << stop;
+        }
+
+        // Increasing values make a list down the right links, deeper than the recursion could go on a small stack.
+        bst_t degenerate;
+        const int Count = 20000;
+        for (int i = 0; i < Count; ++i)
+            degenerate.insert(i);
+
+        int next = 0;
+        EXPECT_TRUE(degenerate.morris_for_each_inorder([&](const int& _value) { return _value == next++; }));
+        EXPECT_EQ(Count, next);
+    }
+
+}
@@ -1,6 +1,8 @@
 #include "test_containers.h"
 #include "containers/BTree.h"
+#include "memory/ArenaAllocator.h"
 #include <string>
+#include <map>
 #include "gtest/gtest.h"
 
 
@@ -362,6 +364,495 @@ namespace glare { namespace glare_test { namespace test_btree
         EXPECT_TRUE((refState.m_constructor_count + refState.m_copyConstructor_count) == refState.m_destructor_count) << "Fatal Error, possible memory leak";
     }
 
+    TEST(Btree_Test, test_4_auto_order)
+    {
+        typedef BTreeAuto<test_key_t, test_val_t, BTREE_NODE_BYTES_256, test_allocator_t>           auto_btree_256_t;
+        typedef BTreeAuto<test_key_t, test_val_t, BTREE_NODE_BYTES_PAGE, test_allocator_t>          auto_btree_page_t;
+        typedef BTreeAuto<test_key_t, test_val_t, BTREE_NODE_BYTES_CACHE_LINE, test_allocator_t>    auto_btree_line_t;
+
+        // The order is the largest one that fits the budget.
+        EXPECT_LE(auto_btree_256_t::NODE_BYTES, BTREE_NODE_BYTES_256);
+        EXPECT_GT((sizeof(BTreeNode<test_key_t, test_val_t, auto_btree_256_t::ORDER + 1, test_allocator_t>)), BTREE_NODE_BYTES_256);
+        EXPECT_LE(auto_btree_page_t::NODE_BYTES, BTREE_NODE_BYTES_PAGE);
+        EXPECT_GT((sizeof(BTreeNode<test_key_t, test_val_t, auto_btree_page_t::ORDER + 1, test_allocator_t>)), BTREE_NODE_BYTES_PAGE);
+        EXPECT_GT(auto_btree_page_t::ORDER, auto_btree_256_t::ORDER);
+
+        // Bigger keys, fewer of them per node.
+        EXPECT_LT((BTreeAutoOrder<std::string, test_val_t, BTREE_NODE_BYTES_256>::value), auto_btree_256_t::ORDER);
+
+        // A cache line can't hold a usable node, we fall back to the smallest order.
+        EXPECT_EQ(auto_btree_line_t::ORDER, BTREE_MIN_ORDER);
+
+        TestObjectType::resetState();
+        {
+            auto_btree_256_t btree;
+            test_val_t value;
+            const test_key_t Size = 2000;
+
+            for (test_key_t i = 0; i < Size; ++i)
+                EXPECT_TRUE(btree.insert((i * 7919) % Size, value));
+
+            for (test_key_t i = 0; i < Size; ++i)
+                EXPECT_NE(btree.find(i), nullptr);
+
+            for (test_key_t i = 0; i < Size; i += 2)
+                btree.remove(i);
+
+            for (test_key_t i = 0; i < Size; ++i)
+                EXPECT_EQ(btree.find(i) == nullptr, i % 2 == 0);
+
+            auto_btree_256_t btreecopy(btree);
+            EXPECT_NE(btreecopy.find(1), nullptr);
+            EXPECT_EQ(btreecopy.find(2), nullptr);
+        }
+        EXPECT_TRUE((refState.m_constructor_count + refState.m_copyConstructor_count) == refState.m_destructor_count) << "Fatal Error, possible memory leak";
+    }
+
+    TEST(Btree_Test, test_5_append)
+    {
+        TestObjectType::resetState();
+        {
+            test_btree_t btree;
+            test_val_t value;
+            const test_key_t Size = 1000;
+
+            // Appends, the right edge is split asymmetrically.
+            for (test_key_t i = 0; i < Size; ++i)
+                EXPECT_TRUE(btree.insert(i * 2, value));
+
+            EXPECT_FALSE(btree.insert(Size * 2 - 2, value)); // Duplicate of the largest key is not an append.
+
+            // Fill the gaps through the regular path, this splits nodes all over the tree, the right edge included.
+            for (test_key_t i = 0; i < Size; ++i)
+                EXPECT_TRUE(btree.insert(i * 2 + 1, value));
+
+            // And append again on top of that.
+            for (test_key_t i = Size * 2; i < Size * 3; ++i)
+                EXPECT_TRUE(btree.insert(i, value));
+
+            for (test_key_t i = 0; i < Size * 3; ++i)
+                EXPECT_NE(btree.find(i), nullptr);
+
+            // Remove from the right edge first, it holds the nodes with fewer than MINKEYS keys.
+            for (test_key_t i = Size * 3 - 1; i >= Size * 2; i -= 3)
+                btree.remove(i);
+
+            for (test_key_t i = Size * 2; i < Size * 3; ++i)
+                EXPECT_EQ(btree.find(i) == nullptr, (Size * 3 - 1 - i) % 3 == 0);
+
+            // Appends after removals.
+            for (test_key_t i = Size * 3; i < Size * 4; ++i)
+                EXPECT_TRUE(btree.insert(i, value));
+
+            for (test_key_t i = 0; i < Size * 4; ++i)
+                btree.remove(i);
+
+            for (test_key_t i = 0; i < Size * 4; ++i)
+                EXPECT_EQ(btree.find(i), nullptr);
+
+            EXPECT_TRUE(btree.insert(7, value));
+            EXPECT_NE(btree.find(7), nullptr);
+        }
+        EXPECT_TRUE((refState.m_constructor_count + refState.m_copyConstructor_count) == refState.m_destructor_count) << "Fatal Error, possible memory leak";
+    }
+
+    TEST(Btree_Test, test_6_prefetch)
+    {
+        BTree<int, int, G_ORDER> btree;
+        EXPECT_EQ(0u, btree.prefetchDistance()) << "Prefetching is opt-in";
+
+        btree.setPrefetchDistance(2);
+        for (int i = 0; i < 1000; ++i)
+            EXPECT_TRUE(btree.insert((i * 7919) % 1000, i));
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            int value = -1;
+            EXPECT_TRUE(btree.find((i * 7919) % 1000, value));
+            EXPECT_EQ(i, value);
+        }
+        EXPECT_EQ(nullptr, btree.find(1000));
+
+        BTree<int, int, G_ORDER> copy(btree);
+        EXPECT_EQ(2u, copy.prefetchDistance());
+    }
+
+    TEST(Btree_Test, test_7_stats)
+    {
+        typedef BTree<int, int, G_ORDER> btree_type;
+        const btree_order_t MaxKeys = G_ORDER - 1;
+
+        btree_type btree;
+        TreeStats stats = btree.stats();
+        EXPECT_EQ(0u, stats.m_nodeCount);
+        EXPECT_EQ(0u, btree.height());
+        EXPECT_TRUE(btree.empty());
+
+        // Appends pack the nodes to GLARE_BTREE_APPEND_FILL_PERCENT, rounded down to whole keys.
+        const int Count = 5000;
+        for (int i = 0; i < Count; ++i)
+            EXPECT_TRUE(btree.insert(i, i));
+
+        stats = btree.stats();
+        EXPECT_EQ(static_cast<size_t>(Count), btree.size());
+        EXPECT_EQ(btree.size(), stats.m_size);
+        EXPECT_EQ(btree.height(), stats.m_height);
+        EXPECT_EQ(static_cast<size_t>(MaxKeys), stats.m_maxKeysPerNode);
+        EXPECT_EQ(static_cast<size_t>(MaxKeys + 1), stats.m_fillHistogram.size());
+        EXPECT_EQ(0u, stats.m_fillHistogram[0]);
+        EXPECT_GT(stats.averageFill(), 0.75);
+
+        size_t keys = 0, nodes = 0;
+        for (size_t k = 0; k < stats.m_fillHistogram.size(); ++k)
+        {
+            keys += k * stats.m_fillHistogram[k];
+            nodes += stats.m_fillHistogram[k];
+        }
+        EXPECT_EQ(stats.m_size, keys);
+        EXPECT_EQ(stats.m_nodeCount, nodes);
+        EXPECT_EQ(stats.m_height, stats.m_depthHistogram.size());
+        EXPECT_EQ(1u, stats.m_depthHistogram[0]);
+        EXPECT_GT(stats.m_bytes, stats.m_nodeCount * sizeof(int) * MaxKeys);
+
+        btree_type copy(btree);
+        EXPECT_EQ(btree.size(), copy.size());
+        EXPECT_EQ(btree.height(), copy.height());
+
+        // Removing everything collapses the root level by level.
+        for (int i = 0; i < Count; ++i)
+        {
+            btree.remove((i * 7919) % Count);
+            if (i % 1000 == 0)
+                EXPECT_EQ(btree.height(), btree.stats().m_height);
+        }
+        btree.remove(0);
+        EXPECT_TRUE(btree.empty());
+        EXPECT_EQ(0u, btree.height());
+
+        copy.clear();
+        EXPECT_EQ(0u, copy.size());
+        EXPECT_EQ(0u, copy.stats().m_nodeCount);
+    }
+
+    template<typename _Tree>
+    void checkBatchAgainstMap(unsigned _seed, int _keyRange, int _batchSize, int _batches)
+    {
+        typedef typename _Tree::batch_op_type   op_type;
+        typedef typename _Tree::batch_type      batch_type;
+
+        _Tree btree, reference;
+        std::map<int, int> expected;
+        unsigned state = _seed;
+
+        for (int b = 0; b < _batches; ++b)
+        {
+            batch_type ops;
+            for (int i = 0; i < _batchSize; ++i)
+            {
+                state = state * 1103515245u + 12345u;
+                const int key = static_cast<int>((state >> 8) % _keyRange);
+                const int value = b * _batchSize + i;
+                switch ((state >> 4) % 3)
+                {
+                case 0: ops.push_back(op_type(_Tree::BatchOp_Insert, key, value)); break;
+                case 1: ops.push_back(op_type(_Tree::BatchOp_Update, key, value)); break;
+                case 2: ops.push_back(op_type(_Tree::BatchOp_Remove, key)); break;
+                }
+            }
+
+            // One at a time, in the order given, on the reference tree and the map.
+            size_t changedExpected = 0;
+            for (size_t i = 0; i < ops.size(); ++i)
+            {
+                const op_type& op = ops[i];
+                if (op.m_op == _Tree::BatchOp_Remove)
+                {
+                    changedExpected += expected.erase(op.m_key);
+                    reference.remove(op.m_key);
+                }
+                else if (op.m_op == _Tree::BatchOp_Insert || expected.find(op.m_key) == expected.end())
+                {
+                    changedExpected += expected.insert(std::make_pair(op.m_key, op.m_value)).second ? 1 : 0;
+                    reference.insert(op.m_key, op.m_value);
+                }
+                else
+                {
+                    expected[op.m_key] = op.m_value;
+                    *reference.find(op.m_key) = op.m_value;
+                    ++changedExpected;
+                }
+            }
+
+            ASSERT_EQ(changedExpected, btree.apply_batch(ops)) << "batch " << b;
+            ASSERT_EQ(expected.size(), btree.size());
+            ASSERT_EQ(btree.size(), btree.stats().m_size);
+
+            for (int k = 0; k < _keyRange; ++k)
+            {
+                const int* value = btree.find(k);
+                std::map<int, int>::const_iterator itr = expected.find(k);
+                if (itr == expected.end()) {
+                    ASSERT_EQ(nullptr, value) << "key " << k;
+                }
+                else
+                {
+                    ASSERT_NE(nullptr, value) << "key " << k;
+                    ASSERT_EQ(itr->second, *value) << "key " << k;
+                }
+            }
+            EXPECT_EQ(btree.stats().m_height, btree.height());
+            EXPECT_EQ(reference.size(), btree.size());
+        }
+    }
+
+    TEST(Btree_Test, test_8_apply_batch)
+    {
+        // Empty batch, batch on an empty tree, removes only.
+        BTree<int, int, G_ORDER> btree;
+        BTree<int, int, G_ORDER>::batch_type ops;
+        EXPECT_EQ(0u, btree.apply_batch(ops));
+
+        ops.push_back(BTree<int, int, G_ORDER>::batch_op_type(BTree<int, int, G_ORDER>::BatchOp_Remove, 3));
+        EXPECT_EQ(0u, btree.apply_batch(ops));
+        EXPECT_TRUE(btree.empty());
+
+        // Same key several times, the given order wins.
+        ops.clear();
+        ops.push_back(BTree<int, int, G_ORDER>::batch_op_type(BTree<int, int, G_ORDER>::BatchOp_Insert, 5, 1));
+        ops.push_back(BTree<int, int, G_ORDER>::batch_op_type(BTree<int, int, G_ORDER>::BatchOp_Insert, 2, 1));
+        ops.push_back(BTree<int, int, G_ORDER>::batch_op_type(BTree<int, int, G_ORDER>::BatchOp_Update, 5, 2));
+        ops.push_back(BTree<int, int, G_ORDER>::batch_op_type(BTree<int, int, G_ORDER>::BatchOp_Remove, 2));
+        ops.push_back(BTree<int, int, G_ORDER>::batch_op_type(BTree<int, int, G_ORDER>::BatchOp_Insert, 5, 3));
+        EXPECT_EQ(4u, btree.apply_batch(ops));
+        EXPECT_EQ(1u, btree.size());
+        ASSERT_NE(nullptr, btree.find(5));
+        EXPECT_EQ(2, *btree.find(5));
+
+        // Dense and sparse batches, small and wide nodes.
+        checkBatchAgainstMap<BTree<int, int, G_ORDER> >(1, 200, 64, 50);
+        checkBatchAgainstMap<BTree<int, int, G_ORDER> >(2, 5000, 1000, 20);
+        checkBatchAgainstMap<BTree<int, int, 7> >(3, 3000, 2000, 20);
+        checkBatchAgainstMap<BTreeAuto<int, int> >(4, 20000, 4000, 10);
+    }
+
+    TEST(Btree_Test, test_9_apply_batch_memory_leaks)
+    {
+        {
+            test_btree_t btree;
+            test_btree_t::batch_type ops;
+            for (test_key_t i = 0; i < 500; ++i)
+                ops.push_back(test_btree_t::batch_op_type(test_btree_t::BatchOp_Insert, (i * 37) % 500, TestObjectType()));
+            EXPECT_EQ(500u, btree.apply_batch(ops));
+
+            ops.clear();
+            for (test_key_t i = 0; i < 500; i += 2)
+            {
+                ops.push_back(test_btree_t::batch_op_type(test_btree_t::BatchOp_Remove, i));
+                ops.push_back(test_btree_t::batch_op_type(test_btree_t::BatchOp_Update, i + 1, TestObjectType()));
+            }
+            EXPECT_EQ(500u, btree.apply_batch(ops));
+            EXPECT_EQ(250u, btree.size());
+        }
+        EXPECT_TRUE((refState.m_constructor_count + refState.m_copyConstructor_count) == refState.m_destructor_count) << "Fatal Error, possible memory leak";
+    }
+
+    template<typename _Tree>
+    void checkParallelCopy(ThreadPool& _pool, int _count)
+    {
+        _Tree source;
+        for (int i = 0; i < _count; ++i)
+            source.insert((i * 7919) % _count, i);
+
+        _Tree sequential(source, nullptr), parallel(source, &_pool);
+        const _Tree* copies[] = { &sequential, &parallel };
+        for (int c = 0; c < 2; ++c)
+        {
+            TreeStats stats = copies[c]->stats(); // Checks the size and the height.
+            EXPECT_EQ(static_cast<size_t>(_count), stats.m_size);
+            EXPECT_EQ(source.stats().m_nodeCount, stats.m_nodeCount);
+            for (int i = 0; i < _count; ++i)
+            {
+                const int* value = copies[c]->find((i * 7919) % _count);
+                ASSERT_TRUE(value != nullptr);
+                EXPECT_EQ(i, *value);
+            }
+        }
+    }
+
+    struct btree_arena_tag {};
+
+    TEST(Btree_Test, test_10_parallel_copy_and_reclaim)
+    {
+        ThreadPool pool(3), singleWorker(1);
+        for (int count = 0; count < 20000; count = count * 3 + 1)
+        {
+            checkParallelCopy<BTree<int, int, G_ORDER> >(pool, count);
+            checkParallelCopy<BTree<int, int, 64> >(pool, count);
+            checkParallelCopy<BTree<int, int, G_ORDER> >(singleWorker, count);
+            checkParallelCopy<BTreeAuto<int, int> >(pool, count);
+        }
+
+        // The element counters are not atomic, nothing is built while the reclaimer runs.
+        Reclaimer reclaimer;
+        {
+            test_btree_t btree;
+            btree.setReclaimer(&reclaimer);
+            test_val_t value;
+            for (test_key_t i = 0; i < 1000; ++i)
+                btree.insert(i, value);
+
+            btree.clear();
+            EXPECT_EQ(0u, btree.size());
+            EXPECT_EQ(0u, btree.height());
+            reclaimer.drain();
+
+            EXPECT_TRUE(btree.insert(1, value));
+        }
+        reclaimer.drain();
+        EXPECT_TRUE((refState.m_constructor_count + refState.m_copyConstructor_count) == refState.m_destructor_count) << "Fatal Error, possible memory leak";
+
+        // An arena takes its memory back in bulk, clear() gives nothing back and visits nothing.
+        {
+            BTree<int, int, G_ORDER, ArenaAllocator<int, btree_arena_tag> > btree;
+            for (int i = 0; i < 1000; ++i)
+                btree.insert(i, i);
+
+            const size_t used = Arena<btree_arena_tag>::used();
+            btree.clear();
+            EXPECT_EQ(used, Arena<btree_arena_tag>::used());
+            EXPECT_EQ(0u, btree.size());
+
+            btree.insert(7, 7);
+            EXPECT_TRUE(btree.find(7) != nullptr);
+            EXPECT_EQ(1u, btree.stats().m_size);
+        }
+        Arena<btree_arena_tag>::reset();
+        EXPECT_EQ(0u, Arena<btree_arena_tag>::reserved());
+    }
+
+    template<typename _Tree>
+    void checkRangeErase(unsigned int _seed, int _count)
+    {
+        srand(_seed);
+        _Tree btree;
+        std::map<int, int> expected;
+        for (int i = 0; i < _count; ++i)
+        {
+            const int key = rand() % (_count * 2 + 1);
+            if (btree.insert(key, i))
+                expected.insert(std::make_pair(key, i));
+        }
+
+        // Empty, reversed, outside and overlapping ranges, down to an empty tree.
+        for (int round = 0; round < 30 && !expected.empty(); ++round)
+        {
+            const int low = rand() % (_count * 2 + 3) - 1;
+            const int high = round % 5 == 0 ? low - round % 3 : low + rand() % (_count / 4 + 2);
+            const size_t before = expected.size();
+            if (high > low)
+                expected.erase(expected.lower_bound(low), expected.lower_bound(high));
+
+            ASSERT_EQ(before - expected.size(), btree.erase(low, high)) << "[" << low << ", " << high << ")";
+            ASSERT_TRUE(btree.verify()) << "[" << low << ", " << high << ")";
+            EXPECT_EQ(btree.stats().m_height, btree.height());
+
+            for (std::map<int, int>::const_iterator itr = expected.begin(); itr != expected.end(); ++itr)
+            {
+                const int* value = btree.find(itr->first);
+                ASSERT_NE(nullptr, value) << "key " << itr->first;
+                ASSERT_EQ(itr->second, *value);
+            }
+        }
+
+        // Still a regular tree, the appends rebuild the right edge.
+        for (int i = 0; i < _count; ++i)
+            btree.insert(_count * 2 + 1 + i, i);
+        EXPECT_TRUE(btree.verify());
+
+        btree.erase(-1, _count * 4);
+        EXPECT_TRUE(btree.empty());
+        EXPECT_EQ(0u, btree.height());
+    }
+
+    TEST(Btree_Test, test_11_range_erase)
+    {
+        for (int count = 0; count < 5000; count = count * 3 + 1)
+        {
+            checkRangeErase<BTree<int, int, G_ORDER> >(count + 1, count);
+            checkRangeErase<BTree<int, int, 7> >(count + 2, count);
+            checkRangeErase<BTree<int, int, 64> >(count + 3, count);
+        }
+
+        // The temporaries of the split and the join, and the range itself, are all destroyed; on the reclaimer too.
+        Reclaimer reclaimer;
+        {
+            test_btree_t btree, reclaimed;
+            reclaimed.setReclaimer(&reclaimer);
+            test_val_t value;
+            for (test_key_t i = 0; i < 1000; ++i)
+            {
+                btree.insert((i * 37) % 1000, value);
+                reclaimed.insert(i, value);
+            }
+
+            EXPECT_EQ(300u, btree.erase(100, 400));
+            EXPECT_EQ(1u, btree.erase(999, 2000));
+            EXPECT_EQ(500u, reclaimed.erase(250, 750));
+            reclaimer.drain();
+            EXPECT_TRUE(btree.verify());
+            EXPECT_TRUE(reclaimed.verify());
+            EXPECT_EQ(699u, btree.size());
+            EXPECT_EQ(500u, reclaimed.size());
+        }
+        reclaimer.drain();
+        EXPECT_TRUE((refState.m_constructor_count + refState.m_copyConstructor_count) == refState.m_destructor_count) << "Fatal Error, possible memory leak";
+    }
+
+    TEST(Btree_Test, test_12_remove_missing_after_append)
+    {
+        // The appends leave short nodes on the right edge. A failed search still restores them on the way back, and with siblings
+        // at MINKEYS the combines climb up to the root and empty it.
+        typedef BTree<test_key_t, test_val_t, 5, test_allocator_t> odd_btree_t;
+        TestObjectType::resetState();
+        {
+            test_val_t value;
+            odd_btree_t btree;
+            for (test_key_t i = 0; i <= 40; i += 2)
+                btree.insert(i, value);
+            btree.remove(34);
+            btree.remove(0);
+            btree.remove(4);
+            const size_t height = btree.height();
+            ASSERT_TRUE(btree.verify());
+
+            btree.remove(39); // Not in the tree.
+            EXPECT_TRUE(btree.verify());
+            EXPECT_EQ(height - 1, btree.height());
+            EXPECT_EQ(btree.stats().m_height, btree.height());
+            EXPECT_EQ(18u, btree.size());
+
+            // Every size, with a few removals to bring the siblings down, then every missing key.
+            for (test_key_t count = 1; count < 200; ++count)
+            {
+                odd_btree_t sweep;
+                for (test_key_t i = 0; i < count; ++i)
+                    sweep.insert(i * 2, value);
+                for (test_key_t i = 0; i < count; i += 5)
+                    sweep.remove(i * 2);
+
+                const size_t size = sweep.size();
+                for (test_key_t i = -1; i <= count * 2; i += 2)
+                {
+                    sweep.remove(i);
+                    ASSERT_TRUE(sweep.verify()) << count << " " << i;
+                    EXPECT_EQ(sweep.stats().m_height, sweep.height());
+                }
+                EXPECT_EQ(size, sweep.size());
+            }
+        }
+        EXPECT_TRUE((refState.m_constructor_count + refState.m_copyConstructor_count) == refState.m_destructor_count) << "Fatal Error, possible memory leak";
+    }
+
     // --------------------------------------------------------------------------------------------------
 }   // namespace test_btree
 }   // namespace glare_test
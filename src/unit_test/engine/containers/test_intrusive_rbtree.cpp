@@ -0,0 +1,206 @@
+#include "test_containers.h"
+#include "containers/IntrusiveRbTree.h"
+#include "gtest/gtest.h"
+#include <vector>
+#include <set>
+#include <stdlib.h>
+
+
+namespace glare { namespace
+{
+    struct Entity
+    {
+        int         m_id;
+        int         m_payload;
+        RbTreeHook  m_byId;
+        RbTreeHook  m_byPayload;
+
+        Entity(int _id = 0, int _payload = 0): m_id(_id), m_payload(_payload) {}
+    };
+
+    struct EntityId
+    {
+        typedef int key_type;
+        const key_type& operator() (const Entity& _entity) const { return _entity.m_id; }
+    };
+
+    struct EntityPayload
+    {
+        typedef int key_type;
+        const key_type& operator() (const Entity& _entity) const { return _entity.m_payload; }
+    };
+
+    typedef IntrusiveRbTree<Entity, &Entity::m_byId, EntityId>              id_tree_t;
+    typedef IntrusiveRbTree<Entity, &Entity::m_byPayload, EntityPayload>    payload_tree_t;
+
+    // Returns the black height of the subtree, -1 when a red node has a red child or the black heights differ.
+    int checkRbInvariants(const RbTreeHook* _node, const RbTreeHook* _parent)
+    {
+        if (_node == nullptr)
+            return 1;
+
+        if (_node->parent() != _parent)
+            return -1;
+
+        if (_node->isRed() && ((_node->left() && _node->left()->isRed()) || (_node->right() && _node->right()->isRed())))
+            return -1;
+
+        int leftHeight = checkRbInvariants(_node->left(), _node);
+        int rightHeight = checkRbInvariants(_node->right(), _node);
+        if (leftHeight < 0 || leftHeight != rightHeight)
+            return -1;
+
+        return leftHeight + (_node->isBlack() ? 1 : 0);
+    }
+
+    template<typename _Tree>
+    void checkAgainstSet(const _Tree& _tree, const std::set<int>& _expected, const std::vector<Entity>& _pool)
+    {
+        ASSERT_EQ(_expected.size(), _tree.size());
+
+        std::set<int>::const_iterator expectedIt = _expected.begin();
+        for (typename _Tree::iterator it = _tree.begin(); it != _tree.end(); ++it, ++expectedIt)
+        {
+            ASSERT_EQ(*expectedIt, it->m_id);
+        }
+        ASSERT_TRUE(expectedIt == _expected.end());
+
+        const RbTreeHook* root = nullptr;
+        if (!_tree.empty())
+        {
+            root = &_tree.begin()->m_byId;
+            while (root->parent())
+                root = root->parent();
+            ASSERT_TRUE(root->isBlack());
+        }
+        ASSERT_LT(0, checkRbInvariants(root, nullptr));
+
+        TreeStats treeStats = _tree.stats();
+        ASSERT_EQ(_expected.size(), treeStats.m_nodeCount);
+        ASSERT_EQ(treeStats.m_nodeCount * sizeof(RbTreeHook), treeStats.m_bytes);
+        (void)_pool;
+    }
+
+    TEST(IntrusiveRbTree_Test, test_1_insert_find)
+    {
+        const int count = 1000;
+        std::vector<Entity> pool;
+        pool.reserve(count);
+
+        id_tree_t tree;
+        std::set<int> expected;
+        srand(1);
+
+        for (int i = 0; i < count; ++i)
+        {
+            pool.push_back(Entity(rand() % (count * 4), i));
+            GLARE_PAIR<id_tree_t::iterator, bool> result = tree.insert(pool.back());
+
+            bool isNew = expected.insert(pool.back().m_id).second;
+            ASSERT_EQ(isNew, result.second);
+            ASSERT_EQ(pool.back().m_id, result.first->m_id);
+            if (isNew) {
+                ASSERT_EQ(&pool.back(), &*result.first); // Linked in place, not copied.
+            }
+        }
+
+        checkAgainstSet(tree, expected, pool);
+
+        for (int i = 0; i < count * 4; ++i)
+        {
+            Entity* entity = tree.find(i);
+            ASSERT_EQ(expected.count(i) != 0, entity != nullptr);
+            ASSERT_EQ(expected.count(i) != 0, tree.exists(i));
+            if (entity) {
+                ASSERT_EQ(i, entity->m_id);
+            }
+        }
+    }
+
+    TEST(IntrusiveRbTree_Test, test_2_erase)
+    {
+        const int count = 1000;
+        std::vector<Entity> pool;
+        pool.reserve(count);
+
+        id_tree_t tree;
+        std::set<int> expected;
+
+        for (int i = 0; i < count; ++i)
+        {
+            pool.push_back(Entity(i * 3, i));
+            tree.insert(pool.back());
+            expected.insert(i * 3);
+        }
+
+        // By reference.
+        for (int i = 0; i < count; i += 3)
+        {
+            tree.erase(pool[i]);
+            expected.erase(pool[i].m_id);
+            ASSERT_TRUE(pool[i].m_byId.parent() == nullptr && pool[i].m_byId.left() == nullptr && pool[i].m_byId.right() == nullptr);
+        }
+        checkAgainstSet(tree, expected, pool);
+
+        // By key.
+        for (int i = 1; i < count; i += 3)
+        {
+            Entity* erased = tree.erase(pool[i].m_id);
+            ASSERT_EQ(&pool[i], erased);
+            expected.erase(pool[i].m_id);
+        }
+        ASSERT_TRUE(tree.erase(-1) == nullptr);
+        checkAgainstSet(tree, expected, pool);
+
+        // An erased object can go back in.
+        tree.insert(pool[0]);
+        expected.insert(pool[0].m_id);
+        checkAgainstSet(tree, expected, pool);
+    }
+
+    TEST(IntrusiveRbTree_Test, test_3_clear_and_two_hooks)
+    {
+        const int count = 500;
+        std::vector<Entity> pool;
+        pool.reserve(count);
+
+        id_tree_t byId;
+        payload_tree_t byPayload;
+
+        for (int i = 0; i < count; ++i)
+        {
+            pool.push_back(Entity(i, count - i));
+            byId.insert(pool.back());
+            byPayload.insert(pool.back());
+        }
+
+        ASSERT_EQ(count, byId.size());
+        ASSERT_EQ(count, byPayload.size());
+        ASSERT_EQ(count - 1, byPayload.begin()->m_id); // Smallest payload.
+        ASSERT_EQ(0, byId.begin()->m_id);
+
+        byId.clear();
+        ASSERT_TRUE(byId.empty());
+        ASSERT_TRUE(byId.begin() == byId.end());
+        for (int i = 0; i < count; ++i)
+        {
+            ASSERT_TRUE(pool[i].m_byId.parent() == nullptr && pool[i].m_byId.left() == nullptr && pool[i].m_byId.right() == nullptr);
+        }
+
+        // The other hook is untouched.
+        ASSERT_EQ(count, byPayload.size());
+        int previous = 0;
+        for (payload_tree_t::iterator it = byPayload.begin(); it != byPayload.end(); ++it)
+        {
+            ASSERT_LT(previous, it->m_payload);
+            previous = it->m_payload;
+        }
+
+        id_tree_t other;
+        other.insert(pool[0]);
+        byId.swap(other);
+        ASSERT_EQ(1, byId.size());
+        ASSERT_TRUE(other.empty());
+    }
+
+}} // namespace
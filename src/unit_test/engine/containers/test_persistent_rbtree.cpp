@@ -0,0 +1,161 @@
+#include "test_containers.h"
+#include "containers/PersistentRbTree.h"
+#include "gtest/gtest.h"
+#include <vector>
+#include <map>
+#include <stdlib.h>
+
+
+namespace glare { namespace
+{
+    typedef PersistentRbTree<int, int>  persistent_tree_t;
+    typedef std::map<int, int>          expected_map_t;
+
+    // Counts the values alive: one per node, since every node holds its own copy.
+    struct LiveValue
+    {
+        static int s_alive;
+
+        int m_value;
+
+        LiveValue(): m_value(0) { ++s_alive; }
+        LiveValue(int _value): m_value(_value) { ++s_alive; }
+        LiveValue(const LiveValue& _other): m_value(_other.m_value) { ++s_alive; }
+        ~LiveValue() { --s_alive; }
+    };
+    int LiveValue::s_alive = 0;
+
+    void checkVersion(const persistent_tree_t& _tree, const expected_map_t& _expected)
+    {
+        ASSERT_TRUE(_tree.verify());
+        ASSERT_EQ(_expected.size(), _tree.size());
+
+        persistent_tree_t::const_iterator it = _tree.begin();
+        for (expected_map_t::const_iterator expectedIt = _expected.begin(); expectedIt != _expected.end(); ++expectedIt, ++it)
+        {
+            ASSERT_TRUE(it != _tree.end());
+            ASSERT_EQ(expectedIt->first, it->first);
+            ASSERT_EQ(expectedIt->second, it->second);
+        }
+        ASSERT_TRUE(it == _tree.end());
+    }
+
+    TEST(PersistentRbTree_Test, test_versions)
+    {
+        srand(17);
+        std::vector<persistent_tree_t> versions(1);
+        std::vector<expected_map_t> expected(1);
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            const int key = rand() % 500;
+            const int value = rand();
+            const persistent_tree_t& last = versions.back();
+            expected.push_back(expected.back());
+
+            switch (rand() % 3)
+            {
+            case 0:
+                versions.push_back(last.erase(key));
+                expected.back().erase(key);
+                break;
+            case 1:
+                versions.push_back(last.assign(key, value));
+                expected.back()[key] = value;
+                break;
+            default:
+                versions.push_back(last.insert(key, value));
+                expected.back().insert(expected_map_t::value_type(key, value));
+                break;
+            }
+        }
+
+        // Every version is still the tree it was when it was made.
+        for (std::size_t i = 0; i < versions.size(); i += 97)
+            checkVersion(versions[i], expected[i]);
+        checkVersion(versions.back(), expected.back());
+
+        // Down to empty, in random order.
+        persistent_tree_t tree = versions.back();
+        expected_map_t remaining = expected.back();
+        while (!remaining.empty())
+        {
+            expected_map_t::iterator it = remaining.begin();
+            std::advance(it, rand() % remaining.size());
+            tree = tree.erase(it->first);
+            remaining.erase(it);
+            ASSERT_TRUE(tree.verify());
+        }
+        EXPECT_TRUE(tree.empty());
+        checkVersion(versions.back(), expected.back());
+    }
+
+    TEST(PersistentRbTree_Test, test_lookup)
+    {
+        persistent_tree_t tree;
+        for (int i = 0; i < 100; ++i)
+            tree = tree.insert(i * 2, i);
+
+        int value = -1;
+        EXPECT_TRUE(tree.find(40, value));
+        EXPECT_EQ(20, value);
+        EXPECT_FALSE(tree.find(41, value));
+        EXPECT_TRUE(tree.exists(198));
+        EXPECT_FALSE(tree.exists(199));
+
+        // find() iterates on from the key.
+        persistent_tree_t::const_iterator it = tree.find(150);
+        for (int key = 150; key < 200; key += 2, ++it)
+        {
+            ASSERT_TRUE(it != tree.end());
+            ASSERT_EQ(key, it->first);
+        }
+        EXPECT_TRUE(it == tree.end());
+        EXPECT_TRUE(tree.find(151) == tree.end());
+
+        // Nothing to change, the same version back.
+        EXPECT_TRUE(tree.insert(40, 0).same_version(tree));
+        EXPECT_TRUE(tree.erase(41).same_version(tree));
+        EXPECT_FALSE(tree.assign(40, 0).same_version(tree));
+
+        TreeStats stats = tree.stats();
+        EXPECT_EQ(100u, stats.m_nodeCount);
+        EXPECT_LE(stats.m_height, 2u * stats.m_blackHeight);
+    }
+
+    TEST(PersistentRbTree_Test, test_sharing)
+    {
+        typedef PersistentRbTree<int, LiveValue> live_tree_t;
+        LiveValue::s_alive = 0;
+        {
+            live_tree_t tree;
+            for (int i = 0; i < 4096; ++i)
+                tree = tree.insert(i, LiveValue(i));
+            ASSERT_EQ(4096, LiveValue::s_alive); // The versions in between are gone.
+
+            // A new version copies its path only.
+            const int pathBound = 3 * static_cast<int>(tree.stats().m_height);
+            live_tree_t inserted = tree.insert(5000, LiveValue(1));
+            EXPECT_LE(LiveValue::s_alive - 4096, pathBound);
+
+            const int beforeErase = LiveValue::s_alive;
+            live_tree_t erased = tree.erase(2048);
+            EXPECT_LE(LiveValue::s_alive - beforeErase, pathBound);
+
+            // Copies share everything.
+            const int beforeCopies = LiveValue::s_alive;
+            std::vector<live_tree_t> copies(100, erased);
+            EXPECT_EQ(beforeCopies, LiveValue::s_alive);
+
+            // The nodes only the old version reached go with it.
+            tree = live_tree_t();
+            copies.clear();
+            erased = live_tree_t();
+            EXPECT_EQ(4097, LiveValue::s_alive);
+            EXPECT_TRUE(inserted.verify());
+            EXPECT_EQ(4097u, inserted.size());
+        }
+        EXPECT_EQ(0, LiveValue::s_alive);
+    }
+
+}} // namespace
@@ -1,9 +1,13 @@
 #include "test_containers.h"
 #include "containers/RbTree.h"
+#include "containers/RbTreeCompactNode.h"
+#include "containers/RbTreeParallel.h"
+#include "memory/ArenaAllocator.h"
 #include "gtest/gtest.h"
 #include <string>
 #include <vector>
 #include <set>
+#include <map>
 #include <stdlib.h>
 
 
@@ -460,5 +464,983 @@ namespace glare { namespace
         EXPECT_EQ(refStateInfo.m_copyConstructor_count + refStateInfo.m_constructor_count, refStateInfo.m_destructor_count) << "Constructor/Destructor calls mismatch, leak??";
     }
 
+    TEST(RedBlackTree_Test, test_prefetch)
+    {
+        RedBlackTree<int, int> tree;
+        EXPECT_EQ(0u, tree.prefetchDistance()) << "Prefetching is opt-in";
+
+        tree.setPrefetchDistance(2);
+        for (int i = 0; i < 1000; ++i)
+            tree.insert((i * 7919) % 1000, i);
+
+        for (int i = 0; i < 1000; ++i)
+            EXPECT_TRUE(tree.exists(i));
+        EXPECT_FALSE(tree.exists(1000));
+
+        RedBlackTree<int, int> copy(tree);
+        EXPECT_EQ(2u, copy.prefetchDistance());
+        copy.erase(10);
+        EXPECT_FALSE(copy.exists(10));
+    }
+
+    TEST(RedBlackTree_Test, test_stats)
+    {
+        RedBlackTree<int, int> tree;
+        TreeStats stats = tree.stats();
+        EXPECT_EQ(0u, stats.m_nodeCount);
+        EXPECT_EQ(0u, stats.m_height);
+        EXPECT_EQ(0u, stats.m_blackHeight);
+
+        const int Count = 4096;
+        for (int i = 0; i < Count; ++i)
+            tree.insert(i, i);
+        for (int i = 0; i < Count; i += 3)
+            tree.erase(i);
+
+        stats = tree.stats();
+        EXPECT_EQ(tree.size(), stats.m_size);
+        EXPECT_EQ(tree.size(), stats.m_nodeCount);
+        EXPECT_EQ(stats.m_height, stats.m_depthHistogram.size());
+        EXPECT_EQ(tree.size() * sizeof(RbTreeNode<int, int>), stats.m_bytes);
+
+        // Height is at most twice the black height, which is at most lg(n+1).
+        EXPECT_GT(stats.m_blackHeight, 0u);
+        EXPECT_LE(stats.m_height, 2 * stats.m_blackHeight);
+        EXPECT_LE(stats.m_blackHeight, 12u);
+
+        EXPECT_EQ(3u, stats.m_fillHistogram.size());
+        EXPECT_EQ(stats.m_nodeCount, stats.m_fillHistogram[0] + stats.m_fillHistogram[1] + stats.m_fillHistogram[2]);
+        EXPECT_GT(stats.averageDepth(), 0.0);
+        EXPECT_LT(stats.averageDepth(), static_cast<double>(stats.m_height));
+    }
+
+    typedef RedBlackTree<int, int>                      int_rbtree_t;
+
+    void checkAgainstMap(int_rbtree_t& _tree, const std::map<int, int>& _expected)
+    {
+        ASSERT_TRUE(_tree.verify());
+        ASSERT_EQ(_expected.size(), _tree.size());
+
+        std::map<int, int>::const_iterator expectedIt = _expected.begin();
+        for (int_rbtree_t::iterator it = _tree.begin(); it != _tree.end(); ++it, ++expectedIt)
+        {
+            ASSERT_EQ(expectedIt->first, it->first);
+            ASSERT_EQ(expectedIt->second, it->second);
+        }
+    }
+
+    void fillRandom(int_rbtree_t& _tree, std::map<int, int>& _expected, int _count, int _range, int _value)
+    {
+        for (int i = 0; i < _count; ++i)
+        {
+            const int key = rand() % _range;
+            _tree.insert(key, _value);
+            _expected.insert(std::make_pair(key, _value));
+        }
+    }
+
+    TEST(RedBlackTree_Test, test_join_split)
+    {
+        srand(7);
+        const int Sizes[] = { 0, 1, 2, 3, 10, 100, 1000 };
+        const int SizeCount = sizeof(Sizes) / sizeof(Sizes[0]);
+
+        // Join every pair of sizes, both ways round, so either side can be the taller.
+        for (int a = 0; a < SizeCount; ++a)
+        {
+            for (int b = 0; b < SizeCount; ++b)
+            {
+                int_rbtree_t left, right;
+                std::map<int, int> expected;
+                for (int i = 0; i < Sizes[a]; ++i) { left.insert(i, i); expected[i] = i; }
+                for (int i = 0; i < Sizes[b]; ++i) { right.insert(Sizes[a] + i, i); expected[Sizes[a] + i] = i; }
+
+                left.join(right);
+                checkAgainstMap(left, expected);
+                ASSERT_TRUE(right.empty());
+                ASSERT_TRUE(right.verify());
+            }
+        }
+
+        // Split at every position, including keys that aren't there, and join back.
+        int_rbtree_t tree;
+        std::map<int, int> expected;
+        for (int i = 0; i < 300; ++i) { tree.insert(i * 2, i); expected[i * 2] = i; }
+
+        for (int key = -1; key <= 601; key += 7)
+        {
+            int_rbtree_t right;
+            right.insert(-5, 0); // Cleared by the split.
+            tree.split(key, right);
+
+            std::map<int, int> expectedLess(expected.begin(), expected.lower_bound(key));
+            std::map<int, int> expectedGreater(expected.lower_bound(key), expected.end());
+            checkAgainstMap(tree, expectedLess);
+            checkAgainstMap(right, expectedGreater);
+
+            tree.join(right);
+            checkAgainstMap(tree, expected);
+        }
+    }
+
+    void checkSetOperations(ThreadPool* _pool)
+    {
+        const int Sizes[][2] = { { 0, 100 }, { 100, 0 }, { 1, 5000 }, { 5000, 1 }, { 300, 20000 }, { 20000, 300 }, { 20000, 20000 } };
+        for (int i = 0; i < static_cast<int>(sizeof(Sizes) / sizeof(Sizes[0])); ++i)
+        {
+            int_rbtree_t a, b;
+            std::map<int, int> expectedA, expectedB;
+            fillRandom(a, expectedA, Sizes[i][0], 40000, 1);
+            fillRandom(b, expectedB, Sizes[i][1], 40000, 2);
+
+            // Union keeps the values of the tree operated on.
+            int_rbtree_t unionTree(a);
+            std::map<int, int> expectedUnion(expectedA);
+            expectedUnion.insert(expectedB.begin(), expectedB.end());
+            unionTree.set_union(b, _pool);
+            checkAgainstMap(unionTree, expectedUnion);
+
+            int_rbtree_t intersectionTree(a);
+            std::map<int, int> expectedIntersection;
+            for (std::map<int, int>::iterator it = expectedA.begin(); it != expectedA.end(); ++it)
+            {
+                if (expectedB.count(it->first))
+                    expectedIntersection.insert(*it);
+            }
+            intersectionTree.set_intersection(b, _pool);
+            checkAgainstMap(intersectionTree, expectedIntersection);
+
+            int_rbtree_t differenceTree(a);
+            std::map<int, int> expectedDifference;
+            for (std::map<int, int>::iterator it = expectedA.begin(); it != expectedA.end(); ++it)
+            {
+                if (!expectedB.count(it->first))
+                    expectedDifference.insert(*it);
+            }
+            differenceTree.set_difference(b, _pool);
+            checkAgainstMap(differenceTree, expectedDifference);
+
+            // The other tree is only read.
+            checkAgainstMap(b, expectedB);
+        }
+    }
+
+    TEST(RedBlackTree_Test, test_set_operations)
+    {
+        srand(11);
+        checkSetOperations(nullptr);
+
+        ThreadPool pool(3);
+        checkSetOperations(&pool);
+
+        ThreadPool singleWorker(1);
+        checkSetOperations(&singleWorker);
+
+        int_rbtree_t tree;
+        std::map<int, int> expected;
+        fillRandom(tree, expected, 100, 1000, 1);
+        tree.set_union(tree);
+        tree.set_intersection(tree);
+        checkAgainstMap(tree, expected);
+        tree.set_difference(tree);
+        checkAgainstMap(tree, std::map<int, int>());
+    }
+
+    TEST(RedBlackTree_Test, test_set_operations_memory_leaks)
+    {
+        {
+            rbtree_t a, b;
+            test_val_t val;
+            for (int i = 0; i < 2000; ++i)
+            {
+                a.insert(i * 3, val);
+                b.insert(i * 2, val);
+            }
+
+            // Sequential, the construction counters of the test objects aren't atomic.
+            rbtree_t unionTree(a), intersectionTree(a), differenceTree(a);
+            unionTree.set_union(b);
+            intersectionTree.set_intersection(b);
+            differenceTree.set_difference(b);
+
+            rbtree_t right;
+            unionTree.split(1000, right);
+            EXPECT_TRUE(unionTree.verify() && right.verify());
+        }
+        EXPECT_EQ(refStateInfo.m_copyConstructor_count + refStateInfo.m_constructor_count, refStateInfo.m_destructor_count) << "Constructor/Destructor calls mismatch, leak??";
+    }
+
+    TEST(RedBlackTree_Test, test_bulk_construction)
+    {
+        srand(13);
+        ThreadPool pool(2);
+
+        // Every size up to a few levels, so each shape of the deepest level is covered.
+        for (int count = 0; count < 300; ++count)
+        {
+            std::vector<GLARE_PAIR<int, int> > sorted;
+            std::map<int, int> expected;
+            for (int i = 0; i < count; ++i)
+            {
+                sorted.push_back(std::make_pair(i, i));
+                expected[i] = i;
+            }
+
+            int_rbtree_t tree(sorted.begin(), sorted.end(), sorted_tag());
+            checkAgainstMap(tree, expected);
+        }
+
+        // Repeated keys keep their first value, as with insert.
+        std::vector<GLARE_PAIR<int, int> > sortedRepeats, unsorted;
+        std::map<int, int> expected;
+        for (int i = 0; i < 50000; ++i)
+        {
+            const int key = i / 3;
+            sortedRepeats.push_back(std::make_pair(key, i));
+            expected.insert(std::make_pair(key, i));
+        }
+        int_rbtree_t fromSorted(sortedRepeats.begin(), sortedRepeats.end(), sorted_tag());
+        checkAgainstMap(fromSorted, expected);
+
+        expected.clear();
+        for (int i = 0; i < 50000; ++i)
+        {
+            unsorted.push_back(std::make_pair(rand() % 20000, i));
+            expected.insert(unsorted.back());
+        }
+        int_rbtree_t fromUnsorted(unsorted.begin(), unsorted.end());
+        checkAgainstMap(fromUnsorted, expected);
+
+        int_rbtree_t fromUnsortedParallel(unsorted.begin(), unsorted.end(), &pool);
+        checkAgainstMap(fromUnsortedParallel, expected);
+
+        // From any input iterator, and the tree goes on as usual.
+        int_rbtree_t fromMap(expected.begin(), expected.end(), sorted_tag());
+        for (int i = 0; i < 20000; i += 2)
+        {
+            fromMap.erase(i);
+            expected.erase(i);
+        }
+        fromMap.insert(-1, -1);
+        expected[-1] = -1;
+        checkAgainstMap(fromMap, expected);
+    }
+
+    TEST(RedBlackTree_Test, test_bulk_construction_memory_leaks)
+    {
+        {
+            std::vector<rb_pair> values;
+            test_val_t val;
+            for (int i = 0; i < 1000; ++i)
+                values.push_back(rb_pair(rand() % 500, val));
+
+            rbtree_t unsortedTree(values.begin(), values.end());
+            EXPECT_TRUE(unsortedTree.verify());
+
+            rbtree_t sortedTree(unsortedTree.begin(), unsortedTree.end(), sorted_tag());
+            EXPECT_TRUE(sortedTree.verify());
+            EXPECT_EQ(unsortedTree.size(), sortedTree.size());
+        }
+        EXPECT_EQ(refStateInfo.m_copyConstructor_count + refStateInfo.m_constructor_count, refStateInfo.m_destructor_count) << "Constructor/Destructor calls mismatch, leak??";
+    }
+
+    TEST(RedBlackTree_Test, test_hinted_insert)
+    {
+        srand(17);
+        const int Count = 5000;
+        std::map<int, int> expected;
+
+        // Ascending with end() and with the previous result, descending with the previous result.
+        int_rbtree_t ascendingEnd, ascendingPrevious, descending;
+        int_rbtree_t::iterator previous = ascendingPrevious.end();
+        int_rbtree_t::iterator previousDescending = descending.end();
+        for (int i = 0; i < Count; ++i)
+        {
+            int_rbtree_t::iterator it = ascendingEnd.insert(ascendingEnd.end(), std::make_pair(i, i));
+            ASSERT_EQ(i, it->first);
+
+            previous = ascendingPrevious.insert(previous, std::make_pair(i, i));
+            ASSERT_EQ(i, previous->first);
+
+            previousDescending = descending.insert(previousDescending, std::make_pair(Count - 1 - i, Count - 1 - i));
+            ASSERT_EQ(Count - 1 - i, previousDescending->first);
+
+            expected[i] = i;
+        }
+        checkAgainstMap(ascendingEnd, expected);
+        checkAgainstMap(ascendingPrevious, expected);
+        checkAgainstMap(descending, expected);
+
+        // Duplicates return the element in place.
+        int_rbtree_t::iterator existing = ascendingEnd.find(10);
+        int_rbtree_t::iterator duplicate = ascendingEnd.insert(existing, std::make_pair(10, -1));
+        ASSERT_TRUE(duplicate == existing);
+        ASSERT_EQ(10, duplicate->second);
+        ASSERT_TRUE(ascendingEnd.insert(ascendingEnd.begin(), std::make_pair(20, -1)) == ascendingEnd.find(20));
+        checkAgainstMap(ascendingEnd, expected);
+
+        // Nearly sorted keys and arbitrary hints, good or bad.
+        int_rbtree_t tree;
+        std::map<int, int> expectedRandom;
+        int_rbtree_t::iterator hint = tree.end();
+        for (int i = 0; i < Count; ++i)
+        {
+            const int key = (i % 10 == 0) ? rand() % (Count * 4) : i * 4 + rand() % 3;
+            switch (rand() % 4)
+            {
+                case 0: hint = tree.end(); break;
+                case 1: hint = tree.begin(); break;
+                case 2: hint = tree.find(rand() % (Count * 4)); break;
+                default: break; // The previous result.
+            }
+            hint = tree.insert(hint, std::make_pair(key, i));
+            ASSERT_EQ(key, hint->first);
+            expectedRandom.insert(std::make_pair(key, i));
+        }
+        checkAgainstMap(tree, expectedRandom);
+    }
+
+    // Counts how it gets built.
+    struct CountedValue
+    {
+        static int s_constructed;
+        static int s_copied;
+        static int s_moved;
+
+        int m_value;
+
+        CountedValue(): m_value(0) { ++s_constructed; }
+        CountedValue(int _value): m_value(_value) { ++s_constructed; }
+        CountedValue(const CountedValue& _other): m_value(_other.m_value) { ++s_copied; }
+        CountedValue(CountedValue&& _other): m_value(_other.m_value) { _other.m_value = -1; ++s_moved; }
+
+        static void reset() { s_constructed = s_copied = s_moved = 0; }
+    };
+    int CountedValue::s_constructed = 0;
+    int CountedValue::s_copied = 0;
+    int CountedValue::s_moved = 0;
+
+    // A key with no default constructor, try_emplace builds it from the key it is given.
+    struct ExplicitKey
+    {
+        explicit ExplicitKey(int _value): m_value(_value) {}
+        bool operator<(const ExplicitKey& _other) const { return m_value < _other.m_value; }
+        bool operator>(const ExplicitKey& _other) const { return m_value > _other.m_value; }
+        bool operator==(const ExplicitKey& _other) const { return m_value == _other.m_value; }
+        int m_value;
+    };
+
+    TEST(RedBlackTree_Test, test_emplace)
+    {
+        typedef RedBlackTree<int, CountedValue> counted_tree_t;
+        typedef GLARE_PAIR<counted_tree_t::iterator, bool> counted_result_t;
+        counted_tree_t tree;
+
+        // Built in place from the argument.
+        CountedValue::reset();
+        counted_result_t result = tree.try_emplace(1, 10);
+        EXPECT_TRUE(result.second);
+        EXPECT_EQ(10, result.first->second.m_value);
+        EXPECT_EQ(1, CountedValue::s_constructed);
+        EXPECT_EQ(0, CountedValue::s_copied + CountedValue::s_moved);
+
+        result = tree.emplace(2, 20);
+        EXPECT_TRUE(result.second);
+        EXPECT_EQ(20, result.first->second.m_value);
+        EXPECT_EQ(2, CountedValue::s_constructed);
+        EXPECT_EQ(0, CountedValue::s_copied + CountedValue::s_moved);
+
+        // Nothing built for a key already there.
+        CountedValue::reset();
+        result = tree.try_emplace(1, 11);
+        EXPECT_FALSE(result.second);
+        EXPECT_EQ(10, result.first->second.m_value);
+        result = tree.emplace(2, 21);
+        EXPECT_FALSE(result.second);
+        EXPECT_EQ(20, result.first->second.m_value);
+        EXPECT_EQ(0, CountedValue::s_constructed + CountedValue::s_copied + CountedValue::s_moved);
+
+        // Values are moved in, not copied, and left alone when the key exists.
+        CountedValue value(30);
+        CountedValue::reset();
+        result = tree.try_emplace(3, std::move(value));
+        EXPECT_TRUE(result.second);
+        EXPECT_EQ(30, result.first->second.m_value);
+        EXPECT_EQ(1, CountedValue::s_moved);
+        EXPECT_EQ(0, CountedValue::s_copied);
+
+        CountedValue other(31);
+        result = tree.try_emplace(3, std::move(other));
+        EXPECT_FALSE(result.second);
+        EXPECT_EQ(31, other.m_value) << "Not moved from";
+
+        GLARE_PAIR<int, CountedValue> pair(4, CountedValue(40));
+        CountedValue::reset();
+        result = tree.insert(std::move(pair));
+        EXPECT_TRUE(result.second);
+        EXPECT_EQ(40, result.first->second.m_value);
+        EXPECT_EQ(1, CountedValue::s_moved);
+        EXPECT_EQ(0, CountedValue::s_copied);
+
+        // Copied once straight into the node.
+        CountedValue::reset();
+        result = tree.insert(5, CountedValue(50));
+        EXPECT_TRUE(result.second);
+        EXPECT_EQ(1, CountedValue::s_copied);
+        EXPECT_EQ(0, CountedValue::s_moved);
+
+        // Default constructed and moved into the node without a value.
+        CountedValue::reset();
+        result = tree.try_emplace(6);
+        EXPECT_TRUE(result.second);
+        EXPECT_EQ(0, result.first->second.m_value);
+        EXPECT_EQ(1, CountedValue::s_constructed);
+        EXPECT_EQ(0, CountedValue::s_copied);
+        EXPECT_EQ(1, CountedValue::s_moved);
+
+        // Nothing at all for a key already there.
+        CountedValue::reset();
+        result = tree.try_emplace(5);
+        EXPECT_FALSE(result.second);
+        EXPECT_EQ(50, result.first->second.m_value);
+        EXPECT_EQ(0, CountedValue::s_constructed);
+        EXPECT_EQ(0, CountedValue::s_copied);
+        EXPECT_EQ(0, CountedValue::s_moved);
+
+        EXPECT_EQ(6u, tree.size());
+        EXPECT_TRUE(tree.verify());
+
+        RedBlackTree<ExplicitKey, int> explicitKeys;
+        EXPECT_TRUE(explicitKeys.try_emplace(ExplicitKey(3)).second);
+        EXPECT_FALSE(explicitKeys.try_emplace(ExplicitKey(3)).second);
+        EXPECT_EQ(1u, explicitKeys.size());
+    }
+
+    // The same random workload on any node type, checked against a std::map.
+    template<typename _Tree>
+    void checkNodeType()
+    {
+        srand(17);
+        _Tree tree;
+        std::map<int, int> expected;
+
+        for (int i = 0; i < 4000; ++i)
+        {
+            const int key = rand() % 2000;
+            if (rand() % 3)
+            {
+                tree.insert(key, i);
+                expected.insert(std::make_pair(key, i));
+            }
+            else
+            {
+                tree.erase(key);
+                expected.erase(key);
+            }
+        }
+        ASSERT_TRUE(tree.verify());
+        ASSERT_EQ(expected.size(), tree.size());
+
+        _Tree copy(tree);
+        ASSERT_TRUE(copy.verify());
+
+        _Tree right;
+        copy.split(1000, right);
+        copy.join(right);
+        ASSERT_TRUE(copy.verify());
+
+        std::map<int, int>::const_iterator expectedIt = expected.begin();
+        for (typename _Tree::iterator it = copy.begin(); it != copy.end(); ++it, ++expectedIt)
+        {
+            ASSERT_EQ(expectedIt->first, it->first);
+            ASSERT_EQ(expectedIt->second, it->second);
+        }
+        ASSERT_TRUE(expectedIt == expected.end());
+
+        TreeStats stats = tree.stats();
+        EXPECT_EQ(expected.size(), stats.m_nodeCount);
+        EXPECT_LE(stats.m_height, 2 * stats.m_blackHeight);
+    }
+
+    TEST(RedBlackTree_Test, test_compact_nodes)
+    {
+        typedef RbTreeCompactNode<int, int>  compact_node_t;
+        typedef RbTreeIndexNode<int, int>    index_node_t;
+
+        // The color costs no room of its own, and the index links are a third of the pointer links on 64-bit.
+        EXPECT_EQ(3 * sizeof(void*) + sizeof(GLARE_PAIR<int, int>), sizeof(compact_node_t));
+        EXPECT_EQ(3 * sizeof(std::uint32_t) + sizeof(GLARE_PAIR<int, int>), sizeof(index_node_t));
+        EXPECT_LT(sizeof(compact_node_t), sizeof(RbTreeNode<int, int>));
+
+        compact_node_t node;
+        node.color(compact_node_t::Black);
+        node.parent(&node);
+        EXPECT_EQ(&node, node.parent());
+        EXPECT_TRUE(node.isBlack());
+        node.color(compact_node_t::Red);
+        EXPECT_EQ(&node, node.parent());
+        node.parent(nullptr);
+        EXPECT_TRUE(node.isRed());
+
+        checkNodeType<RedBlackTree<int, int, less<int>, default_allocator<int>, compact_node_t> >();
+
+        typedef IndexPool<index_node_t> index_pool_t;
+        index_pool_t::reserve(8000);
+        checkNodeType<RedBlackTree<int, int, less<int>, IndexPoolAllocator<int>, index_node_t> >();
+        EXPECT_EQ(0u, index_pool_t::size()) << "Every node went back to the pool";
+
+        // Freed slots are handed out again before the untouched ones.
+        index_node_t* first = index_pool_t::allocate();
+        index_pool_t::deallocate(first);
+        EXPECT_EQ(first, index_pool_t::allocate());
+        index_pool_t::deallocate(first);
+        EXPECT_EQ(first, index_pool_t::at(index_pool_t::index(first)));
+        EXPECT_TRUE(index_pool_t::at(0) == nullptr);
+        index_pool_t::reserve(0);
+
+        // The color takes the top bit of the parent index, the pool stops below it.
+        EXPECT_TRUE(index_pool_limit<index_node_t>::value == 0x7FFFFFFFu);
+        EXPECT_TRUE(index_pool_limit<int>::value == 0xFFFFFFFEu);
+    }
+
+    TEST(RedBlackTree_Test, test_bounds)
+    {
+        srand(23);
+        int_rbtree_t tree;
+        std::map<int, int> expected;
+        for (int i = 0; i < 2000; ++i)
+        {
+            const int key = (rand() % 3000) * 2; // Even keys, the odd ones fall between.
+            tree.insert(key, i);
+            expected.insert(std::make_pair(key, i));
+        }
+
+        for (int key = -3; key < 6004; ++key)
+        {
+            std::map<int, int>::const_iterator expectedLower = expected.lower_bound(key);
+            std::map<int, int>::const_iterator expectedUpper = expected.upper_bound(key);
+            int_rbtree_t::iterator lower = tree.lower_bound(key);
+            int_rbtree_t::iterator upper = tree.upper_bound(key);
+
+            ASSERT_EQ(expectedLower == expected.end(), lower == tree.end());
+            ASSERT_EQ(expectedUpper == expected.end(), upper == tree.end());
+            if (lower != tree.end()) {
+                ASSERT_EQ(expectedLower->first, lower->first);
+            }
+            if (upper != tree.end()) {
+                ASSERT_EQ(expectedUpper->first, upper->first);
+            }
+
+            GLARE_PAIR<int_rbtree_t::iterator, int_rbtree_t::iterator> range = tree.equal_range(key);
+            ASSERT_TRUE(range.first == lower && range.second == upper);
+            ASSERT_EQ(expected.count(key), static_cast<std::size_t>(std::distance(range.first, range.second)));
+        }
+
+        // Every [low, high) window walks the same elements as the map.
+        for (int i = 0; i < 200; ++i)
+        {
+            const int low = rand() % 6100 - 50;
+            const int high = low + rand() % 400;
+            std::map<int, int>::const_iterator expectedIt = expected.lower_bound(low);
+
+            int_rbtree_t::range_view view = tree.range(low, high);
+            for (int_rbtree_t::iterator it = view.begin(); it != view.end(); ++it, ++expectedIt)
+            {
+                ASSERT_TRUE(expectedIt != expected.end() && expectedIt->first < high);
+                ASSERT_EQ(expectedIt->first, it->first);
+                ASSERT_EQ(expectedIt->second, it->second);
+            }
+            ASSERT_TRUE(expectedIt == expected.end() || expectedIt->first >= high);
+            ASSERT_EQ(expected.lower_bound(low) == expected.lower_bound(high), view.empty());
+        }
+
+        EXPECT_TRUE(tree.range(100, 100).empty());
+        EXPECT_TRUE(tree.range(200, 100).empty());
+
+        int_rbtree_t empty;
+        EXPECT_TRUE(empty.lower_bound(0) == empty.end());
+        EXPECT_TRUE(empty.upper_bound(0) == empty.end());
+        EXPECT_TRUE(empty.range(0, 10).empty());
+    }
+
+    TEST(RedBlackTree_Test, test_node_handle)
+    {
+        srand(29);
+        int_rbtree_t left, right;
+        std::map<int, int> expectedLeft, expectedRight;
+        fillRandom(left, expectedLeft, 1000, 3000, 1);
+        fillRandom(right, expectedRight, 1000, 3000, 2);
+
+        // Moved from one tree to the other, the very same node.
+        const int key = left.begin()->first;
+        const int_rbtree_t::value_type* element = &*left.begin();
+        int_rbtree_t::node_handle node = left.extract(key);
+        ASSERT_FALSE(node.empty());
+        EXPECT_EQ(key, node.key());
+        EXPECT_EQ(1, node.value());
+        EXPECT_FALSE(left.exists(key));
+        expectedLeft.erase(key);
+        checkAgainstMap(left, expectedLeft);
+
+        node.key() = 5000; // Not in either tree.
+        node.value() = 3;
+        GLARE_PAIR<int_rbtree_t::iterator, bool> result = right.insert(std::move(node));
+        EXPECT_TRUE(result.second);
+        EXPECT_TRUE(node.empty());
+        EXPECT_EQ(element, &*result.first);
+        expectedRight[5000] = 3;
+        checkAgainstMap(right, expectedRight);
+
+        // A key already there: the handle keeps its node.
+        const int duplicate = right.begin()->first;
+        left.insert(duplicate, 4);
+        expectedLeft.insert(std::make_pair(duplicate, 4));
+        node = left.extract(left.find(duplicate));
+        expectedLeft.erase(duplicate);
+        result = right.insert(std::move(node));
+        EXPECT_FALSE(result.second);
+        EXPECT_FALSE(node.empty());
+        EXPECT_EQ(duplicate, result.first->first);
+        EXPECT_EQ(expectedRight[duplicate], result.first->second);
+
+        EXPECT_TRUE(left.extract(-1).empty());
+        EXPECT_TRUE(left.extract(left.end()).empty());
+        EXPECT_FALSE(left.insert(int_rbtree_t::node_handle()).second);
+
+        // Every key right lacks moves, the others stay.
+        std::map<int, int> expectedMerged = expectedRight, expectedRest;
+        for (std::map<int, int>::const_iterator it = expectedLeft.begin(); it != expectedLeft.end(); ++it)
+        {
+            if (!expectedMerged.insert(*it).second)
+                expectedRest.insert(*it);
+        }
+        right.merge(left);
+        checkAgainstMap(right, expectedMerged);
+        checkAgainstMap(left, expectedRest);
+
+        right.merge(right);
+        checkAgainstMap(right, expectedMerged);
+    }
+
+    typedef RedBlackTree<int, int, less<int>, default_allocator<int>, RbTreeNode<int, int>, rb_multi_keys> int_multi_rbtree_t;
+
+    void checkAgainstMultimap(int_multi_rbtree_t& _tree, const std::multimap<int, int>& _expected)
+    {
+        ASSERT_TRUE(_tree.verify());
+        ASSERT_EQ(_expected.size(), _tree.size());
+
+        // std::multimap keeps equal keys in insertion order as well.
+        std::multimap<int, int>::const_iterator expectedIt = _expected.begin();
+        for (int_multi_rbtree_t::iterator it = _tree.begin(); it != _tree.end(); ++it, ++expectedIt)
+        {
+            ASSERT_EQ(expectedIt->first, it->first);
+            ASSERT_EQ(expectedIt->second, it->second);
+        }
+    }
+
+    TEST(RedBlackTree_Test, test_multi_keys)
+    {
+        srand(31);
+        int_multi_rbtree_t tree;
+        std::multimap<int, int> expected;
+        for (int i = 0; i < 3000; ++i)
+        {
+            const int key = rand() % 300;
+            GLARE_PAIR<int_multi_rbtree_t::iterator, bool> result = tree.insert(key, i);
+            ASSERT_TRUE(result.second);
+            ASSERT_EQ(i, result.first->second);
+            expected.insert(std::make_pair(key, i));
+        }
+        checkAgainstMultimap(tree, expected);
+
+        for (int key = -1; key <= 300; ++key)
+        {
+            ASSERT_EQ(expected.count(key), tree.count(key));
+
+            GLARE_PAIR<int_multi_rbtree_t::iterator, int_multi_rbtree_t::iterator> range = tree.equal_range(key);
+            std::multimap<int, int>::const_iterator expectedIt = expected.lower_bound(key);
+            for (int_multi_rbtree_t::iterator it = range.first; it != range.second; ++it, ++expectedIt)
+                ASSERT_EQ(expectedIt->second, it->second);
+            ASSERT_TRUE(expectedIt == expected.upper_bound(key));
+
+            // The first one inserted.
+            int value = -1;
+            ASSERT_EQ(expected.count(key) != 0, tree.find(key, value));
+            if (expected.count(key)) {
+                ASSERT_EQ(expected.lower_bound(key)->second, value);
+                ASSERT_TRUE(tree.find(key) == range.first);
+            }
+        }
+
+        // Hints, good or bad, keep the insertion order.
+        int_multi_rbtree_t::iterator hint = tree.end();
+        for (int i = 3000; i < 3500; ++i)
+        {
+            const int key = rand() % 300;
+            switch (rand() % 3)
+            {
+                case 0: hint = tree.end(); break;
+                case 1: hint = tree.find(key); break;
+                default: break; // The previous result.
+            }
+            hint = tree.insert(hint, std::make_pair(key, i));
+            ASSERT_EQ(i, hint->second);
+            expected.insert(std::make_pair(key, i));
+        }
+        checkAgainstMultimap(tree, expected);
+
+        // erase(key) takes every one of them.
+        for (int key = 0; key < 300; key += 3)
+        {
+            tree.erase(key);
+            expected.erase(key);
+        }
+        checkAgainstMultimap(tree, expected);
+
+        // Extracted nodes of a repeated key go back after the others.
+        int_multi_rbtree_t::node_handle node = tree.extract(tree.find(1));
+        std::multimap<int, int>::iterator first = expected.find(1);
+        const int moved = first->second;
+        expected.erase(first);
+        EXPECT_TRUE(tree.insert(std::move(node)).second);
+        expected.insert(std::make_pair(1, moved));
+        checkAgainstMultimap(tree, expected);
+
+        // Splitting at a repeated key sends them all right, joining brings them back in order.
+        int_multi_rbtree_t right;
+        tree.split(100, right);
+        ASSERT_TRUE(tree.verify() && right.verify());
+        EXPECT_EQ(0u, tree.count(100));
+        EXPECT_EQ(expected.count(100), right.count(100));
+        tree.join(right);
+        checkAgainstMultimap(tree, expected);
+
+        // Bulk construction keeps them all, sorted or not, and merge moves every node.
+        std::vector<GLARE_PAIR<int, int> > pairs(expected.begin(), expected.end());
+        int_multi_rbtree_t sorted(pairs.begin(), pairs.end(), sorted_tag());
+        checkAgainstMultimap(sorted, expected);
+
+        std::vector<GLARE_PAIR<int, int> > shuffled;
+        std::multimap<int, int> expectedShuffled;
+        for (int i = 0; i < 2000; ++i)
+        {
+            shuffled.push_back(std::make_pair(rand() % 100, i));
+            expectedShuffled.insert(shuffled.back());
+        }
+        int_multi_rbtree_t unsorted(shuffled.begin(), shuffled.end());
+        checkAgainstMultimap(unsorted, expectedShuffled);
+
+        sorted.merge(unsorted);
+        EXPECT_TRUE(unsorted.empty());
+        expected.insert(expectedShuffled.begin(), expectedShuffled.end());
+        checkAgainstMultimap(sorted, expected);
+    }
+
+    void checkParallelTraversal(int_multi_rbtree_t& _tree, ThreadPool* _pool)
+    {
+        std::vector<int> keys;
+        long long sum = 0;
+        for (int_multi_rbtree_t::iterator it = _tree.begin(); it != _tree.end(); ++it)
+        {
+            keys.push_back(it->first);
+            sum += it->second;
+        }
+
+        std::atomic<long long> visitedSum(0);
+        std::atomic<std::size_t> visited(0);
+        parallel_for_each(_tree, [&](const int_multi_rbtree_t::value_type& _pair) { visitedSum += _pair.second; ++visited; }, _pool);
+        EXPECT_EQ(keys.size(), visited.load());
+        EXPECT_EQ(sum, visitedSum.load());
+
+        // Concatenation doesn't commute, the keys come back in order only if the partials are combined in order.
+        typedef std::vector<int> key_list_t;
+        key_list_t reduced = parallel_reduce(_tree, key_list_t(),
+            [](key_list_t _list, const int_multi_rbtree_t::value_type& _pair) { _list.push_back(_pair.first); return _list; },
+            [](key_list_t _left, const key_list_t& _right) { _left.insert(_left.end(), _right.begin(), _right.end()); return _left; }, _pool);
+        EXPECT_EQ(keys, reduced);
+
+        std::vector<key_list_t> chunks;
+        parallel_for_each_ordered(_tree, chunks, [](int_multi_rbtree_t::iterator _first, int_multi_rbtree_t::iterator _last, key_list_t& _result)
+        {
+            for (; _first != _last; ++_first)
+                _result.push_back(_first->first);
+        }, _pool);
+        if (_pool == nullptr) {
+            EXPECT_EQ(1u, chunks.size());
+        }
+        else if (_tree.size() > 1) {
+            EXPECT_LT(1u, chunks.size());
+        }
+
+        key_list_t concatenated;
+        for (std::size_t i = 0; i < chunks.size(); ++i)
+            concatenated.insert(concatenated.end(), chunks[i].begin(), chunks[i].end());
+        EXPECT_EQ(keys, concatenated);
+    }
+
+    TEST(RedBlackTree_Test, test_parallel_traversal)
+    {
+        srand(37);
+        ThreadPool pool(3), singleWorker(1);
+
+        // Repeated keys too, a range cut at one of them must keep them together.
+        for (int count = 0; count < 2000; count = count * 2 + 1)
+        {
+            int_multi_rbtree_t tree;
+            for (int i = 0; i < count; ++i)
+                tree.insert(rand() % (count / 2 + 1), rand() % 1000);
+
+            checkParallelTraversal(tree, nullptr);
+            checkParallelTraversal(tree, &pool);
+            checkParallelTraversal(tree, &singleWorker);
+        }
+    }
+
+    TEST(RedBlackTree_Test, test_node_handle_memory_leaks)
+    {
+        {
+            rbtree_t source, target;
+            test_val_t val;
+            for (int i = 0; i < 200; ++i)
+            {
+                source.insert(i, val);
+                target.insert(i + 100, val);
+            }
+
+            // Nothing is built or copied moving nodes, an unused handle destroys its element.
+            const int constructed = refStateInfo.m_constructor_count + refStateInfo.m_copyConstructor_count;
+            rbtree_t::node_handle node = source.extract(50);
+            target.insert(std::move(node));
+            target.merge(source);
+            EXPECT_EQ(constructed, refStateInfo.m_constructor_count + refStateInfo.m_copyConstructor_count);
+            EXPECT_EQ(300u, target.size());
+            EXPECT_EQ(100u, source.size());
+
+            rbtree_t::node_handle unused = source.extract(150);
+            EXPECT_FALSE(unused.empty());
+        }
+        EXPECT_EQ(refStateInfo.m_copyConstructor_count + refStateInfo.m_constructor_count, refStateInfo.m_destructor_count) << "Constructor/Destructor calls mismatch, leak??";
+    }
+
+    struct rbtree_arena_tag {};
+    typedef RedBlackTree<int, int, less<int>, ArenaAllocator<int, rbtree_arena_tag> >   arena_rbtree_t;
+
+    TEST(RedBlackTree_Test, test_parallel_copy_and_reclaim)
+    {
+        srand(41);
+        ThreadPool pool(3), singleWorker(1);
+
+        for (int count = 0; count < 5000; count = count * 3 + 1)
+        {
+            int_rbtree_t source;
+            std::map<int, int> expected;
+            fillRandom(source, expected, count, count * 4 + 1, 1);
+
+            int_rbtree_t sequential(source, nullptr), parallel(source, &pool), single(source, &singleWorker);
+            checkAgainstMap(sequential, expected);
+            checkAgainstMap(parallel, expected);
+            checkAgainstMap(single, expected);
+            checkAgainstMap(source, expected);
+        }
+
+        // Handed over to the reclaimer the tree is empty at once, every element is destroyed once it is drained. The element counters
+        // are not atomic, nothing is built while the reclaimer runs.
+        Reclaimer reclaimer;
+        {
+            rbtree_t tree;
+            tree.setReclaimer(&reclaimer);
+            test_val_t val;
+            for (int i = 0; i < 1000; ++i)
+                tree.insert(i, val);
+
+            tree.clear();
+            EXPECT_EQ(0u, tree.size());
+            EXPECT_TRUE(tree.begin() == tree.end());
+            reclaimer.drain();
+            EXPECT_EQ(0u, reclaimer.pending());
+
+            tree.insert(1, val);
+        }
+        reclaimer.drain();
+        EXPECT_EQ(refStateInfo.m_copyConstructor_count + refStateInfo.m_constructor_count, refStateInfo.m_destructor_count) << "Constructor/Destructor calls mismatch, leak??";
+
+        // An arena takes its memory back in bulk, clear() gives nothing back and visits nothing.
+        {
+            arena_rbtree_t tree;
+            for (int i = 0; i < 1000; ++i)
+                tree.insert(i, i);
+
+            const size_t used = Arena<rbtree_arena_tag>::used();
+            EXPECT_GE(used, 1000 * sizeof(arena_rbtree_t::node_type));
+            tree.clear();
+            EXPECT_EQ(used, Arena<rbtree_arena_tag>::used());
+            EXPECT_EQ(0u, tree.size());
+
+            tree.insert(7, 7);
+            EXPECT_TRUE(tree.verify());
+            EXPECT_TRUE(tree.exists(7));
+        }
+        Arena<rbtree_arena_tag>::reset();
+        EXPECT_EQ(0u, Arena<rbtree_arena_tag>::used());
+        EXPECT_EQ(0u, Arena<rbtree_arena_tag>::reserved());
+    }
+
+    TEST(RedBlackTree_Test, test_range_erase)
+    {
+        srand(43);
+        for (int count = 0; count < 3000; count = count * 3 + 1)
+        {
+            int_rbtree_t tree;
+            std::map<int, int> expected;
+            fillRandom(tree, expected, count, count * 2 + 1, 1);
+
+            // Empty, reversed, outside and overlapping ranges, down to an empty tree.
+            for (int round = 0; round < 20 && !expected.empty(); ++round)
+            {
+                const int low = rand() % (count * 2 + 3) - 1;
+                const int high = round % 5 == 0 ? low : low + rand() % (count / 4 + 2);
+                const size_t before = expected.size();
+                expected.erase(expected.lower_bound(low), high > low ? expected.lower_bound(high) : expected.lower_bound(low));
+                EXPECT_EQ(before - expected.size(), tree.erase(low, high));
+                checkAgainstMap(tree, expected);
+            }
+            EXPECT_EQ(expected.size(), tree.erase(-1, count * 2 + 1));
+            EXPECT_TRUE(tree.empty());
+        }
+
+        // Every copy of a repeated key goes.
+        int_multi_rbtree_t multi;
+        std::multimap<int, int> expectedMulti;
+        for (int i = 0; i < 1000; ++i)
+        {
+            const int key = rand() % 50;
+            multi.insert(key, i);
+            expectedMulti.insert(std::make_pair(key, i));
+        }
+        expectedMulti.erase(expectedMulti.lower_bound(10), expectedMulti.lower_bound(20));
+        EXPECT_EQ(1000u - expectedMulti.size(), multi.erase(10, 20));
+        checkAgainstMultimap(multi, expectedMulti);
+
+        // The nodes of the range on the reclaimer, the elements are all destroyed once it is drained.
+        Reclaimer reclaimer;
+        {
+            rbtree_t tree;
+            tree.setReclaimer(&reclaimer);
+            test_val_t val;
+            for (int i = 0; i < 1000; ++i)
+                tree.insert(i, val);
+
+            EXPECT_EQ(500u, tree.erase(250, 750));
+            reclaimer.drain();
+            EXPECT_EQ(500u, tree.size());
+            EXPECT_TRUE(tree.verify());
+            EXPECT_TRUE(tree.exists(249));
+            EXPECT_FALSE(tree.exists(250));
+            EXPECT_TRUE(tree.exists(750));
+        }
+        reclaimer.drain();
+        EXPECT_EQ(refStateInfo.m_copyConstructor_count + refStateInfo.m_constructor_count, refStateInfo.m_destructor_count) << "Constructor/Destructor calls mismatch, leak??";
+    }
+
 }
 }   // namespace glare
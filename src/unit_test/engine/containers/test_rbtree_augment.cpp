@@ -0,0 +1,201 @@
+#include "test_containers.h"
+#include "containers/RbTreeAugment.h"
+#include "gtest/gtest.h"
+#include <vector>
+#include <set>
+#include <map>
+#include <stdlib.h>
+
+
+namespace glare { namespace
+{
+    typedef RbTreeAugmentedNode<int, int, rb_size_augment>                          ranked_node_t;
+    typedef RedBlackTree<int, int, less<int>, default_allocator<int>, ranked_node_t> ranked_tree_t;
+
+    typedef RbTreeAugmentedNode<int, int, rb_sum_augment<long long> >               sum_node_t;
+    typedef RedBlackTree<int, int, less<int>, default_allocator<int>, sum_node_t>   sum_tree_t;
+
+    typedef GLARE_PAIR<int, int>                                                    interval_t;
+    typedef RbTreeAugmentedNode<interval_t, int, rb_interval_augment<int> >         interval_node_t;
+    typedef RedBlackTree<interval_t, int, less<interval_t>, default_allocator<int>, interval_node_t> interval_tree_t;
+
+    // Returns the size of the subtree, -1 when a node holds a stale size.
+    int checkSizes(const ranked_node_t* _node)
+    {
+        if (_node == nullptr)
+            return 0;
+
+        const int left = checkSizes(_node->left());
+        const int right = checkSizes(_node->right());
+        if (left < 0 || right < 0 || _node->metadata() != static_cast<std::size_t>(left + right + 1))
+            return -1;
+        return left + right + 1;
+    }
+
+    void checkRanks(const ranked_tree_t& _tree, const std::set<int>& _expected)
+    {
+        ASSERT_EQ(static_cast<int>(_expected.size()), checkSizes(_tree.root()));
+
+        std::size_t index = 0;
+        for (std::set<int>::const_iterator it = _expected.begin(); it != _expected.end(); ++it, ++index)
+        {
+            ranked_tree_t::iterator selected = rb_select(_tree, index);
+            ASSERT_TRUE(selected != ranked_tree_t::iterator());
+            ASSERT_EQ(*it, selected->first);
+            ASSERT_EQ(index, rb_rank(_tree, *it));
+            ASSERT_EQ(index + 1, rb_rank(_tree, *it + 1)); // Odd, never a key.
+        }
+        ASSERT_TRUE(rb_select(_tree, _expected.size()) == ranked_tree_t::iterator());
+    }
+
+    TEST(RedBlackTree_Augment_Test, test_rank_select)
+    {
+        srand(3);
+        ranked_tree_t tree;
+        std::set<int> expected;
+
+        for (int i = 0; i < 3000; ++i)
+        {
+            const int key = (rand() % 2000) * 2; // Even keys, so key + 1 is never there.
+            if (rand() % 3)
+            {
+                tree.insert(key, i);
+                expected.insert(key);
+            }
+            else
+            {
+                tree.erase(key);
+                expected.erase(key);
+            }
+        }
+        ASSERT_TRUE(tree.verify());
+        checkRanks(tree, expected);
+        EXPECT_EQ(0u, rb_rank(tree, -1));
+
+        // Every way of relinking keeps the sizes.
+        ranked_tree_t copy(tree);
+        checkRanks(copy, expected);
+
+        ranked_tree_t right;
+        copy.split(2000, right);
+        ASSERT_EQ(static_cast<int>(copy.size()), checkSizes(copy.root()));
+        ASSERT_EQ(static_cast<int>(right.size()), checkSizes(right.root()));
+        copy.join(right);
+        checkRanks(copy, expected);
+
+        ranked_tree_t other;
+        std::set<int> otherKeys;
+        for (int i = 0; i < 500; ++i)
+        {
+            const int key = (rand() % 3000) * 2;
+            other.insert(key, i);
+            otherKeys.insert(key);
+        }
+        copy.set_union(other);
+        std::set<int> united(expected);
+        united.insert(otherKeys.begin(), otherKeys.end());
+        checkRanks(copy, united);
+
+        copy.set_difference(other);
+        std::set<int> difference;
+        for (std::set<int>::const_iterator it = united.begin(); it != united.end(); ++it) {
+            if (!otherKeys.count(*it)) difference.insert(*it);
+        }
+        checkRanks(copy, difference);
+
+        std::vector<GLARE_PAIR<int, int> > sorted;
+        for (std::set<int>::const_iterator it = expected.begin(); it != expected.end(); ++it) {
+            sorted.push_back(GLARE_PAIR<int, int>(*it, 0));
+        }
+        ranked_tree_t bulk(sorted.begin(), sorted.end(), sorted_tag());
+        checkRanks(bulk, expected);
+    }
+
+    TEST(RedBlackTree_Augment_Test, test_range_sum)
+    {
+        srand(5);
+        sum_tree_t tree;
+        std::map<int, int> expected;
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            const int key = rand() % 1000;
+            const int value = rand() % 100 - 50;
+            if (rand() % 4)
+            {
+                if (tree.insert(key, value).second)
+                    expected[key] = value;
+            }
+            else
+            {
+                tree.erase(key);
+                expected.erase(key);
+            }
+        }
+        ASSERT_TRUE(tree.verify());
+
+        for (int low = -10; low < 1010; low += 37)
+        {
+            for (int high = low; high < 1010; high += 53)
+            {
+                long long sum = 0;
+                for (std::map<int, int>::const_iterator it = expected.lower_bound(low); it != expected.end() && it->first < high; ++it)
+                    sum += it->second;
+                ASSERT_EQ(sum, rb_range_sum(tree, low, high)) << "[" << low << ", " << high << ")";
+            }
+        }
+
+        // A value changed in place counts once refreshed.
+        sum_tree_t::iterator it = tree.begin();
+        const long long before = rb_sum_less(tree, 1000);
+        it->second += 1000;
+        tree.refresh(it);
+        EXPECT_EQ(before + 1000, rb_sum_less(tree, 1000));
+    }
+
+    TEST(RedBlackTree_Augment_Test, test_interval_overlap)
+    {
+        srand(11);
+        interval_tree_t tree;
+        std::set<interval_t> expected;
+
+        for (int i = 0; i < 1500; ++i)
+        {
+            const int low = rand() % 10000;
+            const interval_t interval(low, low + rand() % 200);
+            if (rand() % 4)
+            {
+                tree.insert(interval, i);
+                expected.insert(interval);
+            }
+            else
+            {
+                tree.erase(interval);
+                expected.erase(interval);
+            }
+        }
+        ASSERT_TRUE(tree.verify());
+
+        for (int query = 0; query < 500; ++query)
+        {
+            const int low = rand() % 10400 - 200;
+            const int high = low + rand() % 100;
+
+            std::vector<interval_t> brute;
+            for (std::set<interval_t>::const_iterator it = expected.begin(); it != expected.end(); ++it) {
+                if (!(high < it->first || it->second < low)) brute.push_back(*it);
+            }
+
+            std::vector<interval_t> found;
+            rb_for_each_overlap(tree, low, high, [&found](const interval_tree_t::value_type& _element) { found.push_back(_element.first); });
+            ASSERT_EQ(brute, found);
+
+            interval_tree_t::iterator any = rb_find_overlap(tree, low, high);
+            ASSERT_EQ(brute.empty(), any == interval_tree_t::iterator());
+            if (!brute.empty()) {
+                ASSERT_FALSE(high < any->first.first || any->first.second < low);
+            }
+        }
+    }
+
+}} // namespace
@@ -0,0 +1,131 @@
+#include "test_containers.h"
+#include "containers/StaticSearchTree.h"
+#include "containers/RbTree.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+
+namespace glare { namespace
+{
+    enum    fake_sst_type { fake_sst_val0, fake_sst_val1 };
+    typedef TestObject<fake_sst_type, TestObjectInfoType>       TestObjectType;
+
+    typedef StaticSearchTree<int, int>                          sst_t;
+    typedef StaticSearchTree<int, TestObjectType>               sst_object_t;
+    typedef GLARE_PAIR<int, int>                                sst_pair;
+
+    TestObjectType::state_type::state_object_type& refStateInfo = TestObjectType::getState().getStateInfo();
+
+    void makePairs(std::vector<sst_pair>& _pairs, int _count)
+    {
+        _pairs.clear();
+        for (int i = 0; i < _count; ++i) {
+            _pairs.push_back(sst_pair(i * 3 + 1, i * 10));
+        }
+    }
+
+    TEST(StaticSearchTree_Test, test_default_construction)
+    {
+        sst_t tree;
+        EXPECT_TRUE(tree.empty());
+        EXPECT_EQ(0, tree.size());
+        EXPECT_EQ(nullptr, tree.find(1));
+        EXPECT_FALSE(tree.exists(1));
+    }
+
+    TEST(StaticSearchTree_Test, test_find_every_size)
+    {
+        // Every size up to a few perfect trees, so the padding is exercised at every height.
+        std::vector<sst_pair> pairs;
+        for (int count = 0; count <= 300; ++count)
+        {
+            makePairs(pairs, count);
+            sst_t tree(pairs.begin(), pairs.end());
+            ASSERT_EQ(static_cast<size_t>(count), tree.size());
+
+            for (int i = 0; i < count; ++i)
+            {
+                const int* value = tree.find(i * 3 + 1);
+                ASSERT_NE(nullptr, value) << "size " << count << " key " << i * 3 + 1;
+                EXPECT_EQ(i * 10, *value);
+
+                // Between and around the keys.
+                EXPECT_FALSE(tree.exists(i * 3));
+                EXPECT_FALSE(tree.exists(i * 3 + 2));
+            }
+            EXPECT_FALSE(tree.exists(count * 3 + 1));
+            EXPECT_FALSE(tree.exists(-5));
+        }
+    }
+
+    TEST(StaticSearchTree_Test, test_build_from_rbtree)
+    {
+        RedBlackTree<int, int> rbtree;
+        for (int i = 0; i < 1000; ++i) {
+            rbtree.insert((i * 7919) % 1000, i);
+        }
+
+        sst_t tree(rbtree.begin(), rbtree.end());
+        EXPECT_EQ(rbtree.size(), tree.size());
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            int expected = 0, value = -1;
+            EXPECT_TRUE(rbtree.find(i, expected));
+            EXPECT_TRUE(tree.find(i, value));
+            EXPECT_EQ(expected, value);
+        }
+        EXPECT_FALSE(tree.exists(1000));
+    }
+
+    TEST(StaticSearchTree_Test, test_copy_assignment_swap)
+    {
+        std::vector<sst_pair> pairs;
+        makePairs(pairs, 100);
+
+        sst_t tree(pairs.begin(), pairs.end());
+        sst_t copy(tree);
+        sst_t assigned;
+        assigned = tree;
+
+        tree.clear();
+        EXPECT_TRUE(tree.empty());
+        EXPECT_EQ(nullptr, tree.find(1));
+
+        for (int i = 0; i < 100; ++i)
+        {
+            EXPECT_TRUE(copy.exists(i * 3 + 1));
+            EXPECT_TRUE(assigned.exists(i * 3 + 1));
+        }
+
+        swap(tree, copy);
+        EXPECT_EQ(100, tree.size());
+        EXPECT_TRUE(copy.empty());
+        EXPECT_TRUE(tree.exists(298));
+
+        // Rebuilding replaces the content.
+        makePairs(pairs, 10);
+        tree.build(pairs.begin(), pairs.end());
+        EXPECT_EQ(10, tree.size());
+        EXPECT_FALSE(tree.exists(298));
+    }
+
+    TEST(StaticSearchTree_Test, test_memory_leaks)
+    {
+        TestObjectType::resetState();
+        {
+            std::vector<GLARE_PAIR<int, TestObjectType> > pairs;
+            for (int i = 0; i < 50; ++i) {
+                pairs.push_back(GLARE_PAIR<int, TestObjectType>(i, TestObjectType()));
+            }
+
+            sst_object_t tree(pairs.begin(), pairs.end());
+            sst_object_t copy(tree);
+            copy = tree;
+            EXPECT_NE(nullptr, copy.find(49));
+        }
+        EXPECT_EQ(refStateInfo.m_constructor_count + refStateInfo.m_copyConstructor_count, refStateInfo.m_destructor_count) << "Fatal Error, possible memory leak";
+    }
+
+}   // namespace
+}   // namespace glare